@@ -0,0 +1,122 @@
+// Bench - minimal benchmark harness
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <functional>
+#include <string>
+#include <vector>
+#include <sys/utsname.h>
+
+// Runs each operation in batches sized to ~20 us, collects ns/op per
+// batch for the configured time and reports mean/min/p50/p99/max. Results
+// are printed as they finish (stderr) and written once as JSON.
+
+// Keep a value (and everything that produced it) from being optimized out
+template <typename T>
+inline void benchKeep(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct BenchResult {
+    std::string name;
+    uint64_t iterations;
+    double meanNs;
+    double minNs;
+    double p50Ns;
+    double p99Ns;
+    double maxNs;
+    double itemsPerOp;          // > 0: also report items/s (e.g. bytes, records)
+};
+
+class BenchRunner {
+private:
+    double minSeconds_;
+    std::vector<BenchResult> results_;
+
+    static int64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static double percentile(const std::vector<double>& sorted, double quantile) {
+        size_t index = static_cast<size_t>(quantile * (sorted.size() - 1) + 0.5);
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+
+public:
+    explicit BenchRunner(double minSeconds = 0.5) : minSeconds_(minSeconds) {}
+
+    void run(const std::string& name, const std::function<void()>& op,
+             double itemsPerOp = 0.0) {
+        // Warm up and size the batch
+        uint64_t batch = 1;
+        while (true) {
+            int64_t start = nowNs();
+            for (uint64_t i = 0; i < batch; i++) op();
+            if (nowNs() - start >= 20000 || batch >= (1u << 20)) break;
+            batch *= 2;
+        }
+
+        std::vector<double> samples;
+        uint64_t iterations = 0;
+        int64_t deadline = nowNs() + static_cast<int64_t>(minSeconds_ * 1e9);
+        while (nowNs() < deadline || samples.size() < 10) {
+            int64_t start = nowNs();
+            for (uint64_t i = 0; i < batch; i++) op();
+            samples.push_back(static_cast<double>(nowNs() - start) / batch);
+            iterations += batch;
+        }
+
+        double sum = 0.0;
+        for (double sample : samples) sum += sample;
+        std::sort(samples.begin(), samples.end());
+
+        BenchResult result{name, iterations, sum / samples.size(), samples.front(),
+                           percentile(samples, 0.50), percentile(samples, 0.99),
+                           samples.back(), itemsPerOp};
+        results_.push_back(result);
+
+        std::fprintf(stderr, "%-48s %10.1f ns/op  p99 %10.1f ns", name.c_str(),
+                     result.meanNs, result.p99Ns);
+        if (itemsPerOp > 0.0) {
+            std::fprintf(stderr, "  %12.0f items/s", itemsPerOp * 1e9 / result.meanNs);
+        }
+        std::fprintf(stderr, "\n");
+    }
+
+    // {"context":{...},"benchmarks":[{"name":..,"iterations":..,"mean_ns":..,...}]}
+    void writeJson(FILE* out) const {
+        char date[32];
+        time_t now = time(nullptr);
+        strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+        struct utsname host {};
+        uname(&host);
+
+        std::fprintf(out, "{\n  \"context\": {\"date\": \"%s\", \"host\": \"%s\", "
+                          "\"machine\": \"%s\", \"compiler\": \"%s\"},\n",
+                     date, host.nodename, host.machine, __VERSION__);
+        std::fprintf(out, "  \"benchmarks\": [\n");
+        for (size_t i = 0; i < results_.size(); i++) {
+            const BenchResult& r = results_[i];
+            std::fprintf(out, "    {\"name\": \"%s\", \"iterations\": %llu, \"mean_ns\": %.2f, "
+                              "\"min_ns\": %.2f, \"p50_ns\": %.2f, \"p99_ns\": %.2f, "
+                              "\"max_ns\": %.2f",
+                         r.name.c_str(), static_cast<unsigned long long>(r.iterations),
+                         r.meanNs, r.minNs, r.p50Ns, r.p99Ns, r.maxNs);
+            if (r.itemsPerOp > 0.0) {
+                std::fprintf(out, ", \"items_per_second\": %.1f", r.itemsPerOp * 1e9 / r.meanNs);
+            }
+            std::fprintf(out, "}%s\n", i + 1 < results_.size() ? "," : "");
+        }
+        std::fprintf(out, "  ]\n}\n");
+    }
+
+    const std::vector<BenchResult>& getResults() const { return results_; }
+};
+
+#endif // BENCH_HPP
@@ -0,0 +1,216 @@
+// core_bench - Microbenchmarks for the core headers
+//
+// Build: g++ -std=c++20 -O2 -Iinclude -Ibench bench/core_bench.cpp -o core_bench -lpthread
+// Usage: core_bench [output.json] [seconds per benchmark]
+//        (JSON goes to stdout when no output file is given; progress to stderr)
+//
+// Scratch files (logs, telemetry segments) are written to a temporary
+// directory that is removed afterwards. Compare runs between builds with
+// the same binary flags and CPU governor.
+#include "bench.hpp"
+#include "controlSystem.hpp"
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+
+// Communication interface with no hardware behind it: accepts every
+// frame, never receives
+class NullInterface : public ICommunicationInterface {
+private:
+    std::string name_;
+    uint64_t bytesSent_;
+
+public:
+    explicit NullInterface(const std::string& name) : name_(name), bytesSent_(0) {}
+
+    bool initialize() override { return true; }
+    bool update() override { return true; }
+    bool shutdown() override { return true; }
+    bool send(std::span<const uint8_t> data) override {
+        bytesSent_ += data.size();
+        return true;
+    }
+    size_t receiveInto(std::span<uint8_t>) override { return 0; }
+    bool isConnected() const override { return true; }
+    std::string getStatus() const override {
+        return name_ + ": " + std::to_string(bytesSent_) + " bytes";
+    }
+    std::string getComponentName() const override { return name_; }
+};
+
+static void benchSensors(BenchRunner& runner) {
+    PressureSensor pressure("DepthSensor");
+    pressure.initialize();
+    for (int i = 0; i < 10; i++) pressure.update();
+
+    runner.run("PressureSensor/readValue", [&]() { benchKeep(pressure.readValue()); });
+    runner.run("PressureSensor/update+readValue", [&]() {
+        pressure.update();
+        benchKeep(pressure.readValue());
+    });
+}
+
+static void benchSafety(BenchRunner& runner) {
+    for (size_t limits : {1, 8, 32, 64}) {
+        SafetyMonitor monitor;
+        SystemSnapshot snapshot{};
+        snapshot.sensorCount = SNAPSHOT_MAX_SENSORS;
+        for (size_t i = 0; i < SNAPSHOT_MAX_SENSORS; i++) {
+            snapshot.sensorValues[i] = 10.0;
+            snapshot.sensorHealthy[i] = 1;
+        }
+        for (size_t i = 0; i < limits; i++) {
+            monitor.addLimit("Limit" + std::to_string(i), i % SNAPSHOT_MAX_SENSORS, 0.0, 100.0);
+        }
+        monitor.initialize();
+
+        runner.run("SafetyMonitor/evaluate/limits:" + std::to_string(limits), [&]() {
+            monitor.evaluate(snapshot);
+            benchKeep(monitor.getViolationMask());
+        }, static_cast<double>(limits));
+    }
+}
+
+static void benchLogger(BenchRunner& runner) {
+    const std::string message = "Safety limit MaxDepth violated: value 104.2 (limits 0 - 100)";
+
+    {
+        DataLogger logger("bench_sync.log", LogMode::SYNCHRONOUS);
+        logger.initialize();
+        runner.run("DataLogger/log/sync", [&]() { logger.log(message); }, 1.0);
+        logger.shutdown();
+    }
+    {
+        // BLOCK so the number is sustained writer throughput, not drops
+        DataLogger logger("bench_async.log", LogMode::ASYNCHRONOUS, OverflowPolicy::BLOCK);
+        logger.initialize();
+        runner.run("DataLogger/log/async", [&]() { logger.log(message); }, 1.0);
+        logger.shutdown();
+    }
+}
+
+static void benchTelemetry(BenchRunner& runner) {
+    for (size_t sensors : {3, 16, 32}) {
+        size_t actuators = sensors;
+        size_t ecus = 7;
+        std::vector<double> values(sensors, 12.5), commands(actuators, 40.0),
+                            feedback(actuators, 39.5);
+        std::vector<uint8_t> healthy(sensors, 1), status(ecus, 2);
+        TelemetryInput input{123456, 0, values.data(), healthy.data(), sensors,
+                             commands.data(), feedback.data(), actuators,
+                             status.data(), ecus};
+        TelemetryEncoder encoder;
+        double frameBytes = static_cast<double>(encoder.encode(input).size());
+
+        runner.run("TelemetryEncoder/encode/channels:" + std::to_string(sensors), [&]() {
+            benchKeep(encoder.encode(input).data());
+        }, frameBytes);
+
+        // Steady state: every frame a delta with nothing to send
+        TelemetryDeltaEncoder delta;
+        delta.encode(input);
+        runner.run("TelemetryDeltaEncoder/encode/channels:" + std::to_string(sensors), [&]() {
+            benchKeep(delta.encode(input).data());
+        }, static_cast<double>(delta.encode(input).size()));
+    }
+}
+
+static void benchECUManager(BenchRunner& runner) {
+    for (size_t count : {7, 16, 32, 64}) {
+        ECUManager manager("Bench", nullptr);
+        for (size_t i = 0; i < count; i++) {
+            char id[24];
+            snprintf(id, sizeof(id), "ECU%02zu", i + 1);
+            auto ecu = std::make_shared<ECU>(id, std::string("Node ") + id, ECUType::SENSOR_NODE);
+            ecu->setCommunication(CommunicationInfo{"Serial", "/dev/null", 115200, 0, 10.0});
+            manager.addECU(ecu);
+        }
+        manager.initialize();
+
+        std::string suffix = "/ecus:" + std::to_string(count);
+        runner.run("ECUManager/update" + suffix, [&]() { benchKeep(manager.update()); },
+                   static_cast<double>(count));
+        runner.run("ECUManager/getStatus" + suffix, [&]() {
+            benchKeep(manager.getStatus().size());
+        });
+    }
+}
+
+// Full control cycle: the same component set as src/main.cpp, with the
+// serial/uplink interfaces replaced by NullInterface and no Modbus drives
+static void benchControlCycle(BenchRunner& runner) {
+    std::ostringstream quiet;
+    std::streambuf* console = std::cout.rdbuf(quiet.rdbuf());
+
+    TM_ControlSystem system;
+    system.setLoopRate(1000.0);
+
+    auto depth = std::make_shared<PressureSensor>("DepthSensor");
+    auto temperature = std::make_shared<TemperatureSensor>("WaterTemp");
+    auto imu = std::make_shared<IMUSensor>("IMU");
+    system.addSensor(depth, 100.0);
+    system.addSensor(temperature, 1.0);
+    system.addSensor(imu, 100.0);
+
+    system.addActuator(std::make_shared<ThrusterMotor>("VerticalThruster1"));
+    system.addActuator(std::make_shared<ThrusterMotor>("HorizontalThruster1"));
+    system.addActuator(std::make_shared<HydraulicValve>("GripperValve"));
+
+    system.addCommunication(std::make_shared<NullInterface>("TeensySensors"));
+    system.addCommunication(std::make_shared<NullInterface>("TeensyActuators"));
+    system.addCommunication(std::make_shared<NullInterface>("Uplink"), 20.0, true);
+
+    system.addControlLoop({CONTROL_LOOP_DEPTH, "DepthSensor", -1, "VerticalThruster1",
+                           {2.0, 0.5, 0.2, -100.0, 100.0, 200.0, 10.0}, 100.0, false});
+    system.addControlLoop({CONTROL_LOOP_HEADING, "IMU", IMUSensor::YAW, "HorizontalThruster1",
+                           {1.5, 0.1, 0.3, -100.0, 100.0, 400.0, 10.0}, 100.0, true});
+    system.addSafetyLimit("MaxDepth", depth, 0.0, 100.0);
+    system.addSafetyLimit("MaxTemp", temperature, -5.0, 50.0);
+
+    bool ready = system.initialize();
+    std::cout.rdbuf(console);
+    if (!ready) {
+        std::fprintf(stderr, "TM_ControlSystem failed to initialize, skipping cycle benchmark\n");
+        return;
+    }
+    system.setAutoDepth(true, 10.0);
+
+    runner.run("TM_ControlSystem/runCycle", [&]() { system.runCycle(); });
+
+    std::cout.rdbuf(quiet.rdbuf());
+    system.stop();
+    std::cout.rdbuf(console);
+}
+
+int main(int argc, char** argv) {
+    FILE* out = stdout;
+    if (argc >= 2) {
+        out = std::fopen(argv[1], "w");
+        if (!out) {
+            std::fprintf(stderr, "Failed to open output file: %s\n", argv[1]);
+            return 1;
+        }
+    }
+    double seconds = argc >= 3 ? std::atof(argv[2]) : 0.5;
+
+    namespace fs = std::filesystem;
+    fs::path original = fs::current_path();
+    fs::path scratch = fs::temp_directory_path() / ("core_bench_" + std::to_string(getpid()));
+    fs::create_directories(scratch / "ecu_reports");
+    fs::current_path(scratch);
+
+    BenchRunner runner(seconds);
+    benchSensors(runner);
+    benchSafety(runner);
+    benchLogger(runner);
+    benchTelemetry(runner);
+    benchECUManager(runner);
+    benchControlCycle(runner);
+
+    fs::current_path(original);
+    fs::remove_all(scratch);
+
+    runner.writeJson(out);
+    if (out != stdout) std::fclose(out);
+    return 0;
+}
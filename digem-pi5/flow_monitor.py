@@ -15,6 +15,10 @@ Calibration: F = 7.5 * Q (L/min) → 450 pulses/liter
 Sensor status: considered ACTIVE if at least one pulse has been
   received in the last 2 seconds.
 
+While the control system is running it owns GPIO 17 (FlowSensor in
+include/sensors.hpp); the readings are then taken from its state bus
+(state_bus.py) and the GPIO callback is only used when it is not.
+
 Run: WAYLAND_DISPLAY=wayland-0 XDG_RUNTIME_DIR=/run/user/1000
      QT_QPA_PLATFORM=wayland python3 flow_monitor.py
 """
@@ -23,6 +27,7 @@ import sys
 import time
 import threading
 import RPi.GPIO as GPIO
+from state_bus import StateBus
 from PyQt5.QtWidgets import (QApplication, QWidget, QVBoxLayout, QHBoxLayout,
                               QLabel, QFrame, QPushButton)
 from PyQt5.QtCore import QTimer, Qt
@@ -58,6 +63,38 @@ def _flow_calc_loop():
             _total_liters  += _pulses_this_sec / PULSES_PER_LITER
             _pulses_this_sec = 0
 
+BUS_SENSOR = "SlurryFlow"   # FlowSensor name in the control system
+
+def _bus_loop(bus):
+    """Mirrors the control system's flow sensor; falls back to GPIO when it stops."""
+    global _flow_rate, _total_liters, _last_pulse_time
+    last_total = None
+    while not bus.writer_restarted():
+        frame  = bus.read()
+        sensor = frame.sensor(BUS_SENSOR) if frame is not None else None
+        if sensor is not None and len(sensor["vector"]) >= 2:
+            flow, total = sensor["vector"][:2]
+            with _lock:
+                _flow_rate = flow
+                if last_total is not None:
+                    _total_liters += max(0.0, total - last_total)
+                if flow > 0.0:
+                    _last_pulse_time = time.time()
+            last_total = total
+        time.sleep(0.1)
+    bus.close()
+    init_gpio()
+
+def init_sensor():
+    bus = StateBus()
+    if bus.open():
+        frame = bus.read()
+        if frame is not None and frame.sensor(BUS_SENSOR) is not None:
+            threading.Thread(target=_bus_loop, args=(bus,), daemon=True).start()
+            return
+        bus.close()
+    init_gpio()
+
 def init_gpio():
     GPIO.setmode(GPIO.BCM)
     GPIO.setup(GPIO_PIN, GPIO.IN, pull_up_down=GPIO.PUD_UP)
@@ -323,7 +360,7 @@ class FlowMonitor(QWidget):
 
 
 def main():
-    init_gpio()
+    init_sensor()
     app = QApplication(sys.argv)
     w = FlowMonitor()
     w.show()
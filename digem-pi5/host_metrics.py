@@ -0,0 +1,32 @@
+#!/usr/bin/env python3
+#
+# Reader for the host metrics published by the control system
+# (include/host_metrics.hpp). The ECU01 health poller rewrites the file
+# once a second; a sample older than MAX_AGE_S means the control system
+# is not running and callers should fall back to their own source.
+#
+import time
+
+PUBLISH_PATH = "/dev/shm/tbm_host_metrics"
+MAX_AGE_S = 5
+
+
+def read_host_metrics(path=PUBLISH_PATH, max_age_s=MAX_AGE_S):
+    """Return {'cpu_percent', 'mem_percent', 'temp_c'} (temp_c is None if the
+    host has no thermal zone), or None if the file is missing or stale."""
+    try:
+        with open(path) as f:
+            fields = dict(line.strip().split("=", 1) for line in f if "=" in line)
+        if time.time() - int(fields["unix_time"]) > max_age_s:
+            return None
+        return {
+            "cpu_percent": float(fields["cpu_percent"]),
+            "mem_percent": float(fields["mem_percent"]),
+            "temp_c": float(fields["temp_c"]) if fields.get("has_temp") == "1" else None,
+        }
+    except (OSError, KeyError, ValueError):
+        return None
+
+
+if __name__ == "__main__":
+    print(read_host_metrics())
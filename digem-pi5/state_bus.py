@@ -0,0 +1,208 @@
+#!/usr/bin/env python3
+#
+# Reader for the control system's shared-memory state bus
+# (include/state_bus.hpp). The C++ side publishes the frozen cycle
+# snapshot and ECU health at ~100 Hz; dashboards read it here instead of
+# touching GPIO, I2C or Modbus themselves.
+#
+# Reading never blocks the control loop: the frame is copied out and the
+# seqlock sequence is checked before and after, retrying on a torn copy.
+#
+# Usage:
+#   bus = StateBus()
+#   if bus.open():
+#       frame = bus.read()
+#       imu = frame.sensor("IMU")      # {'value', 'healthy', 'vector', ...}
+#
+# Run directly to print the live state: python3 state_bus.py
+#
+import mmap
+import os
+import struct
+import time
+
+PATH = "/dev/shm/tbm_state_bus"
+MAGIC = 0x534D4254
+VERSION = 1
+
+MAX_SENSORS = 32
+MAX_ACTUATORS = 32
+MAX_VECTOR = 64
+MAX_ECUS = 16
+
+HEADER = struct.Struct("<IHHIIIIIIIIiIdQ")
+SENSOR_ENTRY = struct.Struct("<24s8s")
+ACTUATOR_ENTRY = struct.Struct("<32s")
+ECU_ENTRY = struct.Struct("<8s24s")
+FRAME = struct.Struct("<QqIIII"
+                      f"{MAX_SENSORS}d{MAX_SENSORS}q{MAX_SENSORS}B{MAX_SENSORS}B{MAX_SENSORS}H"
+                      f"{MAX_VECTOR}d{MAX_ACTUATORS}d{MAX_ACTUATORS}d"
+                      f"{MAX_ECUS}B{MAX_ECUS}I{MAX_ECUS}f{MAX_ECUS}f{MAX_ECUS}f{MAX_ECUS}q")
+SEQUENCE_OFFSET = 12
+assert HEADER.size == 64 and FRAME.size == 2096
+
+# TELEMETRY_FLAG_* (include/telemetry.hpp)
+FLAG_SAFETY_FAULT = 0x01
+FLAG_AUTO_DEPTH = 0x02
+FLAG_AUTO_HEADING = 0x04
+FLAG_ECUS_DEGRADED = 0x08
+
+ECU_STATUS = ["OFFLINE", "INITIALIZING", "ONLINE", "FAULT", "DEGRADED"]
+
+
+def _text(raw):
+    return raw.split(b"\0", 1)[0].decode("utf-8", "replace")
+
+
+class Frame:
+    """One published cycle. Sensors/actuators/ECUs are lists of dicts."""
+
+    def __init__(self, values, sensor_names, actuator_names, ecu_names):
+        m = MAX_SENSORS
+        a = MAX_ACTUATORS
+        e = MAX_ECUS
+        self.cycle, self.timestamp_ns, self.flags = values[0], values[1], values[2]
+        sensor_count, actuator_count, ecu_count = values[3], values[4], values[5]
+        i = 6
+        sensor_values = values[i:i + m]; i += m
+        sample_ns = values[i:i + m]; i += m
+        healthy = values[i:i + m]; i += m
+        vector_count = values[i:i + m]; i += m
+        vector_offset = values[i:i + m]; i += m
+        vector_values = values[i:i + MAX_VECTOR]; i += MAX_VECTOR
+        commands = values[i:i + a]; i += a
+        feedback = values[i:i + a]; i += a
+        ecu_status = values[i:i + e]; i += e
+        ecu_errors = values[i:i + e]; i += e
+        ecu_cpu = values[i:i + e]; i += e
+        ecu_mem = values[i:i + e]; i += e
+        ecu_temp = values[i:i + e]; i += e
+        ecu_reply = values[i:i + e]
+
+        self.age_s = (time.monotonic_ns() - self.timestamp_ns) / 1e9
+        self.sensors = []
+        for s in range(min(sensor_count, m)):
+            start = vector_offset[s]
+            self.sensors.append({
+                "name": sensor_names[s][0], "units": sensor_names[s][1],
+                "value": sensor_values[s], "healthy": bool(healthy[s]),
+                "sample_ns": sample_ns[s],
+                "vector": list(vector_values[start:start + vector_count[s]]),
+            })
+        self.actuators = [{"name": actuator_names[k], "command": commands[k],
+                           "feedback": feedback[k]} for k in range(min(actuator_count, a))]
+        self.ecus = []
+        for k in range(min(ecu_count, e)):
+            status = ecu_status[k]
+            self.ecus.append({
+                "id": ecu_names[k][0], "name": ecu_names[k][1],
+                "status": ECU_STATUS[status] if status < len(ECU_STATUS) else "UNKNOWN",
+                "errors": ecu_errors[k], "cpu_percent": ecu_cpu[k],
+                "mem_percent": ecu_mem[k], "temp_c": ecu_temp[k],
+                "last_reply_ns": ecu_reply[k],
+            })
+
+    def sensor(self, name):
+        return next((s for s in self.sensors if s["name"] == name), None)
+
+    def actuator(self, name):
+        return next((a for a in self.actuators if a["name"] == name), None)
+
+    @property
+    def safety_fault(self):
+        return bool(self.flags & FLAG_SAFETY_FAULT)
+
+
+class StateBus:
+    def __init__(self, path=PATH):
+        self.path = path
+        self.mm = None
+        self.inode = None
+        self.frame_offset = 0
+        self.names = None
+
+    def open(self):
+        """Map the region read-only. Returns False if the control system
+        is not running (no region, or not initialised yet)."""
+        self.close()
+        try:
+            fd = os.open(self.path, os.O_RDONLY)
+        except OSError:
+            return False
+        try:
+            self.inode = os.fstat(fd).st_ino
+            self.mm = mmap.mmap(fd, 0, mmap.MAP_SHARED, mmap.PROT_READ)
+        except (OSError, ValueError):
+            self.mm = None
+            return False
+        finally:
+            os.close(fd)
+
+        header = HEADER.unpack_from(self.mm, 0)
+        magic, version, _, total_size = header[0], header[1], header[2], header[3]
+        if magic != MAGIC or version != VERSION or len(self.mm) < total_size:
+            self.close()
+            return False
+        self.frame_offset = header[10]
+        self.directory_offset = header[9]
+        self.publish_rate_hz = header[13]
+        return True
+
+    def close(self):
+        if self.mm is not None:
+            self.mm.close()
+        self.mm = None
+        self.names = None
+
+    def _read_names(self):
+        base = self.directory_offset
+        sensors = [tuple(_text(f) for f in SENSOR_ENTRY.unpack_from(self.mm, base + i * SENSOR_ENTRY.size))
+                   for i in range(MAX_SENSORS)]
+        base += MAX_SENSORS * SENSOR_ENTRY.size
+        actuators = [_text(ACTUATOR_ENTRY.unpack_from(self.mm, base + i * ACTUATOR_ENTRY.size)[0])
+                     for i in range(MAX_ACTUATORS)]
+        base += MAX_ACTUATORS * ACTUATOR_ENTRY.size
+        ecus = [tuple(_text(f) for f in ECU_ENTRY.unpack_from(self.mm, base + i * ECU_ENTRY.size))
+                for i in range(MAX_ECUS)]
+        self.names = (sensors, actuators, ecus)
+
+    def writer_restarted(self):
+        """True if the region was removed or recreated since open()."""
+        try:
+            return os.stat(self.path).st_ino != self.inode
+        except OSError:
+            return True
+
+    def read(self, retries=100):
+        """Latest frame, or None if nothing has been published yet."""
+        if self.mm is None:
+            return None
+        for _ in range(retries):
+            before = struct.unpack_from("<I", self.mm, SEQUENCE_OFFSET)[0]
+            if before == 0:
+                return None
+            if before & 1:
+                continue
+            raw = self.mm[self.frame_offset:self.frame_offset + FRAME.size]
+            after = struct.unpack_from("<I", self.mm, SEQUENCE_OFFSET)[0]
+            if before == after:
+                if self.names is None:
+                    self._read_names()
+                return Frame(FRAME.unpack(raw), *self.names)
+        return None
+
+
+if __name__ == "__main__":
+    bus = StateBus()
+    while not bus.open():
+        print("Waiting for the control system state bus...")
+        time.sleep(1)
+    while True:
+        if bus.writer_restarted():
+            bus.open()
+        frame = bus.read()
+        if frame is not None:
+            parts = [f"{s['name']}={s['value']:.2f}{s['units']}" for s in frame.sensors]
+            print(f"cycle {frame.cycle:>8}  age {frame.age_s * 1000:6.1f} ms  " + "  ".join(parts),
+                  end="\r")
+        time.sleep(0.1)
@@ -10,7 +10,8 @@
 #   - Pi 5 ethernet interface may be "eth0" or "end0" depending on OS version
 #
 # Data available from hardware:
-#   - CPU temperature: via `vcgencmd measure_temp` (Pi-specific command)
+#   - CPU temperature: from the control system's published host metrics
+#     (host_metrics.py), or `vcgencmd measure_temp` when it is not running
 #   - Battery cell voltage: MAX17040 register 0x02 (VCELL), returns float in volts
 #   - Battery state of charge: MAX17040 register 0x04 (SOC), returns float 0-100%
 #   - Power source detection: voltage > 4.15V means outlet power (charging),
@@ -37,6 +38,7 @@ import struct
 import subprocess
 import socket
 import smbus2
+from host_metrics import read_host_metrics
 from PyQt5.QtWidgets import (QApplication, QLabel, QVBoxLayout, QWidget,
                              QHBoxLayout, QFrame, QGridLayout)
 from PyQt5.QtCore import QTimer, Qt
@@ -231,8 +233,12 @@ class SystemMonitor(QWidget):
         self.ip_val.setText("No Ethernet")
 
     def get_temp(self):
-        """Read CPU temperature using vcgencmd (Raspberry Pi specific).
+        """Read CPU temperature, preferring the control system's published
+        host metrics and falling back to vcgencmd (Raspberry Pi specific).
         Returns temperature as a string like '52.1' (degrees Celsius), or None."""
+        metrics = read_host_metrics()
+        if metrics and metrics["temp_c"] is not None:
+            return f"{metrics['temp_c']:.1f}"
         try:
             result = subprocess.run(["vcgencmd", "measure_temp"],
                                     capture_output=True, text=True)
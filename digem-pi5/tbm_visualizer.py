@@ -5,6 +5,8 @@ Dig 'Em Aggies – Not-a-Boring Competition 2026
 
 Hardware: BNO085 IMU on I2C bus 1 (0x4A), Raspberry Pi 5
 Renders a 3D cylinder whose orientation matches the physical sensor in real time.
+When the control system is running, the IMU is read from its state bus
+(state_bus.py) instead of the I2C bus.
 
 Uses pygame GLES 3.1 context + custom GLSL ES 3.00 shaders (required for Pi 5
 VideoCore VII GPU which only supports OpenGL ES natively, not desktop OpenGL).
@@ -19,9 +21,7 @@ import pygame
 from pygame.locals import OPENGL, DOUBLEBUF, QUIT, KEYDOWN, K_ESCAPE
 from OpenGL.GL import *
 
-import board, busio
-from adafruit_bno08x import BNO_REPORT_ROTATION_VECTOR
-from adafruit_bno08x.i2c import BNO08X_I2C
+from state_bus import StateBus
 
 os.environ.setdefault('SDL_VIDEODRIVER', 'wayland')
 
@@ -30,9 +30,37 @@ _lock   = threading.Lock()
 _quat   = (1.0, 0.0, 0.0, 0.0)   # (w, x, y, z)
 _angles = (0.0, 0.0, 0.0)         # (roll, pitch, yaw) degrees
 
+BUS_IMU   = "IMU"     # Sensor name in the control system
+BUS_STALE = 0.5       # Seconds without a new frame before falling back to I2C
+
+def _bus_loop():
+    """Follow the control system's IMU. Returns when the bus is unavailable or stale."""
+    global _quat, _angles
+    bus = StateBus()
+    if not bus.open():
+        return
+    print("[sensor] Using control system state bus")
+    while not bus.writer_restarted():
+        frame = bus.read()
+        if frame is None or frame.age_s > BUS_STALE:
+            break
+        imu = frame.sensor(BUS_IMU)
+        if imu is not None and imu["healthy"] and len(imu["vector"]) >= 7:
+            roll, pitch, yaw, w, x, y, z = imu["vector"][:7]
+            with _lock:
+                _quat   = (w, x, y, z)
+                _angles = (roll, pitch, yaw)
+        time.sleep(1 / 60)
+    bus.close()
+    print("[sensor] State bus stale, reading the IMU directly")
+
 def _sensor_loop():
     global _quat, _angles
+    _bus_loop()
     try:
+        import board, busio
+        from adafruit_bno08x import BNO_REPORT_ROTATION_VECTOR
+        from adafruit_bno08x.i2c import BNO08X_I2C
         i2c = busio.I2C(board.SCL, board.SDA, frequency=400000)
         bno = BNO08X_I2C(i2c)
         bno.enable_feature(BNO_REPORT_ROTATION_VECTOR)
@@ -1,8 +1,13 @@
 #!/usr/bin/env python3
 import subprocess
 import time
+from host_metrics import read_host_metrics
 
 def get_temp():
+    # Published by the control system when it is running
+    metrics = read_host_metrics()
+    if metrics and metrics["temp_c"] is not None:
+        return metrics["temp_c"]
     result = subprocess.run(["vcgencmd", "measure_temp"], capture_output=True, text=True)
     return float(result.stdout.strip().replace("temp=", "").replace("'C", ""))
 
@@ -0,0 +1,127 @@
+// ActuatorOutput
+#ifndef ACTUATOR_OUTPUT_HPP
+#define ACTUATOR_OUTPUT_HPP
+
+#include "base.hpp"
+#include "teensy_protocol.hpp"
+#include <algorithm>
+#include <cmath>
+
+// An actuator driven by a channel on an actuator node (set before
+// initialize(); the device name is the ECU's ControlledDevice entry,
+// whose channelNumber is the frame slot)
+struct ActuatorOutputConfig {
+    std::string actuator;
+    std::string ecuId;
+    std::string device;
+};
+
+// Gathers the commands of every actuator on a node into one
+// ACTUATOR_FRAME and hands it to the node's interface with a single
+// send(). A frame goes out only when a channel value changed, or after
+// KEEPALIVE_NS so the node's failsafe timer does not trip while the
+// commands are steady. A failed send is retried on the next flush.
+class ActuatorOutputStage {
+private:
+    static constexpr int64_t KEEPALIVE_NS = 100000000LL;   // 5x inside the node timeout
+
+    struct Binding {
+        uint8_t channel;
+        std::shared_ptr<IActuator> actuator;
+    };
+
+    struct Node {
+        std::string name;
+        std::shared_ptr<ICommunicationInterface> comm;
+        std::vector<Binding> bindings;
+        ActuatorFrame sent;         // Last frame the interface accepted
+        int64_t sentNs;             // 0 = nothing sent yet
+        uint8_t sequence;
+    };
+
+    std::vector<Node> nodes_;
+    uint64_t framesSent_;
+    uint64_t framesSuppressed_;
+    uint64_t sendFailures_;
+
+public:
+    ActuatorOutputStage() : framesSent_(0), framesSuppressed_(0), sendFailures_(0) {}
+
+    // Returns the node index (an existing one if the name is known)
+    size_t addNode(const std::string& name, std::shared_ptr<ICommunicationInterface> comm) {
+        for (size_t i = 0; i < nodes_.size(); i++) {
+            if (nodes_[i].name == name) return i;
+        }
+        nodes_.push_back({name, std::move(comm), {}, {}, 0, 0});
+        return nodes_.size() - 1;
+    }
+
+    // False if the channel is outside the frame or already bound
+    bool bind(size_t node, int channel, std::shared_ptr<IActuator> actuator) {
+        if (node >= nodes_.size() || channel < 0 ||
+            channel >= static_cast<int>(ACTUATOR_FRAME_CHANNELS)) {
+            return false;
+        }
+        auto& bindings = nodes_[node].bindings;
+        for (const auto& binding : bindings) {
+            if (binding.channel == channel) return false;
+        }
+        bindings.push_back({static_cast<uint8_t>(channel), std::move(actuator)});
+        return true;
+    }
+
+    // Once per cycle, after the actuators have applied interlocks
+    void flush(int64_t nowNs) {
+        for (auto& node : nodes_) {
+            if (node.bindings.empty()) continue;
+
+            ActuatorFrame frame{};
+            for (const auto& binding : node.bindings) {
+                long raw = std::lround(binding.actuator->getCommand() * ACTUATOR_COMMAND_SCALE);
+                frame.values[binding.channel] = static_cast<int16_t>(std::clamp(raw, -10000L, 10000L));
+                frame.mask |= static_cast<uint8_t>(1u << binding.channel);
+            }
+
+            bool changed = node.sentNs == 0 || frame.mask != node.sent.mask ||
+                           !std::equal(frame.values, frame.values + ACTUATOR_FRAME_CHANNELS,
+                                       node.sent.values);
+            if (!changed && nowNs - node.sentNs < KEEPALIVE_NS) {
+                framesSuppressed_++;
+                continue;
+            }
+
+            frame.sequence = node.sequence;
+            uint8_t packet[ACTUATOR_FRAME_PACKET_SIZE];
+            size_t length = encodeActuatorFrame(frame, packet);
+            if (!node.comm->send(std::span<const uint8_t>(packet, length))) {
+                sendFailures_++;
+                continue;
+            }
+            node.sent = frame;
+            node.sentNs = nowNs;
+            node.sequence++;
+            framesSent_++;
+        }
+    }
+
+    size_t getNodeCount() const { return nodes_.size(); }
+
+    size_t getBindingCount() const {
+        size_t count = 0;
+        for (const auto& node : nodes_) count += node.bindings.size();
+        return count;
+    }
+
+    uint64_t getFramesSent() const { return framesSent_; }
+    uint64_t getFramesSuppressed() const { return framesSuppressed_; }
+    uint64_t getSendFailures() const { return sendFailures_; }
+
+    std::string getStatus() const {
+        return "Actuator output: " + std::to_string(getBindingCount()) + " channels on " +
+               std::to_string(nodes_.size()) + " nodes, " + std::to_string(framesSent_) +
+               " frames sent, " + std::to_string(framesSuppressed_) + " suppressed, " +
+               std::to_string(sendFailures_) + " send failures";
+    }
+};
+
+#endif // ACTUATOR_OUTPUT_HPP
@@ -3,6 +3,8 @@
 #define ACTUATORS_HPP
 
 #include "base.hpp"
+#include "modbus.hpp"
+#include "status_format.hpp"
 #include <algorithm>
 #include <cmath>
 
@@ -57,9 +59,12 @@ public:
     
     void setInterlock(bool active) { interlockActive_ = active; }
     
-    std::string getStatus() const override {
-        return name_ + ": Cmd = " + std::to_string(commandValue_) + 
-               " FB = " + std::to_string(feedbackValue_);
+    std::string getStatus() const override { return statusText(*this); }
+
+    size_t formatStatus(char* buffer, size_t size) const override {
+        StatusWriter out(buffer, size);
+        out.text(name_).text(": Cmd = ").fixed(commandValue_).text(" FB = ").fixed(feedbackValue_);
+        return out.length();
     }
     
     std::string getComponentName() const override { return name_; }
@@ -71,6 +76,84 @@ public:
         : MotorController(name, -100.0, 100.0) {} // -100% to +100%
 };
 
+// Register map for a Modbus VFD (values depend on the drive model)
+struct VFDRegisterMap {
+    uint8_t unitId;
+    uint16_t commandRegister;         // Holding register, frequency setpoint
+    uint16_t feedbackRegister;        // Output frequency
+    ModbusFunction feedbackFunction;  // FC03 or FC04 depending on the drive
+    double commandScale;              // Register counts per Hz
+    double feedbackScale;             // Register counts per Hz
+};
+
+// Variable frequency drive on the Modbus bus. Commands are queued to the
+// engine only when the register value changes; feedback comes from the
+// engine's register cache, so update() never waits on the bus.
+class VFDDrive : public MotorController {
+private:
+    static constexpr int64_t STALE_FEEDBACK_NS = 2000000000LL;
+
+    std::shared_ptr<ModbusEngine> engine_;
+    VFDRegisterMap map_;
+    ModbusRegisterRef feedbackRef_;
+    int32_t lastWritten_;
+    bool feedbackStale_;
+
+public:
+    VFDDrive(const std::string& name, std::shared_ptr<ModbusEngine> engine,
+             const VFDRegisterMap& map, double maxHz = 60.0)
+        : MotorController(name, 0.0, maxHz), engine_(std::move(engine)), map_(map),
+          lastWritten_(-1), feedbackStale_(true) {
+        // Poll registration must happen before the engine starts
+        engine_->addPoll(map_.unitId, map_.feedbackFunction, map_.feedbackRegister);
+    }
+
+    bool initialize() override {
+        feedbackRef_ = engine_->findRegister(map_.unitId, map_.feedbackFunction,
+                                             map_.feedbackRegister);
+        lastWritten_ = -1;
+        return feedbackRef_.valid() && MotorController::initialize();
+    }
+
+    bool update() override {
+        bool ok = MotorController::update();
+
+        // Interlock or disable leaves commandValue_ at zero, which is written too
+        int32_t raw = static_cast<int32_t>(std::lround(commandValue_ * map_.commandScale));
+        raw = std::clamp<int32_t>(raw, 0, 0xFFFF);
+        if (raw != lastWritten_ &&
+            engine_->queueWrite(map_.unitId, map_.commandRegister, static_cast<uint16_t>(raw))) {
+            lastWritten_ = raw;
+        }
+
+        uint16_t value = 0;
+        int64_t updatedNs = 0;
+        if (engine_->readRegister(feedbackRef_, value, &updatedNs)) {
+            feedbackValue_ = value / map_.feedbackScale;
+            feedbackStale_ = monotonicNowNs() - updatedNs > STALE_FEEDBACK_NS;
+        } else {
+            feedbackStale_ = true;
+        }
+        return ok;
+    }
+
+    bool shutdown() override {
+        MotorController::shutdown();
+        engine_->queueWrite(map_.unitId, map_.commandRegister, 0);
+        return true;
+    }
+
+    bool isFeedbackStale() const { return feedbackStale_; }
+
+    size_t formatStatus(char* buffer, size_t size) const override {
+        if (size == 0) return 0;
+        size_t length = MotorController::formatStatus(buffer, size);
+        if (!feedbackStale_) return length;
+        StatusWriter out(buffer + length, size - length);
+        return length + out.text(" (stale)").length();
+    }
+};
+
 class HydraulicValve : public IActuator {
 private:
     std::string name_;
@@ -114,8 +197,11 @@ public:
     
     void setInterlock(bool active) { interlockActive_ = active; }
     
-    std::string getStatus() const override {
-        return name_ + ": Pos=" + std::to_string(position_) + "%";
+    std::string getStatus() const override { return statusText(*this); }
+
+    size_t formatStatus(char* buffer, size_t size) const override {
+        StatusWriter out(buffer, size);
+        return out.text(name_).text(": Pos=").fixed(position_).text("%").length();
     }
     
     std::string getComponentName() const override { return name_; }
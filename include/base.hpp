@@ -2,10 +2,25 @@
 #ifndef BASE_HPP
 #define BASE_HPP
 
+#include <algorithm>
 #include <string>
 #include <memory>
 #include <vector>
 #include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+// Largest single message any communication interface carries
+constexpr size_t MAX_FRAME_SIZE = 256;
+
+// Fixed-size message slot (interfaces preallocate these instead of
+// allocating a vector per message)
+struct CommFrame {
+    uint16_t length;
+    uint8_t data[MAX_FRAME_SIZE];
+    int64_t timestampNs;    // Monotonic receive time (0 = not stamped)
+};
 
 // Abstract base class for all system components
 class ISystemComponent {
@@ -16,6 +31,19 @@ public:
     virtual bool shutdown() = 0;
     virtual std::string getStatus() const = 0;
     virtual std::string getComponentName() const = 0;
+
+    // Status into a caller buffer, nul-terminated and truncated to fit;
+    // returns the characters written. Components whose status is logged
+    // from the loop override this to format without allocating
+    // (StatusWriter) and implement getStatus() as statusText(*this).
+    virtual size_t formatStatus(char* buffer, size_t size) const {
+        if (size == 0) return 0;
+        std::string status = getStatus();
+        size_t length = std::min(status.size(), size - 1);
+        std::memcpy(buffer, status.data(), length);
+        buffer[length] = '\0';
+        return length;
+    }
 };
 
 // Abstract base for all sensors
@@ -26,6 +54,27 @@ public:
     virtual bool calibrate() = 0;
     virtual bool isHealthy() const = 0;
     virtual std::string getUnits() const = 0;
+
+    // Multi-axis sensors report all channels in one call. Scalar sensors
+    // have one channel, the same value readValue() returns.
+    virtual size_t getChannelCount() const { return 1; }
+    virtual size_t readVector(std::span<double> out) {
+        if (out.empty()) return 0;
+        out[0] = readValue();
+        return 1;
+    }
+
+    // Monotonic time the current reading was taken, for sensors that
+    // timestamp their own samples (0 = taken by update())
+    virtual int64_t getSampleTimeNs() const { return 0; }
+
+    // update() on the control cycle's clock (monotonic, or the
+    // simulator's virtual clock), for sensors that age their samples
+    // against it
+    virtual bool updateAt(int64_t cycleNs) {
+        (void)cycleNs;
+        return update();
+    }
 };
 
 // Abstract base for all actuators
@@ -42,9 +91,35 @@ public:
 class ICommunicationInterface : public ISystemComponent {
 public:
     virtual ~ICommunicationInterface() = default;
-    virtual bool send(const std::vector<uint8_t>& data) = 0;
-    virtual std::vector<uint8_t> receive() = 0;
+    virtual bool send(std::span<const uint8_t> data) = 0;
+    // Copy the next received message into buffer; returns its length (0 = none)
+    virtual size_t receiveInto(std::span<uint8_t> buffer) = 0;
     virtual bool isConnected() const = 0;
+
+    // Monotonic time the message last returned by receiveInto() arrived,
+    // for interfaces that stamp on receive (0 = not stamped)
+    virtual int64_t getLastReceiveNs() const { return 0; }
+
+    // Receive the next message as a view, valid only during the handler call
+    template <typename Handler>
+    bool receive(Handler&& handler) {
+        uint8_t buffer[MAX_FRAME_SIZE];
+        size_t length = receiveInto(buffer);
+        if (length == 0) return false;
+        handler(std::span<const uint8_t>(buffer, length));
+        return true;
+    }
+
+    // Adapters for the original vector-based API
+    bool send(const std::vector<uint8_t>& data) {
+        return send(std::span<const uint8_t>(data));
+    }
+
+    std::vector<uint8_t> receive() {
+        uint8_t buffer[MAX_FRAME_SIZE];
+        size_t length = receiveInto(buffer);
+        return std::vector<uint8_t>(buffer, buffer + length);
+    }
 };
 
 #endif
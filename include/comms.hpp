@@ -3,102 +3,369 @@
 #define COMMUNICATION_HPP
 
 #include "base.hpp"
-#include <queue>
-#include <mutex>
+#include "spsc_queue.hpp"
+#include "framing.hpp"
+#include "modbus.hpp"
+#include "serial_port.hpp"
+#include "teensy_protocol.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
 #include <thread>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 
 // Serial communication (Pi <-> Teensy)
+// Raw termios port with a dedicated I/O thread. The thread waits in
+// epoll on the port and a wakeup eventfd, decodes COBS/CRC frames into
+// rxQueue_, and writes frames queued by send(). Both queues are lock-free
+// SPSC rings: send()/receiveInto() must each be called from one thread
+// (the control thread), the other end is always the I/O thread. Frames
+// are stamped as each read() returns, and TIME_PINGs as they are written,
+// so clock sync sees the port's timing rather than the queues'. If the
+// device goes away (a Teensy re-enumerating on USB) the I/O thread closes
+// the port and reopens it with a backoff until it comes back.
 class SerialInterface : public ICommunicationInterface {
 private:
+    static constexpr size_t QUEUE_FRAMES = 32;
+    static constexpr size_t READ_CHUNK = 512;
+    static constexpr int64_t REOPEN_MIN_NS = 100000000LL;   // First retry after 100 ms
+    static constexpr int64_t REOPEN_MAX_NS = 2000000000LL;  // Backoff cap
+
     std::string portName_;
     int baudRate_;
-    bool connected_;
-    std::queue<std::vector<uint8_t>> txQueue_;
-    std::queue<std::vector<uint8_t>> rxQueue_;
-    std::mutex txMutex_;
-    std::mutex rxMutex_;
+    std::atomic<bool> connected_;
+
+    int fd_;
+    int epollFd_;
+    int wakeFd_;
+    std::thread ioThread_;
+    std::atomic<bool> ioRunning_;
+
+    // Preallocated frame slots (control thread <-> I/O thread)
+    SPSCQueue<CommFrame, QUEUE_FRAMES> txQueue_;
+    SPSCQueue<CommFrame, QUEUE_FRAMES> rxQueue_;
+
+    // I/O thread state
+    FrameDecoder decoder_;
+    uint8_t txEncoded_[cobsMaxEncodedSize(MAX_FRAME_SIZE)];
+    size_t txEncodedLength_;
+    size_t txEncodedOffset_;
+    bool waitingForWritable_;
+    int64_t reopenAtNs_;
+    int64_t reopenDelayNs_;
+
+    int64_t lastReceiveNs_;     // Consumer side: stamp of the last receiveInto()
+
+    // Statistics
+    std::atomic<uint64_t> rxFrames_;
+    std::atomic<uint64_t> txFrames_;
+    std::atomic<uint64_t> crcErrors_;
+    std::atomic<uint64_t> reconnects_;
 
 public:
     SerialInterface(const std::string& port, int baud)
-        : portName_(port), baudRate_(baud), connected_(false) {}
+        : portName_(port), baudRate_(baud), connected_(false),
+          fd_(-1), epollFd_(-1), wakeFd_(-1), ioRunning_(false),
+          txEncodedLength_(0), txEncodedOffset_(0), waitingForWritable_(false),
+          reopenAtNs_(0), reopenDelayNs_(REOPEN_MIN_NS),
+          lastReceiveNs_(0), rxFrames_(0), txFrames_(0), crcErrors_(0), reconnects_(0) {}
+
+    ~SerialInterface() {
+        shutdown();
+    }
 
     bool initialize() override {
         // Open serial port
-        connected_ = true; // Placeholder
-        return connected_;
+        fd_ = openSerialPort(portName_, baudRate_);
+        if (fd_ < 0) return false;
+
+        epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+        wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (epollFd_ < 0 || wakeFd_ < 0) {
+            closeDescriptors();
+            return false;
+        }
+
+        epoll_event wakeEvent{};
+        wakeEvent.events = EPOLLIN;
+        wakeEvent.data.fd = wakeFd_;
+        if (!watchPort() ||
+            epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &wakeEvent) != 0) {
+            closeDescriptors();
+            return false;
+        }
+
+        decoder_.reset();
+        connected_ = true;
+        ioRunning_ = true;
+        ioThread_ = std::thread(&SerialInterface::ioLoop, this);
+        return true;
     }
 
     bool update() override {
-        // Process queues
+        // Queues are serviced by the I/O thread
         return connected_;
     }
 
     bool shutdown() override {
+        if (ioThread_.joinable()) {
+            ioRunning_ = false;
+            wake();
+            ioThread_.join();
+        }
+        closeDescriptors();
         connected_ = false;
         return true;
     }
 
-    bool send(const std::vector<uint8_t>& data) override {
-        if (!connected_) return false;
-        std::lock_guard<std::mutex> lock(txMutex_);
-        txQueue_.push(data);
+    using ICommunicationInterface::send;
+
+    bool send(std::span<const uint8_t> data) override {
+        if (!connected_ || data.size() > MAX_FRAME_SIZE) return false;
+        bool queued = txQueue_.tryEmplace([&data](CommFrame& frame) {
+            frame.length = static_cast<uint16_t>(data.size());
+            std::memcpy(frame.data, data.data(), data.size());
+        });
+        if (!queued) return false; // TX backlog full (counted as overflow)
+        wake();
         return true;
     }
 
-    std::vector<uint8_t> receive() override {
-        std::lock_guard<std::mutex> lock(rxMutex_);
-        if (rxQueue_.empty()) return {};
-        auto data = rxQueue_.front();
+    size_t receiveInto(std::span<uint8_t> buffer) override {
+        CommFrame* frame = rxQueue_.front();
+        if (!frame) return 0;
+        size_t length = std::min<size_t>(frame->length, buffer.size());
+        std::memcpy(buffer.data(), frame->data, length);
+        lastReceiveNs_ = frame->timestampNs;
         rxQueue_.pop();
-        return data;
+        return length;
     }
 
+    int64_t getLastReceiveNs() const override { return lastReceiveNs_; }
+
     bool isConnected() const override { return connected_; }
+
+    uint64_t getRxFrames() const { return rxFrames_; }
+    uint64_t getRxDropped() const { return rxQueue_.getOverflowCount(); }
+    uint64_t getTxFrames() const { return txFrames_; }
+    uint64_t getTxDropped() const { return txQueue_.getOverflowCount(); }
+    uint64_t getCrcErrors() const { return crcErrors_; }
+    uint64_t getReconnects() const { return reconnects_; }
     
     std::string getStatus() const override {
         return "Serial " + portName_ + ": " + 
-               (connected_ ? "Connected" : "Disconnected");
+               (connected_ ? "Connected" : "Disconnected") +
+               " (" + std::to_string(reconnects_.load()) + " reconnects)" +
+               " | RX " + std::to_string(rxFrames_.load()) +
+               " (" + std::to_string(crcErrors_.load()) + " CRC errors, queue hw " +
+               std::to_string(rxQueue_.getHighWaterMark()) + "/" +
+               std::to_string(QUEUE_FRAMES) + ", overflow " +
+               std::to_string(rxQueue_.getOverflowCount()) + ")" +
+               " | TX " + std::to_string(txFrames_.load()) +
+               " (queue hw " + std::to_string(txQueue_.getHighWaterMark()) + "/" +
+               std::to_string(QUEUE_FRAMES) + ", overflow " +
+               std::to_string(txQueue_.getOverflowCount()) + ")";
     }
     
     std::string getComponentName() const override { 
         return "Serial_" + portName_; 
     }
+
+private:
+    void wake() {
+        if (wakeFd_ < 0) return;
+        uint64_t one = 1;
+        ssize_t written = ::write(wakeFd_, &one, sizeof(one));
+        (void)written; // Counter already nonzero if this fails with EAGAIN
+    }
+
+    void closeDescriptors() {
+        if (epollFd_ >= 0) ::close(epollFd_);
+        if (wakeFd_ >= 0) ::close(wakeFd_);
+        if (fd_ >= 0) ::close(fd_);
+        epollFd_ = wakeFd_ = fd_ = -1;
+    }
+
+    bool watchPort() {
+        epoll_event portEvent{};
+        portEvent.events = EPOLLIN;
+        portEvent.data.fd = fd_;
+        return epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd_, &portEvent) == 0;
+    }
+
+    // I/O thread: drop the port after an error or hangup. Frames still
+    // queued for it are stale by the time it comes back, so they go too.
+    void closePort() {
+        epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd_, nullptr);
+        ::close(fd_);
+        fd_ = -1;
+        connected_ = false;
+        while (txQueue_.front()) txQueue_.pop();
+        txEncodedLength_ = txEncodedOffset_ = 0;
+        waitingForWritable_ = false;
+        reopenDelayNs_ = REOPEN_MIN_NS;
+        reopenAtNs_ = monotonicNowNs() + reopenDelayNs_;
+    }
+
+    // I/O thread: try the port again once the backoff has elapsed,
+    // doubling the delay after each failed attempt
+    bool reopenPort() {
+        int64_t now = monotonicNowNs();
+        if (now < reopenAtNs_) return false;
+
+        fd_ = openSerialPort(portName_, baudRate_);
+        if (fd_ >= 0 && watchPort()) {
+            decoder_.reset();
+            connected_ = true;
+            reconnects_++;
+            return true;
+        }
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+        reopenDelayNs_ = std::min(reopenDelayNs_ * 2, REOPEN_MAX_NS);
+        reopenAtNs_ = now + reopenDelayNs_;
+        return false;
+    }
+
+    void ioLoop() {
+        epoll_event events[2];
+        uint8_t chunk[READ_CHUNK];
+
+        while (ioRunning_) {
+            // While the port is closed only the wakeup eventfd is watched,
+            // so the wait doubles as the backoff
+            int timeoutMs = 100;
+            if (fd_ < 0 && !reopenPort()) {
+                int64_t remainingNs = reopenAtNs_ - monotonicNowNs();
+                timeoutMs = static_cast<int>(std::clamp<int64_t>(remainingNs / 1000000 + 1, 1, 100));
+            }
+
+            int count = epoll_wait(epollFd_, events, 2, timeoutMs);
+            if (count < 0 && errno != EINTR) break;
+
+            for (int i = 0; i < count; i++) {
+                if (events[i].data.fd == wakeFd_) {
+                    uint64_t value;
+                    ssize_t drained = ::read(wakeFd_, &value, sizeof(value));
+                    (void)drained;
+                    continue;
+                }
+
+                if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                    closePort(); // Device unplugged
+                    break;
+                }
+
+                if (events[i].events & EPOLLIN) {
+                    ssize_t n;
+                    while ((n = ::read(fd_, chunk, sizeof(chunk))) > 0) {
+                        int64_t receiveNs = monotonicNowNs();
+                        decoder_.feed(chunk, static_cast<size_t>(n),
+                                      [this, receiveNs](const uint8_t* payload, size_t length) {
+                                          pushReceived(payload, length, receiveNs);
+                                      });
+                    }
+                    crcErrors_ = decoder_.getCrcErrors();
+                }
+            }
+
+            if (ioRunning_ && fd_ >= 0) flushTransmit();
+        }
+    }
+
+    void pushReceived(const uint8_t* payload, size_t length, int64_t receiveNs) {
+        // A full queue means the control loop is not draining fast enough;
+        // the frame is dropped and counted as an overflow
+        bool queued = rxQueue_.tryEmplace([payload, length, receiveNs](CommFrame& frame) {
+            frame.length = static_cast<uint16_t>(length);
+            std::memcpy(frame.data, payload, length);
+            frame.timestampNs = receiveNs;
+        });
+        if (queued) rxFrames_++;
+    }
+
+    // Write as many queued frames as the port accepts without blocking
+    void flushTransmit() {
+        while (true) {
+            if (txEncodedOffset_ == txEncodedLength_) {
+                CommFrame* frame = txQueue_.front();
+                if (!frame) break;
+                stampTimePing(frame->data, frame->length, monotonicNowNs());
+                txEncodedLength_ = encodeFrame(frame->data, frame->length, txEncoded_);
+                txEncodedOffset_ = 0;
+                txQueue_.pop();
+                txFrames_++;
+            }
+
+            ssize_t n = ::write(fd_, txEncoded_ + txEncodedOffset_,
+                                txEncodedLength_ - txEncodedOffset_);
+            if (n < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                closePort();
+                return;
+            }
+            txEncodedOffset_ += static_cast<size_t>(n);
+        }
+
+        // Ask epoll for EPOLLOUT only while a frame is partially written
+        bool pending = txEncodedOffset_ < txEncodedLength_;
+        if (pending != waitingForWritable_) {
+            epoll_event portEvent{};
+            portEvent.events = EPOLLIN;
+            if (pending) portEvent.events |= EPOLLOUT;
+            portEvent.data.fd = fd_;
+            epoll_ctl(epollFd_, EPOLL_CTL_MOD, fd_, &portEvent);
+            waitingForWritable_ = pending;
+        }
+    }
 };
 
 // Modbus communication for industrial equipment
+// Thin ICommunicationInterface wrapper around a ModbusEngine. Devices
+// (VFDs, hydraulic controllers) register their polls on getEngine() and
+// read feedback from its register cache; this interface only owns the
+// engine lifecycle. Raw byte streams are not Modbus requests, so send()
+// rejects them and receiveInto() never yields data.
 class ModbusInterface : public ICommunicationInterface {
 private:
     std::string deviceAddress_;
-    bool connected_;
+    std::shared_ptr<ModbusEngine> engine_;
 
 public:
-    ModbusInterface(const std::string& address)
-        : deviceAddress_(address), connected_(false) {}
+    ModbusInterface(const std::string& address, int baud = 9600,
+                    const ModbusConfig& config = ModbusConfig{})
+        : deviceAddress_(address),
+          engine_(std::make_shared<ModbusEngine>(address, baud, config)) {}
 
     bool initialize() override {
-        // Initialize Modbus connection
-        connected_ = true;
-        return true;
+        // Connection is made (and retried) by the engine's worker thread
+        return engine_->start();
     }
 
-    bool update() override { return connected_; }
-    bool shutdown() override { connected_ = false; return true; }
+    bool update() override { return engine_->isConnected(); }
+    bool shutdown() override { engine_->stop(); return true; }
 
-    bool send(const std::vector<uint8_t>& data) override {
-        // Send Modbus command
-        return connected_;
+    using ICommunicationInterface::send;
+
+    bool send(std::span<const uint8_t> data) override {
+        // Register writes go through getEngine()->queueWrite()
+        (void)data;
+        return false;
     }
 
-    std::vector<uint8_t> receive() override {
-        // Receive Modbus response
-        return {};
+    size_t receiveInto(std::span<uint8_t> buffer) override {
+        // Responses land in the engine's register cache
+        (void)buffer;
+        return 0;
     }
 
-    bool isConnected() const override { return connected_; }
+    bool isConnected() const override { return engine_->isConnected(); }
+
+    const std::shared_ptr<ModbusEngine>& getEngine() const { return engine_; }
     
     std::string getStatus() const override {
-        return "Modbus " + deviceAddress_ + ": " + 
-               (connected_ ? "Connected" : "Disconnected");
+        return engine_->getStatus();
     }
     
     std::string getComponentName() const override { 
@@ -126,14 +393,18 @@ public:
     bool update() override { return connected_; }
     bool shutdown() override { connected_ = false; return true; }
 
-    bool send(const std::vector<uint8_t>& data) override {
+    using ICommunicationInterface::send;
+
+    bool send(std::span<const uint8_t> data) override {
         // Send telemetry packet
+        (void)data;
         return connected_;
     }
 
-    std::vector<uint8_t> receive() override {
+    size_t receiveInto(std::span<uint8_t> buffer) override {
         // Receive commands from surface
-        return {};
+        (void)buffer;
+        return 0;
     }
 
     bool isConnected() const override { return connected_; }
@@ -10,26 +10,160 @@
 #include "data_logger.hpp"
 #include "ecu.hpp"
 #include "ecu_mangr.hpp"
+#include "scheduler.hpp"
+#include "rate_groups.hpp"
+#include "telemetry_recorder.hpp"
+#include "telemetry.hpp"
+#include "telemetry_delta.hpp"
+#include "snapshot.hpp"
+#include "pid.hpp"
+#include "host_metrics.hpp"
+#include "state_bus.hpp"
+#include "actuator_output.hpp"
+#include "surface_commands.hpp"
+#include "pipeline.hpp"
+#include "time_sync.hpp"
 #include <iostream>
+#include <algorithm>
+#include <array>
 #include <vector>
 #include <memory>
 #include <map>
 #include <chrono>
+#include <fstream>
 #include <thread>
+#include <atomic>
+#include <mutex>
+
+// Well-known control loop names driven by the surface auto modes
+inline const std::string CONTROL_LOOP_DEPTH = "Depth";
+inline const std::string CONTROL_LOOP_HEADING = "Heading";
 
 class TM_ControlSystem {
 private:
+    static constexpr int MAX_MESSAGES_PER_CYCLE = 8;
+    static constexpr size_t ECU_POLL_WORKERS = 2;
+    static constexpr int ECU_POLL_TIMEOUT_MS = 100;
+    static constexpr double ACTUATOR_OUTPUT_RATE_HZ = 100.0;
+    static constexpr double TIME_SYNC_RATE_HZ = 2.0;      // Pings per node
+    static constexpr int STARTUP_TIMEOUT_MS = 3000;       // Per component, overridable
+    static constexpr int ECU_STARTUP_TIMEOUT_MS = 1000;
+    static constexpr int CONTROL_HEARTBEAT_CYCLES = 20;   // Watched by a separate safety thread
+
     // Component collections using polymorphism
     std::vector<std::shared_ptr<ISensor>> sensors_;
     std::vector<std::shared_ptr<IActuator>> actuators_;
     std::vector<std::shared_ptr<ICommunicationInterface>> commInterfaces_;
+
+    // Requested update rate for each component (0 = every cycle)
+    std::vector<double> sensorRates_;
+    std::vector<double> actuatorRates_;
+    std::vector<double> commRates_;
+    // Links that carry the surface telemetry downlink (parallel to commInterfaces_)
+    std::vector<bool> commDownlinks_;
     
     std::unique_ptr<SafetyMonitor> safetyMonitor_;
-    std::unique_ptr<DataLogger> logger_;
+    std::shared_ptr<DataLogger> logger_;
     std::unique_ptr<ECUManager> ecuManager_;
+    const Topology* topology_;                     // The tool's ECU table (topology.hpp)
+    std::shared_ptr<HostMetrics> hostMetrics_;     // ECU01 health source
+    std::unique_ptr<PeriodicScheduler> scheduler_;
+    std::unique_ptr<RateGroupExecutor> executor_;
+    std::unique_ptr<TelemetryRecorder> recorder_;
+    std::unique_ptr<StateBusWriter> stateBus_;     // Shared memory for the dashboards
+    double stateBusRateHz_;                         // 0 = not published
+
+    // Recorder channel IDs (parallel to sensors_/actuators_)
+    std::vector<uint32_t> sensorChannels_;
+    std::vector<uint32_t> actuatorChannels_;
+    int64_t cycleTimestampNs_;
+    int64_t startTimestampNs_;
+
+    // Per-cycle state: tasks write sampling_, the SNAPSHOT stage freezes
+    // it into snapshot_ (read by everything after it in the cycle) and
+    // publishes it for other threads
+    SystemSnapshot sampling_;
+    SystemSnapshot snapshot_;
+    SnapshotBuffer publishedSnapshot_;
+    // ECU whose watchdog each comm interface feeds when it receives
+    // (parallel to commInterfaces_, INVALID_ECU_HANDLE = none)
+    std::vector<ECUHandle> commECUs_;
+    // What the control thread sends on for each link (see controlLink)
+    std::vector<std::shared_ptr<ICommunicationInterface>> controlLinks_;
+    // Node clock estimate per link, used on the links with a node ECU
+    std::vector<NodeClockSync> clockSync_;
+    bool virtualClock_;             // Cycle times come from runCycle(timestampNs)
+    // Sample time last recorded per channel (recording thread)
+    std::vector<int64_t> sensorRecordedNs_;
+    std::vector<int64_t> actuatorRecordedNs_;
+
+    // Per-component initialize() timeouts (by component name)
+    std::map<std::string, int> startupTimeouts_;
+
+    // Last-reply clocks for ECUs that answer through another component
+    // (a VFD's Modbus polls), by ECU ID
+    std::map<std::string, std::function<int64_t()>> ecuReplySources_;
+
+    // On-demand ECU reports: the ECUReports task copies the ECUs and a
+    // background thread formats and writes them
+    std::atomic<bool> reportsRequested_;
+    std::atomic<bool> reportsRunning_;
+    std::thread reportThread_;
+    std::mutex reportRequestMutex_;
+    std::string requestedReportDirectory_;  // Guarded by reportRequestMutex_
+    std::string reportDirectory_;           // Of the running report (control thread)
+
+    // Actuator channels on the Teensy nodes, one frame per node per output cycle
+    std::vector<ActuatorOutputConfig> actuatorOutputConfigs_;
+    ActuatorOutputStage actuatorOutput_;
+
+    // Surface commands, parsed on receive and applied at the start of a cycle
+    SurfaceCommandIntake surfaceCommands_;
+
+    // Orientation source fed from IMU_QUATERNION packets
+    std::shared_ptr<IMUSensor> imuSensor_;
+
+    // One frame per cycle, shared by every downlink
+    TelemetryEncoder telemetryEncoder_;
+    uint64_t telemetryCycle_;
+    // Keyframe + delta downlink, one encoder per downlink since each
+    // receiver holds its own state (parallel to commInterfaces_, unused
+    // on the other links)
+    std::vector<TelemetryDeltaEncoder> telemetryDeltas_;
+    bool telemetryCompressed_;
+    std::map<std::string, TelemetryChannelConfig> telemetryChannels_;
+    std::atomic<bool> keyframeRequested_;   // REQUEST_KEYFRAME, taken by the encoding thread
+    std::array<uint8_t, MAX_FRAME_SIZE> rxBuffer_;
+
+    // Pipelined mode (setPipeline): links on the I/O thread, recorder and
+    // downlink on the logging thread, connected by SPSC queues
+    bool pipelined_;
+    PipelineThreadConfig ioConfig_;
+    PipelineThreadConfig loggingConfig_;
+    std::unique_ptr<PipelineWorker> ioThread_;
+    std::unique_ptr<PipelineWorker> loggingThread_;
+    std::unique_ptr<LinkQueue> inboundFrames_;      // I/O -> control
+    std::unique_ptr<LinkQueue> outboundFrames_;     // Control -> I/O (actuator frames)
+    std::unique_ptr<LinkQueue> telemetryFrames_;    // Logging -> I/O
+    std::unique_ptr<SnapshotQueue> recordQueue_;    // Control -> logging, end of each cycle
+    SystemSnapshot loggingSnapshot_;                // Logging thread's latest cycle
+    std::array<uint8_t, MAX_FRAME_SIZE> ioRxBuffer_;
+    ThreadHeartbeat controlHeartbeat_;
+    uint32_t lastStaleHeartbeats_;
     
-    bool systemRunning_;
-    std::chrono::milliseconds loopPeriod_;
+    std::atomic<bool> systemRunning_;
+    std::atomic<bool> stopRequested_;   // requestStop(), may be set from a signal handler
+    static_assert(std::atomic<bool>::is_always_lock_free,
+                  "requestStop() must be async-signal-safe");
+    double loopRateHz_;
+    RealtimeConfig realtimeConfig_;
+    double safetyRateHz_;           // > 0: safety limits run on their own thread
+    RealtimeConfig safetyRealtimeConfig_;
+    uint64_t lastSafetyMask_;
+    WarningLimiter ecuWarning_;     // "Not all ECUs online", once per change or 30 s
+
+    // Closed loops, each a CONTROL task in its own rate group
+    ControllerRegistry controllers_;
 
     // Control state
     struct ControlState {
@@ -41,412 +175,1124 @@ private:
 
 public:
     TM_ControlSystem() 
-        : systemRunning_(false), 
-          loopPeriod_(100) { // 10 Hz default
+        : topology_(&DIGEM_PI5_TOPOLOGY), stateBusRateHz_(100.0),
+          cycleTimestampNs_(0), startTimestampNs_(0),
+          sampling_{}, snapshot_{}, virtualClock_(false),
+          reportsRequested_(false), reportsRunning_(false),
+          telemetryCycle_(UINT64_MAX), telemetryCompressed_(true), keyframeRequested_(false),
+          pipelined_(false), ioConfig_{}, loggingConfig_{}, loggingSnapshot_{},
+          lastStaleHeartbeats_(0),
+          systemRunning_(false), stopRequested_(false),
+          loopRateHz_(10.0), // 10 Hz default
+          realtimeConfig_{0, -1, false},
+          safetyRateHz_(0.0), safetyRealtimeConfig_{0, -1, false},
+          lastSafetyMask_(0) {
+        // Exists before initialize() so limits can be configured up front
+        safetyMonitor_ = std::make_unique<SafetyMonitor>();
         controlState_ = {0.0, 0.0, false, false};
     }
 
+    ~TM_ControlSystem() {
+        stopPipeline();
+        if (reportThread_.joinable()) reportThread_.join();
+    }
+
     bool initialize() {
         std::cout << "Initializing ROV Control System...\n";
 
-        // Create logger first
-        logger_ = std::make_unique<DataLogger>("rov_log.txt");
+        // Create logger first. Async so SD card writes never stall the loop
+        logger_ = std::make_shared<DataLogger>("rov_log.txt", LogMode::ASYNCHRONOUS,
+                                               OverflowPolicy::DROP);
         logger_->initialize();
         logger_->log("System initialization started");
 
         // Create ECU Manager
-        ecuManager_ = std::make_unique<ECUManager>("TBM ROV Control System", logger_);
+        ecuManager_ = std::make_unique<ECUManager>(std::string(topology_->systemName), logger_);
         logger_->log("ECU Manager created");
 
         // Setup all ECUs in the system
         setupECUs();
-        
-        // Initialize ECU Manager (this will initialize all ECUs)
-        if (!ecuManager_->initialize()) {
+
+        if (sensors_.size() > SNAPSHOT_MAX_SENSORS ||
+            actuators_.size() > SNAPSHOT_MAX_ACTUATORS) {
+            logger_->log("CRITICAL: Too many sensors/actuators for the system snapshot");
+            return false;
+        }
+        if (!checkActuatorOutputs()) {
+            std::cerr << "ERROR: Actuator outputs not bound (see log)\n";
+            return false;
+        }
+
+        // Bring everything up concurrently. Stage 0: ECUs and comm
+        // interfaces (each owns its own link). Stage 1: sensors and
+        // actuators, which may use a link from stage 0 (VFDs on Modbus).
+        StartupSequencer startup;
+        ecuManager_->addStartupTasks(startup, 0, ECU_STARTUP_TIMEOUT_MS);
+        addStartupTasks(startup, 0, commInterfaces_);
+        addStartupTasks(startup, 1, sensors_);
+        addStartupTasks(startup, 1, actuators_);
+        bool started = startup.run();
+
+        bool ecusOk = ecuManager_->completeStartup(startup);
+        for (const auto& result : startup.getResults()) {
+            if (!ecuManager_->getECU(result.name)) logger_->log(StartupSequencer::describe(result));
+        }
+        logger_->log("Startup: " + std::to_string(startup.getTaskCount()) + " components in " +
+                     StartupSequencer::formatMs(startup.getElapsedNs()) + " ms");
+        if (!ecusOk) {
             logger_->log("CRITICAL: ECU initialization failed");
             std::cerr << "ERROR: One or more ECUs failed to initialize!\n";
             return false;
         }
-        
+        if (!started) return false;
+
         logger_->log("All ECUs initialized successfully");
+
+        // Health queries run on their own workers; the ECU_HEALTH tasks
+        // only apply the cached results
+        ecuManager_->startHealthPolling(ECU_POLL_WORKERS, ECU_POLL_TIMEOUT_MS);
         
         // Print ECU table to console
         ecuManager_->printSystemStatus();
 
-        // Create safety monitor
-        safetyMonitor_ = std::make_unique<SafetyMonitor>();
+        // Safety monitor (limits were bound in addSafetyLimit)
         safetyMonitor_->initialize();
-
-        // Initialize all sensors
-        for (auto& sensor : sensors_) {
-            if (!sensor->initialize()) {
-                logger_->log("Failed to initialize: " + 
-                           sensor->getComponentName());
-                return false;
-            }
-            logger_->log("Initialized: " + sensor->getComponentName());
-        }
-
-        // Initialize all actuators
         for (auto& actuator : actuators_) {
-            if (!actuator->initialize()) {
-                logger_->log("Failed to initialize: " + 
-                           actuator->getComponentName());
-                return false;
-            }
-            logger_->log("Initialized: " + actuator->getComponentName());
             safetyMonitor_->addActuator(actuator);
         }
 
-        // Initialize communication
-        for (auto& comm : commInterfaces_) {
-            if (!comm->initialize()) {
-                logger_->log("Failed to initialize: " + 
-                           comm->getComponentName());
-                return false;
-            }
-            logger_->log("Initialized: " + comm->getComponentName());
+        // Binary recorder for every sensor reading and actuator command
+        setupTelemetryRecorder();
+        setupTelemetryDownlink();
+        if (pipelined_) setupPipeline();
+
+        // Assign every component to its rate group
+        setupRateGroups();
+
+        if (safetyRateHz_ > 0.0) {
+            safetyMonitor_->startThread(safetyRateHz_, publishedSnapshot_,
+                                        safetyRealtimeConfig_);
+            logger_->log("Safety monitor running at " +
+                         std::to_string(safetyRateHz_) + " Hz on its own thread");
         }
 
         logger_->log("System initialization complete");
-        
-        // Generate detailed ECU reports
-        ecuManager_->generateDetailedReports("./ecu_reports/");
-        logger_->log("ECU reports generated in ./ecu_reports/");
+
+        // Written off the startup path by the ECUReports task
+        requestECUReports();
         
         return true;
     }
 
+    // Startup from every component, with its per-component timeout
+    template <typename Component>
+    void addStartupTasks(StartupSequencer& startup, size_t stage,
+                         const std::vector<std::shared_ptr<Component>>& components) {
+        for (const auto& component : components) {
+            const std::string name = component->getComponentName();
+            auto timeout = startupTimeouts_.find(name);
+            startup.addTask(stage, name, [component]() { return component->initialize(); },
+                            timeout != startupTimeouts_.end() ? timeout->second
+                                                              : STARTUP_TIMEOUT_MS);
+        }
+    }
+
+    // ECUs from the topology table; the main controller reports host health
     void setupECUs() {
-        logger_->log("Setting up ECU architecture...");
+        logger_->log("Setting up ECU architecture (" + std::string(topology_->name) + ")...");
+        ecuManager_->loadTopology(*topology_);
 
-        // ===== ECU 1: Raspberry Pi Main Controller =====
-        auto pi = std::make_shared<ECU>("ECU01", "Raspberry Pi 4B Main Controller", 
-                                        ECUType::MAIN_CONTROLLER);
-        
-        pi->setLocation(ECULocation{
-            "Main Electronics Enclosure",
-            "Standoff Mount",
-            0.0, 0.0, 0.0  // Reference position
-        });
-        
-        pi->setCommunication(CommunicationInfo{
-            "Local", "localhost", 0, 0, 10.0
-        });
-        
-        pi->addControlledDevice(ControlledDevice{
-            "System Coordinator", "Software", "N/A", 0
-        });
-        pi->addControlledDevice(ControlledDevice{
-            "Safety Monitor", "Software", "N/A", 0
-        });
-        pi->addControlledDevice(ControlledDevice{
-            "Data Logger", "Software", "N/A", 0
-        });
-        pi->addControlledDevice(ControlledDevice{
-            "Control Algorithms (PID)", "Software", "N/A", 0
-        });
-        
-        ecuManager_->addECU(pi);
+        // Health from /proc and /sys, also published for the dashboards
+        hostMetrics_ = std::make_shared<HostMetrics>();
+        for (ECUHandle handle = 0; handle < ecuManager_->getTotalECUCount(); handle++) {
+            ECU& ecu = ecuManager_->ecuAt(handle);
+            if (ecu.getType() != ECUType::MAIN_CONTROLLER || !hostMetrics_->isAvailable()) {
+                continue;
+            }
+            ecu.setHealthQuery([metrics = hostMetrics_](ECUHealthReport& report, int) {
+                HostMetricsSample sample;
+                if (!metrics->sample(sample)) return false;
+                metrics->publish(sample);
+                report = {sample.cpuUsagePercent, sample.memoryUsagePercent,
+                          sample.temperatureCelsius};
+                return true;
+            });
+        }
 
-        // ===== ECU 2: Teensy Sensor Node =====
-        auto teensySensor = std::make_shared<ECU>("ECU02", "Teensy 4.0 Sensor Node", 
-                                                   ECUType::SENSOR_NODE);
-        
-        teensySensor->setLocation(ECULocation{
-            "Main Electronics Enclosure",
-            "DIN Rail Mount",
-            0.15, 0.0, 0.0
-        });
-        
-        teensySensor->setCommunication(CommunicationInfo{
-            "Serial UART", "/dev/ttyACM0", 115200, 0, 10.0
-        });
-        
-        teensySensor->addControlledDevice(ControlledDevice{
-            "Depth Pressure Sensor (MS5837)", "Sensor", "I2C", 0
-        });
-        teensySensor->addControlledDevice(ControlledDevice{
-            "Water Temperature Sensor", "Sensor", "I2C", 1
-        });
-        teensySensor->addControlledDevice(ControlledDevice{
-            "9-DOF IMU (BNO055)", "Sensor", "I2C", 2
-        });
-        teensySensor->addControlledDevice(ControlledDevice{
-            "Internal Temperature Sensor", "Sensor", "Analog", 0
-        });
-        
-        ecuManager_->addECU(teensySensor);
+        logger_->log("ECU architecture setup complete - " + 
+                    std::to_string(ecuManager_->getTotalECUCount()) + " ECUs configured");
+    }
 
-        // ===== ECU 3: Teensy Actuator Node =====
-        auto teensyActuator = std::make_shared<ECU>("ECU03", "Teensy 4.0 Actuator Node", 
-                                                     ECUType::ACTUATOR_NODE);
-        
-        teensyActuator->setLocation(ECULocation{
-            "Main Electronics Enclosure",
-            "DIN Rail Mount",
-            0.30, 0.0, 0.0
-        });
-        
-        teensyActuator->setCommunication(CommunicationInfo{
-            "Serial UART", "/dev/ttyACM1", 115200, 0, 10.0
-        });
-        
-        teensyActuator->addControlledDevice(ControlledDevice{
-            "Vertical Thruster 1 (T200)", "Thruster", "PWM", 3
-        });
-        teensyActuator->addControlledDevice(ControlledDevice{
-            "Vertical Thruster 2 (T200)", "Thruster", "PWM", 4
-        });
-        teensyActuator->addControlledDevice(ControlledDevice{
-            "Horizontal Thruster 1 (T200)", "Thruster", "PWM", 5
-        });
-        teensyActuator->addControlledDevice(ControlledDevice{
-            "Horizontal Thruster 2 (T200)", "Thruster", "PWM", 6
-        });
-        teensyActuator->addControlledDevice(ControlledDevice{
-            "Gripper Valve", "Hydraulic Valve", "PWM", 7
-        });
-        teensyActuator->addControlledDevice(ControlledDevice{
-            "Current Sensors (4x)", "Sensor", "Analog", 0
-        });
-        
-        ecuManager_->addECU(teensyActuator);
+    // Components may declare an update rate; 0 runs them every cycle
+    void addSensor(std::shared_ptr<ISensor> sensor, double rateHz = 0.0) {
+        sensors_.push_back(sensor);
+        sensorRates_.push_back(rateHz);
+    }
 
-        // ===== ECU 4: VFD Controller 1 - Cutter Head =====
-        auto vfd1 = std::make_shared<ECU>("ECU04", "VFD Cutter Head Motor", 
-                                          ECUType::VFD_CONTROLLER);
-        
-        vfd1->setLocation(ECULocation{
-            "Power Distribution Panel",
-            "Panel Mount",
-            0.0, 0.25, 0.0
-        });
-        
-        vfd1->setCommunication(CommunicationInfo{
-            "Modbus RTU", "192.168.1.50", 9600, 1, 5.0
-        });
-        
-        vfd1->addControlledDevice(ControlledDevice{
-            "Cutter Head Motor (15kW)", "3-Phase Motor", "VFD", 0
-        });
-        
-        ecuManager_->addECU(vfd1);
+    void addActuator(std::shared_ptr<IActuator> actuator, double rateHz = 0.0) {
+        actuators_.push_back(actuator);
+        actuatorRates_.push_back(rateHz);
+    }
 
-        // ===== ECU 5: VFD Controller 2 - Slurry Pump =====
-        auto vfd2 = std::make_shared<ECU>("ECU05", "VFD Slurry Pump", 
-                                          ECUType::VFD_CONTROLLER);
-        
-        vfd2->setLocation(ECULocation{
-            "Power Distribution Panel",
-            "Panel Mount",
-            0.0, 0.50, 0.0
-        });
-        
-        vfd2->setCommunication(CommunicationInfo{
-            "Modbus RTU", "192.168.1.51", 9600, 2, 5.0
-        });
-        
-        vfd2->addControlledDevice(ControlledDevice{
-            "Slurry Pump Motor (22kW)", "3-Phase Motor", "VFD", 0
-        });
-        
-        ecuManager_->addECU(vfd2);
+    // downlink: the link to the surface, which gets the telemetry frame
+    // every time it runs. Node and fieldbus links carry only their own traffic.
+    void addCommunication(std::shared_ptr<ICommunicationInterface> comm,
+                          double rateHz = 0.0, bool downlink = false) {
+        commInterfaces_.push_back(comm);
+        commRates_.push_back(rateHz);
+        commDownlinks_.push_back(downlink);
+    }
 
-        // ===== ECU 6: Hydraulic Controller 1 - Thrust System =====
-        auto hydraulic1 = std::make_shared<ECU>("ECU06", "Hydraulic Controller - Thrust", 
-                                                ECUType::HYDRAULIC_CONTROLLER);
-        
-        hydraulic1->setLocation(ECULocation{
-            "Hydraulic Manifold Bay",
-            "Manifold Mount",
-            0.0, 0.0, 0.15
-        });
-        
-        hydraulic1->setCommunication(CommunicationInfo{
-            "Modbus RTU", "192.168.1.52", 9600, 3, 5.0
-        });
-        
-        hydraulic1->addControlledDevice(ControlledDevice{
-            "Thrust Cylinder 1", "Hydraulic Cylinder", "Proportional Valve", 1
-        });
-        hydraulic1->addControlledDevice(ControlledDevice{
-            "Thrust Cylinder 2", "Hydraulic Cylinder", "Proportional Valve", 2
+    // Limit on a sensor's sampled value. The sensor must already be added;
+    // the check reads the value stored by its SENSOR_READ task and never
+    // calls into the sensor itself.
+    bool addSafetyLimit(const std::string& name, const std::shared_ptr<ISensor>& sensor,
+                        double minVal, double maxVal) {
+        auto it = std::find(sensors_.begin(), sensors_.end(), sensor);
+        if (it == sensors_.end() ||
+            !safetyMonitor_->addLimit(name, static_cast<size_t>(it - sensors_.begin()),
+                                      minVal, maxVal)) {
+            std::cerr << "ERROR: Safety limit " << name << " could not be bound\n";
+            return false;
+        }
+        return true;
+    }
+
+    // Evaluate safety limits on a dedicated thread (set before initialize())
+    void setSafetyRate(double rateHz, const RealtimeConfig& config = {0, -1, false}) {
+        safetyRateHz_ = rateHz;
+        safetyRealtimeConfig_ = config;
+    }
+
+    void setupStateBus() {
+        stateBus_ = std::make_unique<StateBusWriter>();
+        if (!stateBus_->open(STATE_BUS_NAME, stateBusRateHz_)) {
+            logger_->log("WARNING: Cannot create state bus " + std::string(STATE_BUS_NAME));
+            stateBus_.reset();
+            return;
+        }
+        for (size_t i = 0; i < sensors_.size(); i++) {
+            stateBus_->setSensor(i, sensors_[i]->getComponentName(), sensors_[i]->getUnits());
+        }
+        for (size_t i = 0; i < actuators_.size(); i++) {
+            stateBus_->setActuator(i, actuators_[i]->getComponentName());
+        }
+        const auto& ecus = ecuManager_->getAllECUs();
+        for (size_t i = 0; i < ecus.size(); i++) {
+            stateBus_->setECU(i, ecus[i]->getECUID(), ecus[i]->getComponentName());
+        }
+
+        // Runs after SNAPSHOT, so it publishes the frozen copy
+        double rateHz = executor_->addTask(stateBusRateHz_, TaskStage::HOUSEKEEPING, "StateBus",
+                                           [this]() {
+                                               stateBus_->publish(snapshot_, statusFlags(),
+                                                                  *ecuManager_);
+                                           });
+        logger_->log("State bus " + std::string(STATE_BUS_NAME) + " at " +
+                     std::to_string(rateHz) + " Hz");
+    }
+
+    void setupTelemetryRecorder() {
+        recorder_ = std::make_unique<TelemetryRecorder>("telemetry");
+
+        sensorChannels_.clear();
+        for (auto& sensor : sensors_) {
+            sensorChannels_.push_back(
+                recorder_->registerChannel(sensor->getComponentName()));
+        }
+        actuatorChannels_.clear();
+        for (auto& actuator : actuators_) {
+            actuatorChannels_.push_back(
+                recorder_->registerChannel(actuator->getComponentName() + ".cmd"));
+        }
+
+        size_t unrecorded = static_cast<size_t>(
+            std::count(sensorChannels_.begin(), sensorChannels_.end(), INVALID_TELEMETRY_CHANNEL) +
+            std::count(actuatorChannels_.begin(), actuatorChannels_.end(), INVALID_TELEMETRY_CHANNEL));
+        if (unrecorded > 0) {
+            logger_->log("WARNING: Telemetry recorder channel table full, " +
+                         std::to_string(unrecorded) + " channels not recorded");
+        }
+
+        if (!recorder_->initialize()) {
+            logger_->log("WARNING: Telemetry recorder failed to open segment");
+        }
+    }
+
+    void setupTelemetryDownlink() {
+        telemetryDeltas_.clear();
+        if (!telemetryCompressed_) return;
+
+        TelemetryDeltaEncoder encoder;
+        for (size_t i = 0; i < sensors_.size(); i++) {
+            auto it = telemetryChannels_.find(sensors_[i]->getComponentName());
+            if (it != telemetryChannels_.end()) encoder.configureSensor(i, it->second);
+        }
+        for (size_t i = 0; i < actuators_.size(); i++) {
+            auto it = telemetryChannels_.find(actuators_[i]->getComponentName());
+            if (it != telemetryChannels_.end()) encoder.configureActuator(i, it->second);
+        }
+        telemetryDeltas_.assign(commInterfaces_.size(), encoder);
+    }
+
+    void setupRateGroups() {
+        executor_ = std::make_unique<RateGroupExecutor>(loopRateHz_);
+        executor_->initialize();
+
+        sampling_ = SystemSnapshot{};
+        sampling_.sensorCount = static_cast<uint32_t>(sensors_.size());
+        sampling_.actuatorCount = static_cast<uint32_t>(actuators_.size());
+        // One sample up front so slow groups have a value (and safety a
+        // valid input) before their first slot comes around
+        int64_t now = monotonicNowNs();
+        size_t vectorOffset = 0;
+        for (size_t i = 0; i < sensors_.size(); i++) {
+            size_t channels = sensors_[i]->getChannelCount();
+            if (channels > 1 && vectorOffset + channels <= SNAPSHOT_MAX_VECTOR_VALUES) {
+                sampling_.vectorOffset[i] = static_cast<uint16_t>(vectorOffset);
+                sampling_.vectorCount[i] = static_cast<uint8_t>(channels);
+                vectorOffset += channels;
+            } else if (channels > 1) {
+                logger_->log("WARNING: No snapshot space for " +
+                             sensors_[i]->getComponentName() + " channels");
+            }
+            if (!imuSensor_) {
+                imuSensor_ = std::dynamic_pointer_cast<IMUSensor>(sensors_[i]);
+            }
+
+            sensors_[i]->updateAt(now);
+            sampling_.sensorValues[i] = sensors_[i]->readValue();
+            sampling_.sensorHealthy[i] = sensors_[i]->isHealthy();
+            sampling_.sensorSampleNs[i] = sampleTimeNs(*sensors_[i], now);
+            readSensorVector(i);
+        }
+        snapshot_ = sampling_;
+        // Recording starts from the next new sample of each channel
+        sensorRecordedNs_.assign(sampling_.sensorSampleNs,
+                                 sampling_.sensorSampleNs + sensors_.size());
+        actuatorRecordedNs_.assign(actuators_.size(), 0);
+        // Node ECUs by the link the topology puts them on (handle = row)
+        commECUs_.assign(commInterfaces_.size(), INVALID_ECU_HANDLE);
+        for (size_t link = 0; link < commECUs_.size(); link++) {
+            commECUs_[link] = linkHandle(*topology_, static_cast<int>(link));
+        }
+        controlLinks_.assign(commInterfaces_.size(), nullptr);
+        clockSync_.assign(commInterfaces_.size(), NodeClockSync{});
+
+        // Frames the I/O thread received since the last cycle
+        if (pipelined_) {
+            executor_->addTask(0.0, TaskStage::COMMAND, "Inbound", [this]() { drainInbound(); });
+        }
+
+        // Surface commands queued last cycle, emergency class first
+        executor_->addTask(0.0, TaskStage::COMMAND, "SurfaceCommands", [this]() {
+            surfaceCommands_.drain([this](const SurfaceCommand& command) {
+                applySurfaceCommand(command);
+            });
         });
-        hydraulic1->addControlledDevice(ControlledDevice{
-            "Hydraulic Pressure Sensor", "Sensor", "Analog 4-20mA", 1
+
+        // 0. ECU health monitoring, each ECU at its declared poll rate
+        for (ECUHandle handle = 0; handle < ecuManager_->getTotalECUCount(); handle++) {
+            const ECU& ecu = ecuManager_->ecuAt(handle);
+            auto source = ecuReplySources_.find(ecu.getECUID());
+            std::function<int64_t()> lastReplyNs =
+                source != ecuReplySources_.end() ? source->second : nullptr;
+            executor_->addTask(ecu.getCommunicationInfo().updateRateHz,
+                               TaskStage::ECU_HEALTH, ecu.getECUID(),
+                               [this, handle, lastReplyNs]() {
+                                   int64_t replyNs = lastReplyNs ? lastReplyNs() : 0;
+                                   if (replyNs > 0) ecuManager_->markCommunication(handle, replyNs);
+                                   ecuManager_->updateECU(handle);
+                               });
+        }
+
+        // 1. Read sensors
+        for (size_t i = 0; i < sensors_.size(); i++) {
+            auto sensor = sensors_[i];
+            executor_->addTask(sensorRates_[i], TaskStage::SENSOR_READ,
+                               sensor->getComponentName(),
+                               [this, i, sensor]() {
+                                   sensor->updateAt(cycleTimestampNs_);
+                                   sampling_.sensorValues[i] = sensor->readValue();
+                                   sampling_.sensorHealthy[i] = sensor->isHealthy();
+                                   sampling_.sensorSampleNs[i] =
+                                       sampleTimeNs(*sensor, cycleTimestampNs_);
+                                   readSensorVector(i);
+                               });
+        }
+
+        // Freeze this cycle's samples (every cycle)
+        executor_->addTask(0.0, TaskStage::SNAPSHOT, "Snapshot",
+                           [this]() { publishSnapshot(); });
+
+        // 2. Check safety interlocks (every cycle)
+        executor_->addTask(0.0, TaskStage::SAFETY, "SafetyMonitor", [this]() {
+            safetyMonitor_->evaluate(snapshot_);
+            if (safetyMonitor_->isInterlockLatched()) {
+                safetyMonitor_->applyInterlock();
+            }
+
+            // Log when the set of violated limits changes, not every cycle
+            uint64_t mask = safetyMonitor_->getViolationMask();
+            if (mask != lastSafetyMask_) {
+                logger_->log(mask ? "SAFETY FAULT: " + safetyMonitor_->describe(mask)
+                                  : "Safety limits back in range (interlock latched)");
+                lastSafetyMask_ = mask;
+            }
+            uint32_t stale = safetyMonitor_->getStaleHeartbeats();
+            if (stale != lastStaleHeartbeats_) {
+                logger_->log(stale ? std::string(safetyMonitor_->isCriticalHeartbeat(stale)
+                                                     ? "SAFETY FAULT: " : "WARNING: ") +
+                                         safetyMonitor_->describeHeartbeats(stale)
+                                   : "Thread heartbeats back");
+                lastStaleHeartbeats_ = stale;
+            }
         });
-        
-        ecuManager_->addECU(hydraulic1);
 
-        // ===== ECU 7: Hydraulic Controller 2 - Steering =====
-        auto hydraulic2 = std::make_shared<ECU>("ECU07", "Hydraulic Controller - Steering", 
-                                                ECUType::HYDRAULIC_CONTROLLER);
-        
-        hydraulic2->setLocation(ECULocation{
-            "Hydraulic Manifold Bay",
-            "Manifold Mount",
-            0.0, 0.0, 0.30
+        // 3. Run control loops, each at its own rate
+        auto& loops = controllers_.getLoops();
+        for (size_t i = 0; i < loops.size(); i++) {
+            bindControlLoop(i);
+        }
+
+        // 4. Update actuators
+        for (size_t i = 0; i < actuators_.size(); i++) {
+            auto actuator = actuators_[i];
+            executor_->addTask(actuatorRates_[i], TaskStage::ACTUATOR_UPDATE,
+                               actuator->getComponentName(),
+                               [this, i, actuator]() {
+                                   actuator->update();
+                                   sampling_.actuatorCommands[i] = actuator->getCommand();
+                                   sampling_.actuatorFeedback[i] = actuator->getFeedback();
+                                   sampling_.actuatorSampleNs[i] = cycleTimestampNs_;
+                               });
+        }
+
+        // One command frame per actuator node, queued ahead of the comm tasks
+        setupActuatorOutput();
+        setupTimeSync();
+
+        // 5. Handle communication (on the I/O thread when pipelined)
+        for (size_t i = 0; i < commInterfaces_.size() && !pipelined_; i++) {
+            auto comm = commInterfaces_[i];
+            executor_->addTask(commRates_[i], TaskStage::COMMUNICATION,
+                               comm->getComponentName(),
+                               [this, comm, i]() {
+                                   comm->update();
+                                   processCommunication(*comm, i);
+                               });
+        }
+
+        // Everything sampled this cycle to the recorder (on the logging
+        // thread when pipelined; a full queue drops the cycle)
+        executor_->addTask(0.0, TaskStage::HOUSEKEEPING, "Recorder", [this]() {
+            if (pipelined_) {
+                recordQueue_->tryPush(sampling_);
+            } else {
+                recordSamples(sampling_);
+            }
         });
-        
-        hydraulic2->setCommunication(CommunicationInfo{
-            "Modbus RTU", "192.168.1.53", 9600, 4, 5.0
+
+        // Shared-memory state bus for the local dashboards
+        if (stateBusRateHz_ > 0.0) setupStateBus();
+
+        // On-demand ECU reports (see requestECUReports)
+        executor_->addTask(1.0, TaskStage::HOUSEKEEPING, "ECUReports",
+                           [this]() { serviceECUReports(); });
+
+        // Periodic status logging (1 Hz)
+        executor_->addTask(1.0, TaskStage::HOUSEKEEPING, "StatusLog", [this]() {
+            char text[LogRecord::TEXT_SIZE];
+            // Check if all critical ECUs are online
+            if (!ecuManager_->areAllECUsOnline()) {
+                StatusWriter line(text, sizeof(text));
+                line.text("WARNING: Not all ECUs online - ").status(*ecuManager_);
+                if (ecuWarning_.allow(messageKey(line.view()), cycleTimestampNs_)) {
+                    uint32_t repeats = ecuWarning_.takeSuppressed();
+                    if (repeats > 0) line.text(" (repeated ").number(repeats).text(" times)");
+                    logger_->log(line.view());
+                }
+                // Could implement degraded mode here
+            } else if (ecuWarning_.clear()) {
+                logger_->log("All ECUs online");
+            }
+            for (size_t i = 0; i < sensors_.size(); i++) {
+                StatusWriter line(text, sizeof(text));
+                line.text(sensors_[i]->getComponentName()).text(": ")
+                    .fixed(snapshot_.sensorValues[i]).text(" ").text(sensors_[i]->getUnits())
+                    .text(snapshot_.sensorHealthy[i] ? "" : " (unhealthy)");
+                logger_->log(line.view());
+            }
         });
-        
-        hydraulic2->addControlledDevice(ControlledDevice{
-            "Steering Cylinder Left", "Hydraulic Cylinder", "Proportional Valve", 3
+
+        logger_->log(executor_->getStatus());
+    }
+
+    // The tool's ECU layout (set before initialize(); default digem-pi5)
+    void setTopology(const Topology& topology) {
+        topology_ = &topology;
+    }
+
+    const Topology& getTopology() const { return *topology_; }
+
+    // Base loop rate (set before initialize()) and realtime options
+    void setLoopRate(double rateHz) {
+        loopRateHz_ = rateHz;
+    }
+
+    void setRealtimeConfig(const RealtimeConfig& config) {
+        realtimeConfig_ = config;
+    }
+
+    // Downlink format: keyframes + deltas (default) or a full frame every
+    // time (set before initialize())
+    void setTelemetryCompression(bool enabled) {
+        telemetryCompressed_ = enabled;
+    }
+
+    // Downlink resolution, deadband and rate cap for a sensor or actuator
+    // (set before initialize()). Actuators keep the fixed 0.01 resolution
+    // and take only the deadband and rate cap.
+    void setTelemetryChannel(const std::string& componentName,
+                             const TelemetryChannelConfig& config) {
+        telemetryChannels_[componentName] = config;
+    }
+
+    // Feed an ECU's watchdog from another component's last reply time
+    // (monotonic, 0 = none yet), read on each of its ECU_HEALTH polls; set
+    // before initialize()
+    void setECUReplySource(const std::string& ecuId, std::function<int64_t()> lastReplyNs) {
+        ecuReplySources_[ecuId] = std::move(lastReplyNs);
+    }
+
+    // initialize() timeout for one component (set before initialize())
+    void setStartupTimeout(const std::string& componentName, int timeoutMs) {
+        startupTimeouts_[componentName] = timeoutMs;
+    }
+
+    // Write the ECU reports in the background (any thread). Picked up by
+    // the ECUReports task within a second, or once a running report is
+    // done; a later request before then replaces the directory.
+    void requestECUReports(const std::string& directory = "./ecu_reports/") {
+        std::lock_guard<std::mutex> lock(reportRequestMutex_);
+        requestedReportDirectory_ = directory;
+        reportsRequested_ = true;
+    }
+
+    // HOUSEKEEPING: copies the ECUs on the control thread (no locking
+    // against updates) and formats/writes them on a background thread
+    void serviceECUReports() {
+        if (reportThread_.joinable() && !reportsRunning_) {
+            reportThread_.join();
+            logger_->log("ECU reports generated in " + reportDirectory_);
+        }
+        if (!reportsRequested_ || reportsRunning_) return;
+        {
+            std::lock_guard<std::mutex> lock(reportRequestMutex_);
+            reportDirectory_ = requestedReportDirectory_;
+            reportsRequested_ = false;
+        }
+
+        auto copy = std::make_shared<ECUManager>(ecuManager_->getSystemName(), nullptr);
+        for (const auto& ecu : ecuManager_->getAllECUs()) {
+            copy->addECU(std::make_shared<ECU>(*ecu));
+        }
+        reportsRunning_ = true;
+        reportThread_ = std::thread([this, copy, directory = reportDirectory_]() {
+            copy->generateDetailedReports(directory);
+            reportsRunning_ = false;
         });
-        hydraulic2->addControlledDevice(ControlledDevice{
-            "Steering Cylinder Right", "Hydraulic Cylinder", "Proportional Valve", 4
+    }
+
+    // Drive an actuator from a channel of an actuator node (before initialize())
+    void addActuatorOutput(const ActuatorOutputConfig& config) {
+        actuatorOutputConfigs_.push_back(config);
+    }
+
+    // The tool's outputs from its table (Topology::outputs)
+    void addActuatorOutputs(std::span<const OutputSpec> outputs) {
+        for (const OutputSpec& output : outputs) {
+            addActuatorOutput({std::string(output.actuator), std::string(output.ecu),
+                               std::string(output.device)});
+        }
+    }
+
+    // Before any hardware comes up: every output needs its actuator, a
+    // device on a node in the topology, that node's link and a channel
+    // of its own. An unbound output would leave its actuator undriven.
+    bool checkActuatorOutputs() {
+        bool ok = true;
+        for (size_t i = 0; i < actuatorOutputConfigs_.size(); i++) {
+            const auto& config = actuatorOutputConfigs_[i];
+            const ECUSpec* ecu = findECU(*topology_, config.ecuId);
+            int channel = deviceChannel(*topology_, config.ecuId, config.device);
+            bool duplicate = false;
+            for (size_t j = 0; j < i; j++) {
+                duplicate |= actuatorOutputConfigs_[j].ecuId == config.ecuId &&
+                             deviceChannel(*topology_, config.ecuId,
+                                           actuatorOutputConfigs_[j].device) == channel;
+            }
+
+            const char* problem = nullptr;
+            if (std::none_of(actuators_.begin(), actuators_.end(), [&config](const auto& a) {
+                    return a->getComponentName() == config.actuator;
+                })) {
+                problem = "no such actuator";
+            } else if (!ecu || channel < 0) {
+                problem = "device not in the topology";
+            } else if (ecu->link < 0 || static_cast<size_t>(ecu->link) >= commInterfaces_.size()) {
+                problem = "no link to the node";
+            } else if (channel >= static_cast<int>(ACTUATOR_FRAME_CHANNELS) || duplicate) {
+                problem = "channel out of range or already bound";
+            }
+            if (problem) {
+                logger_->log("CRITICAL: Actuator output " + config.actuator + " -> " +
+                             config.ecuId + " / " + config.device + " not bound: " + problem);
+                ok = false;
+            }
+        }
+        return ok;
+    }
+
+    // Bind each configured output to its node's comm interface (via
+    // commECUs_) and the ECU's channel number for the device
+    void setupActuatorOutput() {
+        for (const auto& config : actuatorOutputConfigs_) {
+            auto actuator = std::find_if(actuators_.begin(), actuators_.end(),
+                                         [&config](const auto& a) {
+                                             return a->getComponentName() == config.actuator;
+                                         });
+            ECUHandle handle = topologyHandle(*topology_, config.ecuId);
+            auto comm = std::find(commECUs_.begin(), commECUs_.end(), handle);
+            int channel = deviceChannel(*topology_, config.ecuId, config.device);
+
+            bool bound = false;
+            if (actuator != actuators_.end() && handle != INVALID_ECU_HANDLE &&
+                comm != commECUs_.end()) {
+                size_t link = static_cast<size_t>(comm - commECUs_.begin());
+                size_t node = actuatorOutput_.addNode(config.ecuId, controlLink(link));
+                bound = actuatorOutput_.bind(node, channel, *actuator);
+            }
+            logger_->log(bound ? "Actuator output: " + config.actuator + " -> " + config.ecuId +
+                                     " channel " + std::to_string(channel)
+                               : "WARNING: Actuator output " + config.actuator + " -> " +
+                                     config.ecuId + " / " + config.device + " not bound");
+        }
+
+        if (actuatorOutput_.getBindingCount() > 0) {
+            executor_->addTask(ACTUATOR_OUTPUT_RATE_HZ, TaskStage::COMMUNICATION, "ActuatorOutput",
+                               [this]() { actuatorOutput_.flush(cycleTimestampNs_); });
+        }
+    }
+
+    // What the control thread sends on for a link: the link itself, or a
+    // QueuedLink to the I/O thread when pipelined. One per link, so every
+    // control-side sender shares it.
+    std::shared_ptr<ICommunicationInterface> controlLink(size_t link) {
+        auto& output = controlLinks_[link];
+        if (!output) {
+            output = pipelined_ ? std::make_shared<QueuedLink>(commInterfaces_[link],
+                                                               static_cast<uint32_t>(link),
+                                                               *outboundFrames_)
+                                : commInterfaces_[link];
+        }
+        return output;
+    }
+
+    // TIME_PINGs to every node link; the pongs come back through
+    // dispatchMessage() into that link's NodeClockSync
+    void setupTimeSync() {
+        for (size_t link = 0; link < commECUs_.size(); link++) {
+            if (commECUs_[link] == INVALID_ECU_HANDLE) continue;
+            auto output = controlLink(link);
+            executor_->addTask(TIME_SYNC_RATE_HZ, TaskStage::COMMUNICATION,
+                               "TimeSync_" + ecuManager_->ecuAt(commECUs_[link]).getECUID(),
+                               [this, link, output]() {
+                                   uint8_t ping[TIME_PING_PACKET_SIZE];
+                                   size_t length = clockSync_[link].makePing(clockNowNs(), ping);
+                                   output->send(std::span<const uint8_t>(ping, length));
+                               });
+        }
+    }
+
+    // Now on the cycle's clock: monotonic, or the simulator's virtual
+    // clock, which only moves between cycles
+    int64_t clockNowNs() const {
+        return virtualClock_ ? cycleTimestampNs_ : monotonicNowNs();
+    }
+
+    // A sensor's own sample time, else the time it was read
+    static int64_t sampleTimeNs(const ISensor& sensor, int64_t readNs) {
+        int64_t sampleNs = sensor.getSampleTimeNs();
+        return sampleNs > 0 ? sampleNs : readNs;
+    }
+
+    // Run the links on an I/O thread and the recorder and downlink on a
+    // logging thread next to the control thread (set before initialize();
+    // see pipeline.hpp). The I/O heartbeat is critical: the interlock
+    // latches if it stalls, since neither actuator frames nor an e-stop
+    // would get through. A stalled logging thread is only reported.
+    void setPipeline(const PipelineThreadConfig& io, const PipelineThreadConfig& logging) {
+        pipelined_ = true;
+        ioConfig_ = io;
+        loggingConfig_ = logging;
+    }
+
+    // Workers, queues and their tasks; the control thread's side is added
+    // in setupRateGroups()
+    void setupPipeline() {
+        ioThread_ = std::make_unique<PipelineWorker>("I/O", ioConfig_);
+        loggingThread_ = std::make_unique<PipelineWorker>("Logging", loggingConfig_);
+        inboundFrames_ = std::make_unique<LinkQueue>();
+        outboundFrames_ = std::make_unique<LinkQueue>();
+        telemetryFrames_ = std::make_unique<LinkQueue>();
+        recordQueue_ = std::make_unique<SnapshotQueue>();
+
+        // I/O: queued frames go out first, then each link is serviced at its rate
+        RateGroupExecutor& io = ioThread_->getExecutor();
+        io.addTask(0.0, TaskStage::COMMUNICATION, "Outbound", [this]() {
+            sendQueued(*outboundFrames_);
+            sendQueued(*telemetryFrames_);
         });
-        hydraulic2->addControlledDevice(ControlledDevice{
-            "Steering Position Sensor", "Sensor", "Analog 0-10V", 2
+        for (size_t i = 0; i < commInterfaces_.size(); i++) {
+            auto comm = commInterfaces_[i];
+            io.addTask(commRates_[i], TaskStage::COMMUNICATION, comm->getComponentName(),
+                       [this, comm, i]() {
+                           comm->update();
+                           for (int n = 0; n < MAX_MESSAGES_PER_CYCLE; n++) {
+                               size_t length = comm->receiveInto(ioRxBuffer_);
+                               if (length == 0) break;
+                               int64_t receiveNs = comm->getLastReceiveNs();
+                               pushLinkFrame(*inboundFrames_, static_cast<uint32_t>(i),
+                                             std::span<const uint8_t>(ioRxBuffer_.data(), length),
+                                             receiveNs > 0 ? receiveNs : monotonicNowNs());
+                           }
+                       });
+        }
+
+        // Logging: record every queued cycle, then encode each downlink's
+        // frame from the latest one
+        RateGroupExecutor& logging = loggingThread_->getExecutor();
+        logging.addTask(0.0, TaskStage::SNAPSHOT, "Recorder", [this]() {
+            SystemSnapshot* snapshot;
+            while ((snapshot = recordQueue_->front()) != nullptr) {
+                recordSamples(*snapshot);
+                loggingSnapshot_ = *snapshot;
+                recordQueue_->pop();
+            }
         });
-        
-        ecuManager_->addECU(hydraulic2);
+        for (size_t i = 0; i < commInterfaces_.size(); i++) {
+            if (!commDownlinks_[i]) continue;
+            logging.addTask(commRates_[i], TaskStage::COMMUNICATION,
+                            commInterfaces_[i]->getComponentName(), [this, i]() {
+                                if (loggingSnapshot_.timestampNs == 0) return;   // None yet
+                                pushLinkFrame(*telemetryFrames_, static_cast<uint32_t>(i),
+                                              encodeTelemetry(loggingSnapshot_, i));
+                            });
+        }
 
-        logger_->log("ECU architecture setup complete - " + 
-                    std::to_string(ecuManager_->getTotalECUCount()) + " ECUs configured");
+        safetyMonitor_->watchHeartbeat(ioThread_->getName(), ioThread_->getHeartbeat(),
+                                       ioConfig_.heartbeatTimeoutNs, true);
+        safetyMonitor_->watchHeartbeat(loggingThread_->getName(), loggingThread_->getHeartbeat(),
+                                       loggingConfig_.heartbeatTimeoutNs, false);
+        // Only a separate safety thread can see the control thread stall
+        if (safetyRateHz_ > 0.0) {
+            safetyMonitor_->watchHeartbeat(
+                "Control", controlHeartbeat_,
+                static_cast<int64_t>(CONTROL_HEARTBEAT_CYCLES * 1e9 / loopRateHz_), true);
+        }
+        logger_->log("Pipeline: " + ioThread_->getStatus() + ", " + loggingThread_->getStatus());
     }
 
-    void addSensor(std::shared_ptr<ISensor> sensor) {
-        sensors_.push_back(sensor);
+    void startPipeline() {
+        if (!pipelined_) return;
+        for (auto* worker : {ioThread_.get(), loggingThread_.get()}) {
+            if (!worker->start()) {
+                logger_->log("WARNING: Realtime settings for the " + worker->getName() +
+                             " thread could not be applied");
+            }
+        }
     }
 
-    void addActuator(std::shared_ptr<IActuator> actuator) {
-        actuators_.push_back(actuator);
+    // Control thread: when the loop exits, from stop() and the destructor
+    void stopPipeline() {
+        if (!pipelined_) return;
+        for (auto* worker : {ioThread_.get(), loggingThread_.get()}) {
+            if (worker && worker->isRunning()) {
+                worker->stop();
+                if (logger_) logger_->log(worker->getStatus());
+            }
+        }
     }
 
-    void addCommunication(std::shared_ptr<ICommunicationInterface> comm) {
-        commInterfaces_.push_back(comm);
+    // I/O thread (or any thread once it stopped): the real sends
+    void sendQueued(LinkQueue& queue) {
+        LinkFrame* frame;
+        while ((frame = queue.front()) != nullptr) {
+            if (frame->link < commInterfaces_.size()) {
+                commInterfaces_[frame->link]->send(
+                    std::span<const uint8_t>(frame->frame.data, frame->frame.length));
+            }
+            queue.pop();
+        }
+    }
+
+    // COMMAND stage: what the links received, handled as processCommunication would
+    void drainInbound() {
+        LinkFrame* frame;
+        while ((frame = inboundFrames_->front()) != nullptr) {
+            dispatchMessage(frame->link, frame->frame.data, frame->frame.length,
+                            frame->frame.timestampNs);
+            ECUHandle sourceECU = frame->link < commECUs_.size() ? commECUs_[frame->link]
+                                                                 : INVALID_ECU_HANDLE;
+            if (sourceECU != INVALID_ECU_HANDLE) {
+                ecuManager_->markCommunication(sourceECU, frame->frame.timestampNs);
+            }
+            inboundFrames_->pop();
+        }
+    }
+
+    // Samples new since the last snapshot (slow groups skip cycles, node
+    // samples arrive when they arrive), each at the time it was taken
+    void recordSamples(const SystemSnapshot& snapshot) {
+        for (size_t i = 0; i < snapshot.sensorCount; i++) {
+            if (snapshot.sensorSampleNs[i] != sensorRecordedNs_[i]) {
+                recorder_->record(sensorChannels_[i], snapshot.sensorValues[i],
+                                  snapshot.sensorSampleNs[i]);
+                sensorRecordedNs_[i] = snapshot.sensorSampleNs[i];
+            }
+        }
+        for (size_t i = 0; i < snapshot.actuatorCount; i++) {
+            if (snapshot.actuatorSampleNs[i] != actuatorRecordedNs_[i]) {
+                recorder_->record(actuatorChannels_[i], snapshot.actuatorCommands[i],
+                                  snapshot.actuatorSampleNs[i]);
+                actuatorRecordedNs_[i] = snapshot.actuatorSampleNs[i];
+            }
+        }
+    }
+
+    // Dashboard state bus publish rate (set before initialize(), 0 = off)
+    void setStateBusRate(double rateHz) {
+        stateBusRateHz_ = rateHz;
+    }
+
+    // Register before initialize(); names refer to added components
+    bool addControlLoop(const ControlLoopConfig& config) {
+        return controllers_.addLoop(config);
+    }
+
+    void setAutoDepth(bool enabled, double setpoint) {
+        controlState_.autoDepthControl = enabled;
+        controlState_.depthSetpoint = setpoint;
+        setLoopMode(CONTROL_LOOP_DEPTH, enabled, setpoint);
+    }
+
+    void setAutoHeading(bool enabled, double setpoint) {
+        controlState_.autoHeadingControl = enabled;
+        controlState_.headingSetpoint = setpoint;
+        setLoopMode(CONTROL_LOOP_HEADING, enabled, setpoint);
+    }
+
+    void setLoopMode(const std::string& name, bool enabled, double setpoint) {
+        ControlLoop* loop = controllers_.find(name);
+        if (!loop) return;
+        double current = loop->bound ? actuators_[loop->actuatorIndex]->getCommand() : 0.0;
+        double measurement = loop->bound && snapshot_.sensorHealthy[loop->sensorIndex]
+                                 ? loopMeasurement(*loop) : NAN;
+        controllers_.setSetpoint(name, setpoint);
+        controllers_.setEnabled(name, enabled, current, measurement);
+        if (!enabled && loop->bound) {
+            actuators_[loop->actuatorIndex]->setCommand(0.0);
+        }
+    }
+
+    bool resetSafetyInterlock() {
+        bool cleared = safetyMonitor_->resetInterlock();
+        logger_->log(cleared ? "Safety interlock reset"
+                             : "Safety interlock reset refused: limits still violated");
+        return cleared;
+    }
+
+    // All channels of a multi-axis sensor in one call
+    void readSensorVector(size_t index) {
+        size_t count = sampling_.vectorCount[index];
+        if (count > 0) {
+            sensors_[index]->readVector(
+                std::span<double>(sampling_.vectorValues + sampling_.vectorOffset[index], count));
+        }
     }
 
-    void addSafetyLimit(const std::string& name,
-                       std::function<double()> getValue,
-                       double minVal, double maxVal) {
-        safetyMonitor_->addLimit(name, getValue, minVal, maxVal);
+    void publishSnapshot() {
+        sampling_.cycle = executor_->getCycleCount();
+        sampling_.timestampNs = cycleTimestampNs_;
+        sampling_.statusFlags = statusFlags();
+        std::span<const uint8_t> ecuStatus = ecuManager_->getStatusCodes();
+        sampling_.ecuCount = static_cast<uint32_t>(std::min(ecuStatus.size(), SNAPSHOT_MAX_ECUS));
+        std::copy_n(ecuStatus.data(), sampling_.ecuCount, sampling_.ecuStatus);
+        snapshot_ = sampling_;
+        publishedSnapshot_.write(snapshot_);
+    }
+
+    // Latest snapshot for readers on other threads (lock-free)
+    const SnapshotBuffer& getSnapshotBuffer() const { return publishedSnapshot_; }
+    // This cycle's frozen snapshot (control thread only)
+    const SystemSnapshot& getSnapshot() const { return snapshot_; }
+    const SafetyMonitor& getSafetyMonitor() const { return *safetyMonitor_; }
+
+    // One control cycle, without the scheduler (benchmarks, simulation)
+    void runCycle() {
+        cycleTimestampNs_ = monotonicNowNs();
+        virtualClock_ = false;
+        executor_->runCycle();
+    }
+
+    // One cycle at an explicit time (virtual clock, see simulation.hpp)
+    void runCycle(int64_t timestampNs) {
+        cycleTimestampNs_ = timestampNs;
+        virtualClock_ = true;
+        executor_->runCycle();
     }
 
     void controlLoop() {
-        auto lastTime = std::chrono::steady_clock::now();
-
-        while (systemRunning_) {
-            auto currentTime = std::chrono::steady_clock::now();
-            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-                currentTime - lastTime);
-
-            if (elapsed >= loopPeriod_) {
-                lastTime = currentTime;
-
-                // 0. Update ECU health monitoring
-                ecuManager_->update();
-                
-                // Check if all critical ECUs are online
-                if (!ecuManager_->areAllECUsOnline()) {
-                    logger_->log("WARNING: Not all ECUs online - " + 
-                                ecuManager_->getStatus());
-                    // Could implement degraded mode here
-                }
+        scheduler_ = std::make_unique<PeriodicScheduler>(loopRateHz_, realtimeConfig_);
+        scheduler_->initialize();
 
-                // 1. Read all sensors
-                for (auto& sensor : sensors_) {
-                    sensor->update();
-                    double value = sensor->readValue();
-                    
-                    // Log periodically (every 10th iteration)
-                    static int counter = 0;
-                    if (++counter % 10 == 0) {
-                        logger_->logComponentStatus(*sensor);
-                    }
-                }
+        if (realtimeRequested(realtimeConfig_) && !scheduler_->isRealtime()) {
+            logger_->log("WARNING: Realtime scheduling settings could not be applied");
+        }
+        startTimestampNs_ = monotonicNowNs();
+        startPipeline();
 
-                // 2. Check safety interlocks
-                safetyMonitor_->update();
-                if (!safetyMonitor_->isSystemSafe()) {
-                    logger_->log("SAFETY FAULT: " + 
-                               safetyMonitor_->getLastViolation());
-                }
+        controlHeartbeat_.beat(monotonicNowNs());
+        while (systemRunning_ && !stopRequested_.load(std::memory_order_relaxed)) {
+            if (!scheduler_->waitForNextCycle()) break;
+            runCycle();
+            controlHeartbeat_.beat(monotonicNowNs());
+        }
 
-                // 3. Run control algorithms
-                runControlAlgorithms();
+        stopPipeline();
+        scheduler_->shutdown();
+        logger_->log(scheduler_->getStatus());
+        logger_->log("Cycle timing: " + executor_->getCycleTiming().summary());
+        logger_->log(actuatorOutput_.getStatus());
+        logger_->log(surfaceCommands_.getStatus());
+        for (size_t i = 0; i < telemetryDeltas_.size(); i++) {
+            if (!commDownlinks_[i]) continue;
+            logger_->log(commInterfaces_[i]->getComponentName() + ": " +
+                         telemetryDeltas_[i].getStatus());
+        }
+        for (const std::string& line : clockSyncStatus()) logger_->log(line);
+    }
 
-                // 4. Update actuators
-                for (auto& actuator : actuators_) {
-                    actuator->update();
-                }
+    // "<ECU> clock: ..." for every node link
+    std::vector<std::string> clockSyncStatus() const {
+        std::vector<std::string> lines;
+        for (size_t i = 0; i < clockSync_.size() && i < commECUs_.size(); i++) {
+            if (commECUs_[i] == INVALID_ECU_HANDLE) continue;
+            lines.push_back(ecuManager_->ecuAt(commECUs_[i]).getECUID() + " clock: " +
+                            clockSync_[i].getStatus());
+        }
+        return lines;
+    }
 
-                // 5. Handle communication
-                for (auto& comm : commInterfaces_) {
-                    comm->update();
-                    processCommunication(comm);
-                }
-                
-                // 6. Update communication timestamps for ECUs
-                updateECUCommunicationStatus();
+    const NodeClockSync* getClockSync(size_t link) const {
+        return link < clockSync_.size() ? &clockSync_[link] : nullptr;
+    }
+
+    // Resolve a loop's sensor/actuator names and schedule it
+    void bindControlLoop(size_t index) {
+        ControlLoop& loop = controllers_.getLoops()[index];
+        auto byName = [](const auto& components, const std::string& name) {
+            for (size_t i = 0; i < components.size(); i++) {
+                if (components[i]->getComponentName() == name) return i;
             }
+            return components.size();
+        };
+        size_t sensor = byName(sensors_, loop.config.sensor);
+        size_t actuator = byName(actuators_, loop.config.actuator);
+        bool channelOk = sensor < sensors_.size() &&
+                         (loop.config.channel < 0 ||
+                          static_cast<size_t>(loop.config.channel) < sampling_.vectorCount[sensor]);
+        if (!channelOk || actuator == actuators_.size()) {
+            logger_->log("WARNING: Control loop " + loop.config.name + " not bound (" +
+                         loop.config.sensor + " -> " + loop.config.actuator + ")");
+            return;
+        }
+
+        double rateHz = executor_->addTask(loop.config.rateHz, TaskStage::CONTROL,
+                                           loop.config.name,
+                                           [this, index]() { runControlLoop(index); });
+        controllers_.bind(loop, sensor, actuator, rateHz);
+        logger_->log("Control loop " + loop.config.name + " at " +
+                     std::to_string(rateHz) + " Hz");
+    }
 
-            // Sleep briefly to avoid busy-waiting
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    void runControlLoop(size_t index) {
+        ControlLoop& loop = controllers_.getLoops()[index];
+        if (!loop.enabled) return;
+
+        auto& actuator = actuators_[loop.actuatorIndex];
+        // Actuators stay at zero until the interlock is reset; a lost
+        // sensor also stops the loop until it recovers
+        if (safetyMonitor_->isInterlockLatched() || !snapshot_.sensorHealthy[loop.sensorIndex]) {
+            loop.pid.reset();
+            actuator->setCommand(0.0);
+            return;
         }
+
+        loop.output = loop.pid.step(loop.setpoint, loopMeasurement(loop));
+        actuator->setCommand(loop.output);
     }
 
-    void updateECUCommunicationStatus() {
-        // Update timestamps when we successfully communicate with ECUs
-        // This prevents watchdog timeouts
-        
-        // Example: Update Teensy sensor node if communication successful
-        auto teensySensor = ecuManager_->getECU("ECU02");
-        if (teensySensor && !commInterfaces_.empty()) {
-            // If we got data from this interface, update timestamp
-            teensySensor->updateCommunicationTimestamp();
+    // A bound loop's input from this cycle's snapshot
+    double loopMeasurement(const ControlLoop& loop) const {
+        size_t sensor = loop.sensorIndex;
+        return loop.config.channel < 0
+            ? snapshot_.sensorValues[sensor]
+            : snapshot_.vectorValues[snapshot_.vectorOffset[sensor] + loop.config.channel];
+    }
+
+    void processCommunication(ICommunicationInterface& comm, size_t index) {
+        ECUHandle sourceECU = commECUs_[index];
+        // Receive commands from surface or Teensy (bounded per cycle). A
+        // link that stamps on receive gives the arrival time, else it is
+        // now; the watchdog stays on the monotonic clock in simulation too
+        int received = 0;
+        int64_t stampedNs = 0;
+        for (; received < MAX_MESSAGES_PER_CYCLE; received++) {
+            size_t length = comm.receiveInto(rxBuffer_);
+            if (length == 0) break;
+            stampedNs = comm.getLastReceiveNs();
+            dispatchMessage(index, rxBuffer_.data(), length,
+                            stampedNs > 0 ? stampedNs : clockNowNs());
         }
-        
-        auto teensyActuator = ecuManager_->getECU("ECU03");
-        if (teensyActuator && commInterfaces_.size() > 1) {
-            teensyActuator->updateCommunicationTimestamp();
-        }
-    }
-
-    void runControlAlgorithms() {
-        // Simple PID-style depth control example
-        if (controlState_.autoDepthControl) {
-            // Get depth sensor (assuming first pressure sensor)
-            if (!sensors_.empty()) {
-                double currentDepth = sensors_[0]->readValue();
-                double error = controlState_.depthSetpoint - currentDepth;
-                
-                // Simple proportional control
-                double thrustCommand = error * 0.5; // Kp = 0.5
-                
-                // Apply to vertical thrusters (example)
-                if (!actuators_.empty()) {
-                    actuators_[0]->setCommand(thrustCommand);
-                }
+
+        // A packet from the node is its watchdog reply
+        if (received > 0 && sourceECU != INVALID_ECU_HANDLE) {
+            ecuManager_->markCommunication(sourceECU,
+                                           stampedNs > 0 ? stampedNs : monotonicNowNs());
+        }
+
+        // Send telemetry
+        if (commDownlinks_[index]) comm.send(encodeTelemetry(snapshot_, index));
+    }
+
+    // Downlink frame for one link: its delta encoder, or the shared full
+    // frame. Runs on the logging thread when pipelined.
+    std::span<const uint8_t> encodeTelemetry(const SystemSnapshot& snapshot, size_t index) {
+        if (telemetryDeltas_.empty()) return buildTelemetryPacket(snapshot);
+        if (keyframeRequested_.exchange(false, std::memory_order_acquire)) {
+            for (auto& encoder : telemetryDeltas_) encoder.requestKeyframe();
+        }
+        return telemetryDeltas_[index].encode(telemetryInput(snapshot));
+    }
+
+    // One message from a link, received at receiveNs (on the cycle's clock)
+    void dispatchMessage(size_t link, const uint8_t* data, size_t length, int64_t receiveNs) {
+        QuaternionSample quaternion;
+        if (parseImuQuaternion(data, length, quaternion)) {
+            if (imuSensor_) {
+                imuSensor_->ingestQuaternion(quaternion, nodeSampleNs(link, quaternion, receiveNs));
             }
+            return;
+        }
+        TimePong pong;
+        if (parseTimePong(data, length, pong)) {
+            if (link < clockSync_.size()) clockSync_[link].handlePong(pong, receiveNs);
+            return;
+        }
+        if (SurfaceCommandIntake::isCommandPacket(data, length)) {
+            surfaceCommands_.parse(data, length);
+            return;
+        }
+        logger_->log("Received data: " + std::to_string(length) + " bytes");
+    }
+
+    // When a node took a sample: its own timestamp on the Pi clock once
+    // the link is synced, else when the packet arrived
+    int64_t nodeSampleNs(size_t link, const QuaternionSample& sample, int64_t receiveNs) const {
+        if (!sample.timed || link >= clockSync_.size() || !clockSync_[link].isSynced()) {
+            return receiveNs;
         }
+        return std::min(clockSync_[link].toPiNs(sample.deviceUs), receiveNs);
     }
 
-    void processCommunication(std::shared_ptr<ICommunicationInterface> comm) {
-        // Receive commands from surface or Teensy
-        auto data = comm->receive();
-        if (!data.empty()) {
-            // Parse and execute commands
-            logger_->log("Received data: " + std::to_string(data.size()) + 
-                        " bytes");
+    void applySurfaceCommand(const SurfaceCommand& command) {
+        switch (static_cast<SurfaceOpcode>(command.opcode)) {
+            case SurfaceOpcode::EMERGENCY_STOP:
+                // Latch now so this cycle's SAFETY stage already zeroes every actuator
+                safetyMonitor_->emergencyStop();
+                safetyMonitor_->applyInterlock();
+                logger_->log("EMERGENCY STOP from surface (packet " +
+                             std::to_string(command.sequence) + ")");
+                return;
+            case SurfaceOpcode::RESET_INTERLOCK:
+                resetSafetyInterlock();
+                return;
+            case SurfaceOpcode::SET_AUTO_DEPTH:
+            case SurfaceOpcode::SET_AUTO_HEADING: {
+                float setpoint = command.getFloat(1);
+                if (command.length < 5 || !std::isfinite(setpoint)) break;
+                if (command.opcode == static_cast<uint8_t>(SurfaceOpcode::SET_AUTO_DEPTH)) {
+                    setAutoDepth(command.payload[0] != 0, setpoint);
+                } else {
+                    setAutoHeading(command.payload[0] != 0, setpoint);
+                }
+                return;
+            }
+            case SurfaceOpcode::SET_LOOP_GAINS: {
+                if (command.length < 13 || command.payload[0] > 1) break;
+                const std::string& name = command.payload[0] == 0 ? CONTROL_LOOP_DEPTH
+                                                                  : CONTROL_LOOP_HEADING;
+                float kp = command.getFloat(1), ki = command.getFloat(5), kd = command.getFloat(9);
+                if (!std::isfinite(kp) || !std::isfinite(ki) || !std::isfinite(kd)) break;
+                if (controllers_.setGains(name, kp, ki, kd)) {
+                    logger_->log("Control loop " + name + " gains set from surface: kp=" +
+                                 std::to_string(kp) + " ki=" + std::to_string(ki) +
+                                 " kd=" + std::to_string(kd));
+                }
+                return;
+            }
+            case SurfaceOpcode::REQUEST_KEYFRAME:
+                keyframeRequested_.store(true, std::memory_order_release);
+                return;
+            case SurfaceOpcode::OPERATOR_NOTE:
+                logger_->log("Operator: " + std::string(reinterpret_cast<const char*>(command.payload),
+                                                        command.length));
+                return;
         }
+        logger_->log("WARNING: Ignored surface command " + std::to_string(command.opcode) +
+                     " (packet " + std::to_string(command.sequence) + ")");
+    }
 
-        // Send telemetry
-        std::vector<uint8_t> telemetry = buildTelemetryPacket();
-        comm->send(telemetry);
+    // TELEMETRY_FLAG_* for the uplink frame and the state bus
+    uint8_t statusFlags() const {
+        uint8_t flags = 0;
+        if (!safetyMonitor_->isSystemSafe()) flags |= TELEMETRY_FLAG_SAFETY_FAULT;
+        if (controlState_.autoDepthControl) flags |= TELEMETRY_FLAG_AUTO_DEPTH;
+        if (controlState_.autoHeadingControl) flags |= TELEMETRY_FLAG_AUTO_HEADING;
+        if (!ecuManager_->areAllECUsOnline()) flags |= TELEMETRY_FLAG_ECUS_DEGRADED;
+        return flags;
     }
 
-    std::vector<uint8_t> buildTelemetryPacket() {
-        std::vector<uint8_t> packet;
-        
-        // Build packet with sensor data, actuator states, etc.
-        // Format: [Header][Sensor1][Sensor2]...[Actuator1]...[Checksum]
-        
-        return packet;
+    // Serialize the full telemetry frame at most once per snapshot; every
+    // interface sending the same cycle gets a view of the same buffer
+    std::span<const uint8_t> buildTelemetryPacket(const SystemSnapshot& snapshot) {
+        if (snapshot.cycle == telemetryCycle_) {
+            return telemetryEncoder_.getFrame();
+        }
+        telemetryCycle_ = snapshot.cycle;
+        return telemetryEncoder_.encode(telemetryInput(snapshot));
+    }
+
+    TelemetryInput telemetryInput(const SystemSnapshot& snapshot) const {
+        return TelemetryInput{
+            static_cast<uint32_t>((snapshot.timestampNs - startTimestampNs_) / 1000000),
+            snapshot.statusFlags,
+            snapshot.sensorValues, snapshot.sensorHealthy, snapshot.sensorCount,
+            snapshot.actuatorCommands, snapshot.actuatorFeedback, snapshot.actuatorCount,
+            snapshot.ecuStatus, snapshot.ecuCount
+        };
     }
 
     void start() {
@@ -455,9 +1301,18 @@ public:
         controlLoop();
     }
 
+    // Ends the control loop at its next cycle (or before its first, if
+    // start() has not run yet); start() then returns and the caller runs
+    // stop(). Async-signal-safe: one lock-free store.
+    void requestStop() {
+        stopRequested_.store(true, std::memory_order_relaxed);
+    }
+
+    // Control thread, after start() returned (or before it was called)
     void stop() {
         systemRunning_ = false;
         logger_->log("System stopping");
+        stopPipeline();
         
         // Shutdown ECU manager first (logs all ECU shutdowns)
         if (ecuManager_) {
@@ -468,6 +1323,8 @@ public:
         for (auto& actuator : actuators_) {
             actuator->shutdown();
         }
+        actuatorOutput_.flush(monotonicNowNs());   // Zeroed commands to the nodes
+        if (outboundFrames_) sendQueued(*outboundFrames_);  // I/O thread already stopped
         for (auto& sensor : sensors_) {
             sensor->shutdown();
         }
@@ -476,6 +1333,12 @@ public:
         }
         
         safetyMonitor_->shutdown();
+        if (stateBus_) stateBus_->close();
+        if (reportThread_.joinable()) reportThread_.join();
+        if (recorder_) {
+            logger_->log(recorder_->getStatus());
+            recorder_->shutdown();
+        }
         logger_->shutdown();
     }
 
@@ -490,6 +1353,29 @@ public:
         }
         
         std::cout << "\nSafety: " << safetyMonitor_->getStatus() << "\n";
+
+        if (scheduler_) {
+            std::cout << "\nTiming: " << scheduler_->getStatus() << "\n";
+        }
+        if (executor_) {
+            std::cout << "  " << executor_->getStatus() << "\n";
+            if (executor_->getCycleTiming().getCount() > 0) {
+                std::string timing = executor_->getTimingStatus();
+                std::cout << "\nCycle timing (per stage):\n  ";
+                for (char c : timing) {
+                    std::cout << c;
+                    if (c == '\n') std::cout << "  ";
+                }
+                std::cout << "\n";
+            }
+        }
+        if (pipelined_ && ioThread_) {
+            std::cout << "\nThreads:\n";
+            for (const auto* worker : {ioThread_.get(), loggingThread_.get()}) {
+                std::cout << "  " << worker->getStatus() << "\n  "
+                          << worker->getExecutor().getStatus() << "\n";
+            }
+        }
         
         std::cout << "\nSensors:\n";
         for (const auto& sensor : sensors_) {
@@ -500,14 +1386,44 @@ public:
         for (const auto& actuator : actuators_) {
             std::cout << "  " << actuator->getStatus() << "\n";
         }
+        if (actuatorOutput_.getBindingCount() > 0) {
+            std::cout << "  " << actuatorOutput_.getStatus() << "\n";
+        }
         
+        std::cout << "\nControl loops:\n";
+        for (const auto& loop : controllers_.getLoops()) {
+            std::cout << "  " << loop.config.name << ": " << loop.config.sensor << " -> "
+                      << loop.config.actuator
+                      << (loop.bound ? (loop.enabled ? " [auto]" : " [manual]") : " [unbound]")
+                      << " sp=" << loop.setpoint << " out=" << loop.output << "\n";
+        }
+
         std::cout << "\nCommunication:\n";
         for (const auto& comm : commInterfaces_) {
             std::cout << "  " << comm->getStatus() << "\n";
         }
+        std::cout << "  " << surfaceCommands_.getStatus() << "\n";
+        for (size_t i = 0; i < telemetryDeltas_.size(); i++) {
+            if (!commDownlinks_[i]) continue;
+            std::cout << "  " << commInterfaces_[i]->getComponentName() << ": "
+                      << telemetryDeltas_[i].getStatus() << "\n";
+        }
+        for (const std::string& line : clockSyncStatus()) std::cout << "  " << line << "\n";
         std::cout << "========================\n\n";
     }
 
+    // Per-stage timing histograms as JSON (see RateGroupExecutor::getTimingJson)
+    bool writeTimingReport(const std::string& path) const {
+        if (!executor_) return false;
+        std::ofstream file(path);
+        if (!file.is_open()) {
+            if (logger_) logger_->log("ERROR: Cannot write timing report " + path);
+            return false;
+        }
+        file << executor_->getTimingJson() << "\n";
+        return true;
+    }
+
     void printECUTable() {
         if (ecuManager_) {
             ecuManager_->printSystemStatus();
@@ -0,0 +1,59 @@
+// CRC
+#ifndef CRC_HPP
+#define CRC_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF), table driven
+namespace crc_detail {
+    constexpr std::array<uint16_t, 256> makeCcittTable() {
+        std::array<uint16_t, 256> table{};
+        for (uint16_t i = 0; i < 256; i++) {
+            uint16_t crc = static_cast<uint16_t>(i << 8);
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021)
+                                     : static_cast<uint16_t>(crc << 1);
+            }
+            table[i] = crc;
+        }
+        return table;
+    }
+
+    inline constexpr std::array<uint16_t, 256> CCITT_TABLE = makeCcittTable();
+
+    constexpr std::array<uint16_t, 256> makeModbusTable() {
+        std::array<uint16_t, 256> table{};
+        for (uint16_t i = 0; i < 256; i++) {
+            uint16_t crc = i;
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc & 0x0001) ? static_cast<uint16_t>((crc >> 1) ^ 0xA001)
+                                     : static_cast<uint16_t>(crc >> 1);
+            }
+            table[i] = crc;
+        }
+        return table;
+    }
+
+    inline constexpr std::array<uint16_t, 256> MODBUS_TABLE = makeModbusTable();
+}
+
+inline uint16_t crc16Ccitt(const uint8_t* data, size_t length, uint16_t crc = 0xFFFF) {
+    for (size_t i = 0; i < length; i++) {
+        crc = static_cast<uint16_t>((crc << 8) ^
+                                    crc_detail::CCITT_TABLE[((crc >> 8) ^ data[i]) & 0xFF]);
+    }
+    return crc;
+}
+
+// CRC-16/MODBUS (reflected poly 0xA001, init 0xFFFF), sent low byte first
+inline uint16_t crc16Modbus(const uint8_t* data, size_t length) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc = static_cast<uint16_t>((crc >> 8) ^ crc_detail::MODBUS_TABLE[(crc ^ data[i]) & 0xFF]);
+    }
+    return crc;
+}
+
+#endif // CRC_HPP
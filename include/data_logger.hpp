@@ -3,23 +3,74 @@
 #define DATA_LOGGER_HPP
 
 #include "base.hpp"
+#include "spsc_queue.hpp"
+#include "status_format.hpp"
 #include <fstream>
 #include <sstream>
 #include <iomanip>
 #include <chrono>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <cstring>
+#include <ctime>
+
+// Logging modes
+enum class LogMode {
+    SYNCHRONOUS,   // Format and write on the calling thread
+    ASYNCHRONOUS   // Queue records for a background writer thread
+};
+
+// What log() does when the async queue is full
+enum class OverflowPolicy {
+    BLOCK,         // Wait for the writer to free a slot
+    DROP           // Discard the record and count it
+};
+
+// Fixed-size record passed from the control thread to the writer
+struct LogRecord {
+    static constexpr size_t TEXT_SIZE = 240;
+
+    int64_t timestampNs;          // system_clock time since epoch
+    uint32_t length;
+    char text[TEXT_SIZE];
+};
 
 class DataLogger : public ISystemComponent {
 private:
+    static constexpr size_t QUEUE_CAPACITY = 4096;
+    static constexpr size_t SHARED_QUEUE_CAPACITY = 256;
+    static constexpr size_t WRITE_BATCH_BYTES = 64 * 1024;
+
     std::ofstream logFile_;
     std::string filename_;
-    bool isLogging_;
-    
+    std::atomic<bool> isLogging_;     // Read by every logging thread
+
+    // Async mode
+    LogMode mode_;
+    OverflowPolicy overflowPolicy_;
+    std::unique_ptr<SPSCQueue<LogRecord, QUEUE_CAPACITY>> queue_;
+    // Records from every other thread, one producer at a time under
+    // sharedMutex_ (which also serializes synchronous writes)
+    std::unique_ptr<SPSCQueue<LogRecord, SHARED_QUEUE_CAPACITY>> sharedQueue_;
+    std::mutex sharedMutex_;
+    std::thread::id producerThread_;    // Owns queue_: the thread that called initialize()
+    std::thread writerThread_;
+    std::atomic<bool> writerRunning_;
+    std::atomic<uint64_t> droppedRecords_;
+    std::atomic<uint64_t> writtenRecords_;
+
+    // Writer-side timestamp cache (seconds part only changes once a second)
+    time_t cachedSecond_;
+    char cachedSecondText_[32];
+
     std::string getTimestamp() {
         auto now = std::chrono::system_clock::now();
         auto time = std::chrono::system_clock::to_time_t(now);
         auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
             now.time_since_epoch()) % 1000;
-        
+
         std::stringstream ss;
         ss << std::put_time(std::localtime(&time), "%Y-%m-%d %H:%M:%S");
         ss << '.' << std::setfill('0') << std::setw(3) << ms.count();
@@ -27,15 +78,35 @@ private:
     }
 
 public:
-    DataLogger(const std::string& filename) 
-        : filename_(filename), isLogging_(false) {}
+    DataLogger(const std::string& filename,
+               LogMode mode = LogMode::SYNCHRONOUS,
+               OverflowPolicy overflowPolicy = OverflowPolicy::DROP)
+        : filename_(filename), isLogging_(false),
+          mode_(mode), overflowPolicy_(overflowPolicy),
+          writerRunning_(false), droppedRecords_(0), writtenRecords_(0),
+          cachedSecond_(0) {
+        cachedSecondText_[0] = '\0';
+    }
+
+    ~DataLogger() {
+        stopWriter();
+    }
 
     bool initialize() override {
         logFile_.open(filename_, std::ios::app);
         if (!logFile_.is_open()) return false;
-        
+
         isLogging_ = true;
         logFile_ << "\n=== Session Started: " << getTimestamp() << " ===\n";
+
+        if (mode_ == LogMode::ASYNCHRONOUS) {
+            logFile_.flush();
+            queue_ = std::make_unique<SPSCQueue<LogRecord, QUEUE_CAPACITY>>();
+            sharedQueue_ = std::make_unique<SPSCQueue<LogRecord, SHARED_QUEUE_CAPACITY>>();
+            producerThread_ = std::this_thread::get_id();
+            writerRunning_ = true;
+            writerThread_ = std::thread(&DataLogger::writerLoop, this);
+        }
         return true;
     }
     // Roombaaaaaa
@@ -44,6 +115,8 @@ public:
     }
 
     bool shutdown() override {
+        // Writer drains whatever is still queued before exiting
+        stopWriter();
         if (logFile_.is_open()) {
             logFile_ << "=== Session Ended: " << getTimestamp() << " ===\n";
             logFile_.close();
@@ -52,20 +125,140 @@ public:
         return true;
     }
 
-    void log(const std::string& message) {
+    // Any thread may log. In async mode the thread that called
+    // initialize() (the control thread) has the lock-free queue to
+    // itself; other threads (startup and poll workers, the pipeline)
+    // take a mutex into a smaller shared queue. Async records are copied
+    // straight in, so a message formatted into a stack buffer
+    // (StatusWriter) is logged without allocating.
+    void log(std::string_view message) {
         if (!isLogging_) return;
-        logFile_ << getTimestamp() << " | " << message << std::endl;
+
+        if (mode_ == LogMode::SYNCHRONOUS) {
+            std::lock_guard<std::mutex> lock(sharedMutex_);
+            logFile_ << getTimestamp() << " | " << message << std::endl;
+            return;
+        }
+
+        int64_t timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        auto fill = [&](LogRecord& record) {
+            record.timestampNs = timestampNs;
+            record.length = static_cast<uint32_t>(
+                std::min(message.size(), LogRecord::TEXT_SIZE));
+            std::memcpy(record.text, message.data(), record.length);
+        };
+
+        if (std::this_thread::get_id() == producerThread_) {
+            enqueue(*queue_, fill);
+        } else {
+            std::lock_guard<std::mutex> lock(sharedMutex_);
+            enqueue(*sharedQueue_, fill);
+        }
     }
 
     void logComponentStatus(const ISystemComponent& component) {
-        log(component.getComponentName() + ": " + component.getStatus());
+        char text[LogRecord::TEXT_SIZE];
+        StatusWriter line(text, sizeof(text));
+        line.text(component.getComponentName()).text(": ").status(component);
+        log(line.view());
     }
 
+    LogMode getMode() const { return mode_; }
+    uint64_t getDroppedRecords() const { return droppedRecords_; }
+    uint64_t getWrittenRecords() const { return writtenRecords_; }
+
     std::string getStatus() const override {
-        return isLogging_ ? "Logging to " + filename_ : "Not logging";
+        if (!isLogging_) return "Not logging";
+        std::string status = "Logging to " + filename_;
+        if (mode_ == LogMode::ASYNCHRONOUS) {
+            status += " (async, " + std::to_string(writtenRecords_.load()) +
+                      " written, " + std::to_string(droppedRecords_.load()) +
+                      " dropped)";
+        }
+        return status;
     }
 
     std::string getComponentName() const override { return "DataLogger"; }
+
+private:
+    template <typename Queue, typename Fill>
+    void enqueue(Queue& queue, Fill& fill) {
+        while (!queue.tryEmplace(fill)) {
+            if (overflowPolicy_ == OverflowPolicy::DROP || !writerRunning_) {
+                droppedRecords_++;
+                return;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    void stopWriter() {
+        if (writerThread_.joinable()) {
+            writerRunning_ = false;
+            writerThread_.join();
+        }
+    }
+
+    // Background writer: drain both queues oldest record first, format
+    // into one buffer, write and flush once per batch
+    void writerLoop() {
+        std::string batch;
+        batch.reserve(WRITE_BATCH_BYTES + 2 * LogRecord::TEXT_SIZE);
+
+        while (true) {
+            bool running = writerRunning_.load();
+
+            for (;;) {
+                LogRecord* own = queue_->front();
+                LogRecord* shared = sharedQueue_->front();
+                if (!own && !shared) break;
+                if (own && (!shared || own->timestampNs <= shared->timestampNs)) {
+                    appendRecord(batch, *own);
+                    queue_->pop();
+                } else {
+                    appendRecord(batch, *shared);
+                    sharedQueue_->pop();
+                }
+                writtenRecords_++;
+                if (batch.size() >= WRITE_BATCH_BYTES) {
+                    logFile_.write(batch.data(), batch.size());
+                    batch.clear();
+                }
+            }
+
+            if (!batch.empty()) {
+                logFile_.write(batch.data(), batch.size());
+                logFile_.flush();
+                batch.clear();
+            }
+
+            if (!running) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    void appendRecord(std::string& out, const LogRecord& record) {
+        time_t seconds = static_cast<time_t>(record.timestampNs / 1000000000LL);
+        int ms = static_cast<int>((record.timestampNs / 1000000LL) % 1000);
+
+        if (seconds != cachedSecond_) {
+            std::tm local;
+            localtime_r(&seconds, &local);
+            std::strftime(cachedSecondText_, sizeof(cachedSecondText_),
+                          "%Y-%m-%d %H:%M:%S", &local);
+            cachedSecond_ = seconds;
+        }
+
+        char msText[5] = {'.', static_cast<char>('0' + ms / 100),
+                          static_cast<char>('0' + (ms / 10) % 10),
+                          static_cast<char>('0' + ms % 10), '\0'};
+        out += cachedSecondText_;
+        out.append(msText, 4);
+        out += " | ";
+        out.append(record.text, record.length);
+        out += '\n';
+    }
 };
 
-#endif
\ No newline at end of file
+#endif
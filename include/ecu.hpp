@@ -3,6 +3,9 @@
 #define ECU_HPP
 
 #include "base.hpp"
+#include "scheduler.hpp"
+#include "status_format.hpp"
+#include <functional>
 #include <vector>
 #include <map>
 #include <memory>
@@ -29,6 +32,12 @@ enum class ECUStatus {
     DEGRADED
 };
 
+constexpr size_t ECU_STATUS_COUNT = 5;
+
+// Dense index of an ECU, assigned by ECUManager::addECU() in registration order
+using ECUHandle = uint32_t;
+constexpr ECUHandle INVALID_ECU_HANDLE = UINT32_MAX;
+
 // ECU Location information
 struct ECULocation {
     std::string compartment;      // e.g., "Main Electronics Bay"
@@ -55,6 +64,28 @@ struct CommunicationInfo {
     double updateRateHz;          // How often this ECU is polled/updates
 };
 
+// One answer to a health request
+struct ECUHealthReport {
+    double cpuUsagePercent;
+    double memoryUsagePercent;
+    double temperatureCelsius;
+};
+
+// Latest health result for an ECU as posted by a poller. Counters are
+// cumulative so a reader that skips samples still sees every failure.
+struct ECUHealthSample {
+    ECUHealthReport report;     // Last successful reply
+    int64_t replyNs;            // Monotonic time of that reply (0 = none yet)
+    int64_t latencyNs;          // Duration of the most recent request
+    uint32_t replies;
+    uint32_t timeouts;
+    uint32_t failures;
+};
+
+// Blocking health request, bounded by timeoutMs. Returns true if the ECU
+// answered. Runs on a poller thread, not the control thread.
+using ECUHealthQuery = std::function<bool(ECUHealthReport& report, int timeoutMs)>;
+
 // ECU Class - Represents one Electronic Control Unit
 class ECU : public ISystemComponent {
 private:
@@ -66,8 +97,14 @@ private:
     CommunicationInfo commInfo_;
     std::vector<ControlledDevice> controlledDevices_;
     
-    // Health monitoring
-    std::chrono::system_clock::time_point lastCommunication_;
+    // Health monitoring. The watchdog runs off lastReplyNs_, which only
+    // moves on an actual reply (health query or a packet from the node).
+    // It is armed by a health query at initialize() or by the first
+    // packet; an ECU with no reply source stays ONLINE, unmonitored.
+    ECUHealthQuery healthQuery_;
+    int64_t lastReplyNs_;
+    int64_t watchdogTimeoutNs_;
+    uint32_t reportedFailures_;
     double cpuUsagePercent_;
     double memoryUsagePercent_;
     double temperatureCelsius_;
@@ -78,12 +115,11 @@ public:
     ECU(const std::string& ecuID, const std::string& name, ECUType type)
         : ecuID_(ecuID), name_(name), type_(type), 
           status_(ECUStatus::OFFLINE),
+          lastReplyNs_(monotonicNowNs()), watchdogTimeoutNs_(5000000000LL),
+          reportedFailures_(0),
           cpuUsagePercent_(0.0), memoryUsagePercent_(0.0),
           temperatureCelsius_(0.0), communicationErrors_(0),
-          watchdogActive_(false) {
-        
-        lastCommunication_ = std::chrono::system_clock::now();
-    }
+          watchdogActive_(false) {}
 
     // ISystemComponent implementation
     bool initialize() override {
@@ -95,7 +131,9 @@ public:
         
         if (commSuccess) {
             status_ = ECUStatus::ONLINE;
-            watchdogActive_ = true;
+            watchdogActive_ = static_cast<bool>(healthQuery_);
+            lastReplyNs_ = monotonicNowNs();
+            if (!healthQuery_) updateHealthMetrics();
             return true;
         } else {
             status_ = ECUStatus::FAULT;
@@ -103,36 +141,62 @@ public:
         }
     }
 
+    // Synchronous health poll: query (if the ECU has one) on the calling
+    // thread, then run the watchdog. ECUManager uses the cached sample
+    // path instead when a poller is running.
     bool update() override {
-        // Check watchdog timeout
-        auto now = std::chrono::system_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
-            now - lastCommunication_);
-        
-        if (elapsed.count() > 5 && status_ == ECUStatus::ONLINE) {
+        if (healthQuery_) {
+            ECUHealthReport report{};
+            if (queryHealth(report, 100)) {
+                applyReport(report, monotonicNowNs());
+            } else {
+                communicationErrors_++;
+            }
+        }
+        return checkWatchdog(monotonicNowNs());
+    }
+
+    // Apply a poller's sample (control thread)
+    void applyHealthSample(const ECUHealthSample& sample) {
+        uint32_t failures = sample.timeouts + sample.failures;
+        communicationErrors_ += static_cast<int>(failures - reportedFailures_);
+        reportedFailures_ = failures;
+        if (sample.replyNs > lastReplyNs_) {
+            applyReport(sample.report, sample.replyNs);
+        }
+    }
+
+    // ONLINE -> DEGRADED when nothing has been heard for the watchdog
+    // period (armed ECUs only)
+    bool checkWatchdog(int64_t nowNs) {
+        if (watchdogActive_ && status_ == ECUStatus::ONLINE &&
+            nowNs - lastReplyNs_ > watchdogTimeoutNs_) {
             status_ = ECUStatus::DEGRADED;
             communicationErrors_++;
         }
-        
-        // Update health metrics (placeholder - would read from actual ECU)
-        updateHealthMetrics();
-        
         return status_ == ECUStatus::ONLINE || status_ == ECUStatus::DEGRADED;
     }
 
+    // Blocking request through the installed query (any thread)
+    bool queryHealth(ECUHealthReport& report, int timeoutMs) const {
+        return healthQuery_ && healthQuery_(report, timeoutMs);
+    }
+
     bool shutdown() override {
         status_ = ECUStatus::OFFLINE;
         watchdogActive_ = false;
         return true;
     }
     // Jay was here ;D
-    std::string getStatus() const override {
-        std::stringstream ss;
-        ss << name_ << " [" << ecuID_ << "]: " << statusToString(status_);
-        ss << " | Errors: " << communicationErrors_;
-        ss << " | Temp: " << std::fixed << std::setprecision(1) 
-           << temperatureCelsius_ << "°C";
-        return ss.str();
+    std::string getStatus() const override { return statusText(*this); }
+
+    size_t formatStatus(char* buffer, size_t size) const override {
+        StatusWriter out(buffer, size);
+        out.text(name_).text(" [").text(ecuID_).text("]: ").text(statusToString(status_))
+           .text(isMonitored() ? "" : " (unmonitored)")
+           .text(" | Errors: ").number(communicationErrors_)
+           .text(" | Temp: ").fixed(temperatureCelsius_, 1).text("°C");
+        return out.length();
     }
 
     std::string getComponentName() const override {
@@ -152,13 +216,28 @@ public:
         controlledDevices_.push_back(device);
     }
 
-    void updateCommunicationTimestamp() {
-        lastCommunication_ = std::chrono::system_clock::now();
+    // A packet from this ECU arrived at receiveNs (monotonic); arms the
+    // watchdog once the ECU is up
+    void updateCommunicationTimestamp(int64_t receiveNs) {
+        lastReplyNs_ = std::max(lastReplyNs_, receiveNs);
+        if (status_ == ECUStatus::ONLINE || status_ == ECUStatus::DEGRADED) {
+            watchdogActive_ = true;
+        }
         if (status_ == ECUStatus::DEGRADED) {
             status_ = ECUStatus::ONLINE;
         }
     }
 
+    // Install the health request used by update() or a poller (before
+    // polling starts)
+    void setHealthQuery(ECUHealthQuery query) {
+        healthQuery_ = std::move(query);
+    }
+
+    void setWatchdogTimeout(double seconds) {
+        watchdogTimeoutNs_ = static_cast<int64_t>(seconds * 1e9);
+    }
+
     // Getters
     std::string getECUID() const { return ecuID_; }
     ECUType getType() const { return type_; }
@@ -173,6 +252,10 @@ public:
     double getMemoryUsage() const { return memoryUsagePercent_; }
     double getTemperature() const { return temperatureCelsius_; }
     int getCommunicationErrors() const { return communicationErrors_; }
+    int64_t getLastReplyNs() const { return lastReplyNs_; }
+    bool hasHealthQuery() const { return static_cast<bool>(healthQuery_); }
+    // Watchdog armed: something answers for this ECU
+    bool isMonitored() const { return watchdogActive_; }
 
     // Generate detailed report for documentation
     std::string generateReport() const {
@@ -239,8 +322,18 @@ private:
         return true;
     }
 
+    void applyReport(const ECUHealthReport& report, int64_t replyNs) {
+        cpuUsagePercent_ = report.cpuUsagePercent;
+        memoryUsagePercent_ = report.memoryUsagePercent;
+        temperatureCelsius_ = report.temperatureCelsius;
+        lastReplyNs_ = replyNs;
+        if (status_ == ECUStatus::DEGRADED) {
+            status_ = ECUStatus::ONLINE;
+        }
+    }
+
     void updateHealthMetrics() {
-        // Placeholder - in real implementation would query ECU
+        // Placeholder for ECUs without a health query
         // For Raspberry Pi: read /proc/stat, /proc/meminfo, thermal zone
         // For Teensy: request status packet
         // For VFD: read Modbus registers
@@ -263,7 +356,7 @@ private:
         }
     }
 
-    std::string statusToString(ECUStatus status) const {
+    const char* statusToString(ECUStatus status) const {
         switch (status) {
             case ECUStatus::OFFLINE: return "OFFLINE";
             case ECUStatus::INITIALIZING: return "INITIALIZING";
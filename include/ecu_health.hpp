@@ -0,0 +1,154 @@
+// ECUHealthPoller
+#ifndef ECU_HEALTH_HPP
+#define ECU_HEALTH_HPP
+
+#include "ecu.hpp"
+#include "seqlock.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Polls ECU health queries on a small worker pool so a slow or hung
+// device never blocks the control loop. Each ECU is requested at its
+// declared updateRateHz, at most one request in flight per ECU; a worker
+// stuck on one ECU leaves the others to the remaining workers. A reply
+// that takes longer than the request timeout is counted as a timeout and
+// dropped. Results are posted to a per-ECU mailbox that the control
+// thread reads without locking.
+class ECUHealthPoller {
+private:
+    struct Slot {
+        std::shared_ptr<ECU> ecu;
+        int64_t periodNs;
+        int64_t nextDueNs;
+        bool busy;
+        ECUHealthSample sample;             // Worker-side copy (under mutex_)
+        Seqlock<ECUHealthSample> mailbox;
+    };
+
+    int timeoutMs_;
+    std::vector<std::unique_ptr<Slot>> slots_;  // Indexed by ECUHandle, null = not polled
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool running_;
+
+    // Earliest-due idle slot, or nullptr with the time to wait until one is due
+    Slot* nextDue(int64_t nowNs, int64_t& waitNs) {
+        Slot* next = nullptr;
+        int64_t earliest = INT64_MAX;
+        for (auto& slot : slots_) {
+            if (!slot || slot->busy || slot->nextDueNs >= earliest) continue;
+            earliest = slot->nextDueNs;
+            next = slot.get();
+        }
+        if (next && earliest <= nowNs) return next;
+        waitNs = next ? earliest - nowNs : -1;
+        return nullptr;
+    }
+
+    void workerLoop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (running_) {
+            int64_t now = monotonicNowNs();
+            int64_t waitNs = -1;
+            Slot* slot = nextDue(now, waitNs);
+            if (!slot) {
+                if (waitNs < 0) {
+                    wake_.wait(lock);
+                } else {
+                    wake_.wait_for(lock, std::chrono::nanoseconds(waitNs));
+                }
+                continue;
+            }
+
+            // Fall behind rather than burst to catch up
+            slot->busy = true;
+            slot->nextDueNs = std::max(slot->nextDueNs + slot->periodNs, now);
+            lock.unlock();
+
+            ECUHealthReport report{};
+            int64_t start = monotonicNowNs();
+            bool answered = slot->ecu->queryHealth(report, timeoutMs_);
+            int64_t end = monotonicNowNs();
+
+            lock.lock();
+            ECUHealthSample& sample = slot->sample;
+            sample.latencyNs = end - start;
+            if (!answered) {
+                sample.failures++;
+            } else if (end - start > static_cast<int64_t>(timeoutMs_) * 1000000) {
+                sample.timeouts++;
+            } else {
+                sample.report = report;
+                sample.replyNs = end;
+                sample.replies++;
+            }
+            slot->mailbox.write(sample);
+            slot->busy = false;
+            wake_.notify_one();
+        }
+    }
+
+public:
+    explicit ECUHealthPoller(int timeoutMs = 100) : timeoutMs_(timeoutMs), running_(false) {}
+
+    ~ECUHealthPoller() { stop(); }
+
+    // Register before start(). ECUs without a health query are not polled.
+    void addECU(ECUHandle handle, std::shared_ptr<ECU> ecu) {
+        if (running_ || !ecu->hasHealthQuery()) return;
+        if (slots_.size() <= handle) slots_.resize(handle + 1);
+        double rateHz = ecu->getCommunicationInfo().updateRateHz;
+        auto slot = std::make_unique<Slot>();
+        slot->ecu = ecu;
+        slot->periodNs = static_cast<int64_t>(1e9 / (rateHz > 0.0 ? rateHz : 1.0));
+        slot->nextDueNs = monotonicNowNs();
+        slot->busy = false;
+        slot->sample = {};
+        slots_[handle] = std::move(slot);
+    }
+
+    bool start(size_t workerCount) {
+        if (running_ || workerCount == 0) return false;
+        running_ = true;
+        for (size_t i = 0; i < workerCount; i++) {
+            workers_.emplace_back(&ECUHealthPoller::workerLoop, this);
+        }
+        return true;
+    }
+
+    // Joins the workers; waits for any request still in flight
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            running_ = false;
+        }
+        wake_.notify_all();
+        for (auto& worker : workers_) {
+            if (worker.joinable()) worker.join();
+        }
+        workers_.clear();
+    }
+
+    bool isPolled(ECUHandle handle) const {
+        return handle < slots_.size() && slots_[handle] != nullptr;
+    }
+
+    // Latest sample (any thread). Returns its sequence, 0 = nothing posted yet.
+    uint32_t read(ECUHandle handle, ECUHealthSample& out) const {
+        return isPolled(handle) ? slots_[handle]->mailbox.read(out) : 0;
+    }
+
+    size_t getPolledCount() const {
+        size_t count = 0;
+        for (const auto& slot : slots_) count += slot != nullptr;
+        return count;
+    }
+
+    size_t getWorkerCount() const { return workers_.size(); }
+    int getTimeoutMs() const { return timeoutMs_; }
+};
+
+#endif // ECU_HEALTH_HPP
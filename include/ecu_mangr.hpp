@@ -3,143 +3,293 @@
 #define ECU_MANAGER_HPP
 
 #include "ecu.hpp"
+#include "ecu_health.hpp"
 #include "data_logger.hpp"
+#include "scheduler.hpp"
+#include "startup.hpp"
+#include "topology.hpp"
 #include <map>
 #include <algorithm>
+#include <array>
 #include <fstream>
 #include <iostream>
-
+#include <span>
+
+// ECUs live in one vector addressed by handle. Names are resolved to
+// handles once at setup (findECU); the cycle only uses handles. The hot
+// health fields are mirrored into parallel arrays whenever the manager
+// touches an ECU, and the per-status counts are adjusted on transitions
+// so status queries never walk the ECU objects.
+// With health polling started, ECUs that have a health query are asked
+// by an ECUHealthPoller and updateECU() only applies the cached sample.
 class ECUManager : public ISystemComponent {
 private:
-    std::map<std::string, std::shared_ptr<ECU>> ecus_;
-    std::shared_ptr<DataLogger> logger_;
-    bool allECUsOnline_;
     std::string systemName_;
+    std::shared_ptr<DataLogger> logger_;
+
+    std::vector<std::shared_ptr<ECU>> ecus_;
+    std::map<std::string, ECUHandle> handles_;      // Setup-time lookup only
+
+    // Health (structure of arrays, indexed by handle)
+    std::vector<uint8_t> statusCodes_;              // ECUStatus values
+    std::vector<int64_t> lastCommunicationNs_;      // Monotonic, 0 = never
+    std::vector<uint32_t> errorCounts_;
+    std::array<uint32_t, ECU_STATUS_COUNT> statusCounts_;
+
+    std::unique_ptr<ECUHealthPoller> poller_;
+    std::vector<uint32_t> appliedSamples_;          // Last sample sequence applied
+    int initTimeoutMs_;
+
+    // Mirror an ECU's state into the health arrays, adjusting the counts
+    void syncHealth(ECUHandle handle) {
+        const ECU& ecu = *ecus_[handle];
+        uint8_t status = static_cast<uint8_t>(ecu.getECUStatus());
+        if (status != statusCodes_[handle]) {
+            statusCounts_[statusCodes_[handle]]--;
+            statusCounts_[status]++;
+            statusCodes_[handle] = status;
+        }
+        errorCounts_[handle] = static_cast<uint32_t>(ecu.getCommunicationErrors());
+        lastCommunicationNs_[handle] = ecu.getLastReplyNs();
+    }
 
 public:
     ECUManager(const std::string& systemName, std::shared_ptr<DataLogger> logger)
-        : systemName_(systemName), logger_(logger), allECUsOnline_(false) {}
+        : systemName_(systemName), logger_(logger), statusCounts_{}, initTimeoutMs_(1000) {}
 
+    // ECUs are brought up concurrently, each bounded by initTimeoutMs
     bool initialize() override {
         if (logger_) {
             logger_->log("ECU Manager initializing...");
         }
+        StartupSequencer startup;
+        addStartupTasks(startup, 0, initTimeoutMs_);
+        startup.run();
+        return completeStartup(startup);
+    }
 
+    // One startup task per ECU, so a caller can bring the ECUs up in the
+    // same stage as other components. Finish with completeStartup().
+    void addStartupTasks(StartupSequencer& startup, size_t stage, int timeoutMs) {
+        for (const auto& ecu : ecus_) {
+            startup.addTask(stage, ecu->getECUID(), [ecu]() { return ecu->initialize(); },
+                            timeoutMs);
+        }
+    }
+
+    // Log each ECU's result and refresh the health arrays
+    bool completeStartup(const StartupSequencer& startup) {
         bool success = true;
-        for (auto& [id, ecu] : ecus_) {
-            if (!ecu->initialize()) {
-                if (logger_) {
-                    logger_->log("Failed to initialize ECU: " + id);
-                }
-                success = false;
-            } else {
-                if (logger_) {
-                    logger_->log("ECU initialized: " + id);
-                }
+        for (ECUHandle handle = 0; handle < ecus_.size(); handle++) {
+            const std::string& id = ecus_[handle]->getECUID();
+            const StartupResult* result = startup.findResult(id);
+            bool ok = result && result->ok;
+            if (logger_) {
+                logger_->log(ok ? "ECU initialized: " + id
+                                : result ? StartupSequencer::describe(*result)
+                                         : "Failed to initialize ECU: " + id);
             }
+            success = success && ok;
+            syncHealth(handle);
         }
-
-        updateSystemStatus();
         return success;
     }
 
+    void setInitTimeout(int timeoutMs) { initTimeoutMs_ = timeoutMs; }
+
+    const std::string& getSystemName() const { return systemName_; }
+
     bool update() override {
         bool allOK = true;
-        
-        for (auto& [id, ecu] : ecus_) {
-            if (!ecu->update()) {
+        for (ECUHandle handle = 0; handle < ecus_.size(); handle++) {
+            if (!updateECU(handle)) {
                 allOK = false;
             }
         }
-
-        updateSystemStatus();
         return allOK;
     }
 
-    bool shutdown() override {
-        if (logger_) {
-            logger_->log("Shutting down all ECUs...");
+    // Update a single ECU (used when ECUs are polled from rate groups)
+    bool updateECU(ECUHandle handle) {
+        ECU& ecu = *ecus_[handle];
+        bool ok;
+        if (poller_ && poller_->isPolled(handle)) {
+            ECUHealthSample sample;
+            uint32_t sequence = poller_->read(handle, sample);
+            if (sequence != appliedSamples_[handle]) {
+                appliedSamples_[handle] = sequence;
+                ecu.applyHealthSample(sample);
+            }
+            ok = ecu.checkWatchdog(monotonicNowNs());
+        } else {
+            ok = ecu.update();
         }
+        syncHealth(handle);
+        return ok;
+    }
+
+    // Record a packet from an ECU, received at receiveNs (feeds its watchdog)
+    void markCommunication(ECUHandle handle, int64_t receiveNs) {
+        ecus_[handle]->updateCommunicationTimestamp(receiveNs);
+        syncHealth(handle);
+    }
 
-        for (auto& [id, ecu] : ecus_) {
-            ecu->shutdown();
+    // Move health queries off the calling thread. Call after initialize();
+    // returns false if no ECU has a health query.
+    bool startHealthPolling(size_t workerCount, int timeoutMs) {
+        if (poller_) return false;
+        auto poller = std::make_unique<ECUHealthPoller>(timeoutMs);
+        for (ECUHandle handle = 0; handle < ecus_.size(); handle++) {
+            poller->addECU(handle, ecus_[handle]);
         }
+        if (poller->getPolledCount() == 0) return false;
+
+        workerCount = std::min(workerCount, poller->getPolledCount());
+        appliedSamples_.assign(ecus_.size(), 0);
+        if (!poller->start(workerCount)) return false;
+        poller_ = std::move(poller);
 
-        allECUsOnline_ = false;
+        if (logger_) {
+            logger_->log("ECU health polling: " + std::to_string(poller_->getPolledCount()) +
+                         " ECUs on " + std::to_string(workerCount) + " workers, " +
+                         std::to_string(timeoutMs) + " ms timeout");
+        }
         return true;
     }
 
-    std::string getStatus() const override {
-        int online = 0, offline = 0, fault = 0, degraded = 0;
+    void stopHealthPolling() {
+        if (poller_) {
+            poller_->stop();
+            poller_.reset();
+        }
+    }
 
-        for (const auto& [id, ecu] : ecus_) {
-            switch (ecu->getECUStatus()) {
-                case ECUStatus::ONLINE: online++; break;
-                case ECUStatus::OFFLINE: offline++; break;
-                case ECUStatus::FAULT: fault++; break;
-                case ECUStatus::DEGRADED: degraded++; break;
-                default: break;
-            }
+    const ECUHealthPoller* getHealthPoller() const { return poller_.get(); }
+
+    bool shutdown() override {
+        if (logger_) {
+            logger_->log("Shutting down all ECUs...");
         }
+        stopHealthPolling();
 
-        std::stringstream ss;
-        ss << "ECUs: " << online << " online, " << degraded << " degraded, "
-           << fault << " fault, " << offline << " offline";
-        return ss.str();
+        for (ECUHandle handle = 0; handle < ecus_.size(); handle++) {
+            ecus_[handle]->shutdown();
+            syncHealth(handle);
+        }
+        return true;
+    }
+
+    std::string getStatus() const override { return statusText(*this); }
+
+    size_t formatStatus(char* buffer, size_t size) const override {
+        auto count = [this](ECUStatus status) {
+            return statusCounts_[static_cast<size_t>(status)];
+        };
+        StatusWriter out(buffer, size);
+        out.text("ECUs: ").number(count(ECUStatus::ONLINE)).text(" online, ")
+           .number(count(ECUStatus::DEGRADED)).text(" degraded, ")
+           .number(count(ECUStatus::FAULT)).text(" fault, ")
+           .number(count(ECUStatus::OFFLINE)).text(" offline");
+        return out.length();
     }
 
     std::string getComponentName() const override {
         return "ECUManager";
     }
 
-    // Add ECU to system
-    void addECU(std::shared_ptr<ECU> ecu) {
-        ecus_[ecu->getECUID()] = ecu;
+    // Add ECU to system. Re-adding an ID replaces the ECU under the same handle.
+    ECUHandle addECU(std::shared_ptr<ECU> ecu) {
+        auto it = handles_.find(ecu->getECUID());
+        ECUHandle handle;
+        if (it != handles_.end()) {
+            handle = it->second;
+            ecus_[handle] = ecu;
+        } else {
+            handle = static_cast<ECUHandle>(ecus_.size());
+            handles_[ecu->getECUID()] = handle;
+            ecus_.push_back(ecu);
+            statusCodes_.push_back(static_cast<uint8_t>(ECUStatus::OFFLINE));
+            lastCommunicationNs_.push_back(0);
+            errorCounts_.push_back(0);
+            statusCounts_[static_cast<size_t>(ECUStatus::OFFLINE)]++;
+        }
+        syncHealth(handle);
+
         if (logger_) {
             logger_->log("Added ECU: " + ecu->getECUID() + " - " + 
                         ecu->getComponentName());
         }
+        return handle;
+    }
+
+    // Every ECU of a topology table, in table order: handle i is row i, so
+    // handles resolved from the table hold at runtime. Only into an empty
+    // manager.
+    bool loadTopology(const Topology& topology) {
+        if (!ecus_.empty()) return false;
+        size_t count = topology.ecus.size();
+        ecus_.reserve(count);
+        statusCodes_.reserve(count);
+        lastCommunicationNs_.reserve(count);
+        errorCounts_.reserve(count);
+        for (const ECUSpec& spec : topology.ecus) addECU(createECU(spec));
+        return true;
+    }
+
+    // Setup-time lookup; INVALID_ECU_HANDLE if unknown
+    ECUHandle findECU(const std::string& ecuID) const {
+        auto it = handles_.find(ecuID);
+        return it != handles_.end() ? it->second : INVALID_ECU_HANDLE;
     }
 
     // Get specific ECU
-    std::shared_ptr<ECU> getECU(const std::string& ecuID) {
-        auto it = ecus_.find(ecuID);
-        if (it != ecus_.end()) {
-            return it->second;
-        }
-        return nullptr;
+    std::shared_ptr<ECU> getECU(const std::string& ecuID) const {
+        ECUHandle handle = findECU(ecuID);
+        return handle != INVALID_ECU_HANDLE ? ecus_[handle] : nullptr;
     }
 
+    ECU& ecuAt(ECUHandle handle) { return *ecus_[handle]; }
+    const ECU& ecuAt(ECUHandle handle) const { return *ecus_[handle]; }
+
     // Get all ECUs of a specific type
-    std::vector<std::shared_ptr<ECU>> getECUsByType(ECUType type) {
+    std::vector<std::shared_ptr<ECU>> getECUsByType(ECUType type) const {
         std::vector<std::shared_ptr<ECU>> result;
-        
-        for (const auto& [id, ecu] : ecus_) {
+        for (const auto& ecu : ecus_) {
             if (ecu->getType() == type) {
                 result.push_back(ecu);
             }
         }
-        
         return result;
     }
 
+    // All ECUs, indexed by handle
+    const std::vector<std::shared_ptr<ECU>>& getAllECUs() const {
+        return ecus_;
+    }
+
+    // Health as of the manager's last touch of each ECU, indexed by handle
+    ECUStatus getECUStatus(ECUHandle handle) const {
+        return static_cast<ECUStatus>(statusCodes_[handle]);
+    }
+    std::span<const uint8_t> getStatusCodes() const { return statusCodes_; }
+    int64_t getLastCommunicationNs(ECUHandle handle) const { return lastCommunicationNs_[handle]; }
+    uint32_t getErrorCount(ECUHandle handle) const { return errorCounts_[handle]; }
+
     // System health check
     bool areAllECUsOnline() const {
-        return allECUsOnline_;
+        return getOnlineECUCount() == ecus_.size();
     }
 
-    int getTotalECUCount() const {
+    size_t getTotalECUCount() const {
         return ecus_.size();
     }
 
-    int getOnlineECUCount() const {
-        int count = 0;
-        for (const auto& [id, ecu] : ecus_) {
-            if (ecu->getECUStatus() == ECUStatus::ONLINE) {
-                count++;
-            }
-        }
-        return count;
+    size_t getOnlineECUCount() const {
+        return statusCounts_[static_cast<size_t>(ECUStatus::ONLINE)];
+    }
+
+    size_t getECUCount(ECUStatus status) const {
+        return statusCounts_[static_cast<size_t>(status)];
     }
 
     // Generate ECU table for documentation
@@ -153,8 +303,8 @@ public:
         ss << "║ ECU ID ║ Name                     ║ Type              ║ Location                             ║\n";
         ss << "╠════════╬══════════════════════════╬═══════════════════╬══════════════════════════════════════╣\n";
 
-        for (const auto& [id, ecu] : ecus_) {
-            ss << "║ " << std::left << std::setw(6) << id << " ║ ";
+        for (const auto& ecu : ecus_) {
+            ss << "║ " << std::left << std::setw(6) << ecu->getECUID() << " ║ ";
             ss << std::setw(24) << ecu->getComponentName() << " ║ ";
             
             std::string typeStr;
@@ -194,7 +344,8 @@ public:
         // Create directory if needed (platform-specific, placeholder)
         
         // Generate individual ECU reports
-        for (const auto& [id, ecu] : ecus_) {
+        for (const auto& ecu : ecus_) {
+            const std::string& id = ecu->getECUID();
             std::string filename = outputDirectory + "ECU_" + id + "_report.txt";
             std::ofstream file(filename);
             
@@ -226,17 +377,6 @@ public:
     }
 
 private:
-    void updateSystemStatus() {
-        allECUsOnline_ = true;
-        
-        for (const auto& [id, ecu] : ecus_) {
-            if (ecu->getECUStatus() != ECUStatus::ONLINE) {
-                allECUsOnline_ = false;
-                break;
-            }
-        }
-    }
-
     std::string getCurrentTimestamp() const {
         auto now = std::chrono::system_clock::now();
         auto time = std::chrono::system_clock::to_time_t(now);
@@ -0,0 +1,156 @@
+// Framing
+#ifndef FRAMING_HPP
+#define FRAMING_HPP
+
+#include "base.hpp"
+#include "crc.hpp"
+#include <cstddef>
+#include <cstdint>
+
+// Serial link framing:  COBS( payload | CRC-16/CCITT little-endian ) 0x00
+// COBS removes every zero byte from the frame, so 0x00 only ever appears
+// as the delimiter and the receiver can resynchronize on any byte boundary.
+
+constexpr size_t FRAME_CRC_SIZE = 2;
+constexpr uint8_t FRAME_DELIMITER = 0x00;
+
+// Worst-case encoded size for a payload (COBS overhead + CRC + delimiter)
+constexpr size_t cobsMaxEncodedSize(size_t payloadLength) {
+    return payloadLength + FRAME_CRC_SIZE + (payloadLength + FRAME_CRC_SIZE) / 254 + 2;
+}
+
+// COBS-encode `length` bytes into `out` (no delimiter). Returns encoded length.
+inline size_t cobsEncode(const uint8_t* in, size_t length, uint8_t* out) {
+    size_t codeIndex = 0;
+    size_t outIndex = 1;
+    uint8_t code = 1;
+
+    for (size_t i = 0; i < length; i++) {
+        if (in[i] == 0) {
+            out[codeIndex] = code;
+            codeIndex = outIndex++;
+            code = 1;
+        } else {
+            out[outIndex++] = in[i];
+            code++;
+            if (code == 0xFF) {
+                out[codeIndex] = code;
+                codeIndex = outIndex++;
+                code = 1;
+            }
+        }
+    }
+    out[codeIndex] = code;
+    return outIndex;
+}
+
+// COBS-decode `length` bytes (no delimiter). Returns decoded length, 0 on error.
+inline size_t cobsDecode(const uint8_t* in, size_t length, uint8_t* out) {
+    size_t inIndex = 0;
+    size_t outIndex = 0;
+
+    while (inIndex < length) {
+        uint8_t code = in[inIndex++];
+        if (code == 0 || inIndex + code - 1 > length) return 0;
+        for (uint8_t i = 1; i < code; i++) {
+            out[outIndex++] = in[inIndex++];
+        }
+        if (code != 0xFF && inIndex < length) {
+            out[outIndex++] = 0;
+        }
+    }
+    return outIndex;
+}
+
+// Build a complete wire frame for a payload. `out` must hold
+// cobsMaxEncodedSize(length) bytes. Returns bytes to write, 0 if too long.
+inline size_t encodeFrame(const uint8_t* payload, size_t length, uint8_t* out) {
+    if (length > MAX_FRAME_SIZE) return 0;
+
+    uint8_t raw[MAX_FRAME_SIZE + FRAME_CRC_SIZE];
+    std::memcpy(raw, payload, length);
+    uint16_t crc = crc16Ccitt(payload, length);
+    raw[length] = static_cast<uint8_t>(crc);
+    raw[length + 1] = static_cast<uint8_t>(crc >> 8);
+
+    size_t encoded = cobsEncode(raw, length + FRAME_CRC_SIZE, out);
+    out[encoded++] = FRAME_DELIMITER;
+    return encoded;
+}
+
+// Incremental frame decoder for a byte stream
+class FrameDecoder {
+private:
+    uint8_t encoded_[cobsMaxEncodedSize(MAX_FRAME_SIZE)];
+    uint8_t decoded_[cobsMaxEncodedSize(MAX_FRAME_SIZE)];
+    size_t encodedLength_;
+    bool overflowed_;
+
+    uint64_t framesDecoded_;
+    uint64_t crcErrors_;
+    uint64_t framingErrors_;
+
+public:
+    FrameDecoder()
+        : encodedLength_(0), overflowed_(false),
+          framesDecoded_(0), crcErrors_(0), framingErrors_(0) {}
+
+    // Feed received bytes; onFrame(const uint8_t* payload, size_t length)
+    // is called for every frame that passes the CRC check
+    template <typename OnFrame>
+    void feed(const uint8_t* data, size_t length, OnFrame&& onFrame) {
+        for (size_t i = 0; i < length; i++) {
+            uint8_t byte = data[i];
+            if (byte != FRAME_DELIMITER) {
+                if (encodedLength_ < sizeof(encoded_)) {
+                    encoded_[encodedLength_++] = byte;
+                } else {
+                    overflowed_ = true;
+                }
+                continue;
+            }
+
+            if (encodedLength_ > 0) {
+                if (overflowed_) {
+                    framingErrors_++;
+                } else {
+                    deliver(onFrame);
+                }
+            }
+            encodedLength_ = 0;
+            overflowed_ = false;
+        }
+    }
+
+    void reset() {
+        encodedLength_ = 0;
+        overflowed_ = false;
+    }
+
+    uint64_t getFramesDecoded() const { return framesDecoded_; }
+    uint64_t getCrcErrors() const { return crcErrors_; }
+    uint64_t getFramingErrors() const { return framingErrors_; }
+
+private:
+    template <typename OnFrame>
+    void deliver(OnFrame& onFrame) {
+        size_t length = cobsDecode(encoded_, encodedLength_, decoded_);
+        if (length <= FRAME_CRC_SIZE) {
+            framingErrors_++;
+            return;
+        }
+
+        size_t payloadLength = length - FRAME_CRC_SIZE;
+        uint16_t received = static_cast<uint16_t>(decoded_[payloadLength] |
+                                                  (decoded_[payloadLength + 1] << 8));
+        if (received != crc16Ccitt(decoded_, payloadLength)) {
+            crcErrors_++;
+            return;
+        }
+
+        framesDecoded_++;
+        onFrame(static_cast<const uint8_t*>(decoded_), payloadLength);
+    }
+};
+
+#endif // FRAMING_HPP
@@ -0,0 +1,187 @@
+// HostMetrics
+#ifndef HOST_METRICS_HPP
+#define HOST_METRICS_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <unistd.h>
+
+// CPU, memory and SoC temperature of the Pi running the control system.
+// The /proc and /sys files are opened once and re-read with pread() into
+// fixed buffers; parsing is a plain digit scan, so sampling does not
+// allocate. Not thread-safe: one sampler (the ECU01 health query).
+
+constexpr const char* HOST_METRICS_PUBLISH_PATH = "/dev/shm/tbm_host_metrics";
+
+struct HostMetricsSample {
+    double cpuUsagePercent;     // Since the previous sample (0 on the first)
+    double memoryUsagePercent;  // (MemTotal - MemAvailable) / MemTotal
+    double temperatureCelsius;  // thermal_zone0, 0 if unavailable
+    bool hasTemperature;
+};
+
+// Next unsigned decimal at or after p. Returns the position after it, or
+// nullptr if there are no more digits before end.
+inline const char* parseUnsigned(const char* p, const char* end, uint64_t& value) {
+    while (p < end && (*p < '0' || *p > '9')) p++;
+    if (p == end) return nullptr;
+    value = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        value = value * 10 + static_cast<uint64_t>(*p - '0');
+        p++;
+    }
+    return p;
+}
+
+// The number on the line starting with key, e.g. "MemAvailable:"
+inline bool parseField(const char* p, const char* end, const char* key, uint64_t& value) {
+    size_t keyLength = std::strlen(key);
+    while (p < end) {
+        if (static_cast<size_t>(end - p) >= keyLength && std::memcmp(p, key, keyLength) == 0) {
+            const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            return parseUnsigned(p + keyLength, lineEnd ? lineEnd : end, value) != nullptr;
+        }
+        const char* next = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (!next) break;
+        p = next + 1;
+    }
+    return false;
+}
+
+class HostMetrics {
+private:
+    int statFd_;
+    int meminfoFd_;
+    int thermalFd_;
+
+    uint64_t lastBusy_;
+    uint64_t lastTotal_;
+    bool primed_;
+
+    char buffer_[4096];
+    char publishPath_[128];
+    char publishTempPath_[136];
+
+    // Read from offset 0; returns the length (0 on failure)
+    size_t readFile(int fd, size_t maxLength) {
+        if (fd < 0) return 0;
+        ssize_t length = pread(fd, buffer_, maxLength, 0);
+        return length > 0 ? static_cast<size_t>(length) : 0;
+    }
+
+    // Aggregate "cpu" line: user nice system idle iowait irq softirq steal
+    bool sampleCpu(double& usagePercent) {
+        size_t length = readFile(statFd_, 512);
+        if (length < 4 || std::memcmp(buffer_, "cpu ", 4) != 0) return false;
+        const char* end = static_cast<const char*>(std::memchr(buffer_, '\n', length));
+        if (!end) end = buffer_ + length;
+
+        uint64_t fields[8] = {};
+        const char* p = buffer_ + 3;
+        for (size_t i = 0; i < 8; i++) {
+            p = parseUnsigned(p, end, fields[i]);
+            if (!p) return false;
+        }
+        uint64_t idle = fields[3] + fields[4];
+        uint64_t total = 0;
+        for (uint64_t field : fields) total += field;
+        uint64_t busy = total - idle;
+
+        usagePercent = 0.0;
+        if (primed_ && total > lastTotal_) {
+            usagePercent = 100.0 * static_cast<double>(busy - lastBusy_) /
+                           static_cast<double>(total - lastTotal_);
+        }
+        lastBusy_ = busy;
+        lastTotal_ = total;
+        primed_ = true;
+        return true;
+    }
+
+    bool sampleMemory(double& usagePercent) {
+        size_t length = readFile(meminfoFd_, 512);
+        uint64_t total = 0, available = 0;
+        if (!parseField(buffer_, buffer_ + length, "MemTotal:", total) ||
+            !parseField(buffer_, buffer_ + length, "MemAvailable:", available) ||
+            total == 0) {
+            return false;
+        }
+        usagePercent = 100.0 * static_cast<double>(total - std::min(available, total)) /
+                       static_cast<double>(total);
+        return true;
+    }
+
+    // Millidegrees, may be negative
+    bool sampleTemperature(double& celsius) {
+        size_t length = readFile(thermalFd_, 32);
+        const char* p = buffer_;
+        const char* end = buffer_ + length;
+        bool negative = length > 0 && buffer_[0] == '-';
+        uint64_t milli = 0;
+        if (!parseUnsigned(p, end, milli)) return false;
+        celsius = (negative ? -1.0 : 1.0) * static_cast<double>(milli) / 1000.0;
+        return true;
+    }
+
+public:
+    HostMetrics()
+        : statFd_(open("/proc/stat", O_RDONLY | O_CLOEXEC)),
+          meminfoFd_(open("/proc/meminfo", O_RDONLY | O_CLOEXEC)),
+          thermalFd_(open("/sys/class/thermal/thermal_zone0/temp", O_RDONLY | O_CLOEXEC)),
+          lastBusy_(0), lastTotal_(0), primed_(false) {
+        setPublishPath(HOST_METRICS_PUBLISH_PATH);
+    }
+
+    ~HostMetrics() {
+        if (statFd_ >= 0) close(statFd_);
+        if (meminfoFd_ >= 0) close(meminfoFd_);
+        if (thermalFd_ >= 0) close(thermalFd_);
+    }
+
+    HostMetrics(const HostMetrics&) = delete;
+    HostMetrics& operator=(const HostMetrics&) = delete;
+
+    // CPU and memory are required; temperature is optional (not every host has zone0)
+    bool isAvailable() const { return statFd_ >= 0 && meminfoFd_ >= 0; }
+
+    bool sample(HostMetricsSample& out) {
+        out = {};
+        if (!sampleCpu(out.cpuUsagePercent) || !sampleMemory(out.memoryUsagePercent)) {
+            return false;
+        }
+        out.hasTemperature = sampleTemperature(out.temperatureCelsius);
+        if (!out.hasTemperature) out.temperatureCelsius = 0.0;
+        return true;
+    }
+
+    // Empty path disables publishing
+    void setPublishPath(const char* path) {
+        snprintf(publishPath_, sizeof(publishPath_), "%s", path);
+        snprintf(publishTempPath_, sizeof(publishTempPath_), "%s.tmp", path);
+    }
+
+    // Key=value lines for the dashboards (digem-pi5/host_metrics.py).
+    // Written to a temp file and renamed so readers never see a partial
+    // file.
+    bool publish(const HostMetricsSample& sample) {
+        if (publishPath_[0] == '\0') return false;
+        char text[256];
+        int length = snprintf(text, sizeof(text),
+                              "unix_time=%lld\ncpu_percent=%.1f\nmem_percent=%.1f\n"
+                              "temp_c=%.1f\nhas_temp=%d\n",
+                              static_cast<long long>(time(nullptr)), sample.cpuUsagePercent,
+                              sample.memoryUsagePercent, sample.temperatureCelsius,
+                              sample.hasTemperature ? 1 : 0);
+        int fd = open(publishTempPath_, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) return false;
+        bool written = write(fd, text, length) == length;
+        close(fd);
+        return written && rename(publishTempPath_, publishPath_) == 0;
+    }
+};
+
+#endif // HOST_METRICS_HPP
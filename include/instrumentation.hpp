@@ -0,0 +1,177 @@
+// Instrumentation
+#ifndef INSTRUMENTATION_HPP
+#define INSTRUMENTATION_HPP
+
+#include "scheduler.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+// Hot-path timing. Build with -DTBM_ENABLE_INSTRUMENTATION=0 to compile
+// every TBM_PROFILE_* / TBM_SCOPED_TIMER site out; the histograms stay
+// (empty) so status and dump code does not need its own #ifs.
+#ifndef TBM_ENABLE_INSTRUMENTATION
+#define TBM_ENABLE_INSTRUMENTATION 1
+#endif
+
+// Timestamp source: the ARM generic timer on the Pi (readable from user
+// space, one instruction), CLOCK_MONOTONIC elsewhere
+inline uint64_t instrumentationTicks() {
+#if defined(__aarch64__)
+    uint64_t ticks;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return static_cast<uint64_t>(monotonicNowNs());
+#endif
+}
+
+inline double instrumentationNsPerTick() {
+#if defined(__aarch64__)
+    uint64_t frequency;
+    asm volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+    return frequency ? 1e9 / static_cast<double>(frequency) : 1.0;
+#else
+    return 1.0;
+#endif
+}
+
+// Log-linear latency histogram: exact below 8 ns, then 8 buckets per
+// power of two (<= 12.5% bucket width) up to ~34 s. One writer thread
+// records; any thread may read. Counters are relaxed atomics, so the
+// writer never takes a lock or a locked RMW.
+class LatencyHistogram {
+public:
+    static constexpr size_t SUB_BUCKETS = 8;
+    static constexpr size_t BUCKET_COUNT = 34 * SUB_BUCKETS;
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets_;
+    std::atomic<uint64_t> count_;
+    std::atomic<uint64_t> sumNs_;
+    std::atomic<uint64_t> maxNs_;
+    double nsPerTick_;
+
+    static void bump(std::atomic<uint64_t>& counter, uint64_t amount) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount,
+                      std::memory_order_relaxed);
+    }
+
+public:
+    LatencyHistogram() : count_(0), sumNs_(0), maxNs_(0),
+                         nsPerTick_(instrumentationNsPerTick()) {
+        for (auto& bucket : buckets_) bucket.store(0, std::memory_order_relaxed);
+    }
+
+    static size_t bucketFor(uint64_t ns) {
+        if (ns < SUB_BUCKETS) return static_cast<size_t>(ns);
+        unsigned exponent = 63u - static_cast<unsigned>(__builtin_clzll(ns));
+        size_t index = (exponent - 2) * SUB_BUCKETS + ((ns >> (exponent - 3)) & (SUB_BUCKETS - 1));
+        return index < BUCKET_COUNT ? index : BUCKET_COUNT - 1;
+    }
+
+    // Largest value that falls in a bucket
+    static uint64_t bucketUpperNs(size_t index) {
+        if (index < SUB_BUCKETS) return index;
+        unsigned exponent = static_cast<unsigned>(index / SUB_BUCKETS) + 2;
+        uint64_t width = 1ULL << (exponent - 3);
+        return (SUB_BUCKETS + index % SUB_BUCKETS) * width + width - 1;
+    }
+
+    void recordNs(uint64_t ns) {
+        bump(buckets_[bucketFor(ns)], 1);
+        bump(count_, 1);
+        bump(sumNs_, ns);
+        if (ns > maxNs_.load(std::memory_order_relaxed)) {
+            maxNs_.store(ns, std::memory_order_relaxed);
+        }
+    }
+
+    void recordTicks(uint64_t ticks) {
+        recordNs(static_cast<uint64_t>(static_cast<double>(ticks) * nsPerTick_));
+    }
+
+    // Upper bound of the bucket holding the given quantile (0..1)
+    uint64_t percentileNs(double quantile) const {
+        uint64_t total = count_.load(std::memory_order_relaxed);
+        if (total == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(quantile * static_cast<double>(total - 1)) + 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; i++) {
+            seen += buckets_[i].load(std::memory_order_relaxed);
+            if (seen >= rank) return std::min(bucketUpperNs(i), getMaxNs());
+        }
+        return getMaxNs();
+    }
+
+    uint64_t getCount() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t getMaxNs() const { return maxNs_.load(std::memory_order_relaxed); }
+    double getMeanNs() const {
+        uint64_t count = getCount();
+        return count ? static_cast<double>(sumNs_.load(std::memory_order_relaxed)) / count : 0.0;
+    }
+
+    // Writer thread only (or while the writer is stopped)
+    void reset() {
+        for (auto& bucket : buckets_) bucket.store(0, std::memory_order_relaxed);
+        count_.store(0, std::memory_order_relaxed);
+        sumNs_.store(0, std::memory_order_relaxed);
+        maxNs_.store(0, std::memory_order_relaxed);
+    }
+
+    // "p50=12.3us p99=40.1us max=88.0us"
+    std::string summary() const {
+        char text[96];
+        snprintf(text, sizeof(text), "p50=%.1fus p99=%.1fus max=%.1fus n=%llu",
+                 percentileNs(0.50) / 1000.0, percentileNs(0.99) / 1000.0,
+                 getMaxNs() / 1000.0, static_cast<unsigned long long>(getCount()));
+        return text;
+    }
+
+    // {"count":N,"mean_us":..,"p50_us":..,"p90_us":..,"p99_us":..,"p999_us":..,"max_us":..}
+    std::string toJson() const {
+        char text[256];
+        snprintf(text, sizeof(text),
+                 "{\"count\":%llu,\"mean_us\":%.3f,\"p50_us\":%.3f,\"p90_us\":%.3f,"
+                 "\"p99_us\":%.3f,\"p999_us\":%.3f,\"max_us\":%.3f}",
+                 static_cast<unsigned long long>(getCount()), getMeanNs() / 1000.0,
+                 percentileNs(0.50) / 1000.0, percentileNs(0.90) / 1000.0,
+                 percentileNs(0.99) / 1000.0, percentileNs(0.999) / 1000.0,
+                 getMaxNs() / 1000.0);
+        return text;
+    }
+};
+
+// Records the lifetime of a scope into a histogram
+class ScopedTimer {
+private:
+    LatencyHistogram& histogram_;
+    uint64_t start_;
+
+public:
+    explicit ScopedTimer(LatencyHistogram& histogram)
+        : histogram_(histogram), start_(instrumentationTicks()) {}
+    ~ScopedTimer() { histogram_.recordTicks(instrumentationTicks() - start_); }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+};
+
+#define TBM_PROFILE_CONCAT_INNER(a, b) a##b
+#define TBM_PROFILE_CONCAT(a, b) TBM_PROFILE_CONCAT_INNER(a, b)
+
+#if TBM_ENABLE_INSTRUMENTATION
+#define TBM_PROFILE_TICKS() instrumentationTicks()
+#define TBM_PROFILE_RECORD(histogram, ticks) (histogram).recordTicks(ticks)
+#define TBM_SCOPED_TIMER(histogram) \
+    ScopedTimer TBM_PROFILE_CONCAT(scopedTimer_, __LINE__)(histogram)
+#else
+#define TBM_PROFILE_TICKS() uint64_t(0)
+#define TBM_PROFILE_RECORD(histogram, ticks) ((void)(ticks))
+#define TBM_SCOPED_TIMER(histogram) ((void)0)
+#endif
+
+#endif // INSTRUMENTATION_HPP
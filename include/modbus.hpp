@@ -0,0 +1,687 @@
+// ModbusEngine
+#ifndef MODBUS_HPP
+#define MODBUS_HPP
+
+#include "crc.hpp"
+#include "scheduler.hpp"
+#include "serial_port.hpp"
+#include "spsc_queue.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Modbus RTU/TCP master for the VFD, hydraulic and relay ECUs.
+//
+// Register polls are registered up front and merged into as few FC03/FC04
+// block reads as possible. A worker thread owns the bus: it cycles through
+// the blocks at the poll rate (pipelining TCP requests by transaction ID)
+// and stores every response in a per-block register image. The control
+// loop only reads that image and queues writes, so bus latency never
+// reaches it.
+
+enum class ModbusFunction : uint8_t {
+    READ_HOLDING_REGISTERS = 0x03,
+    READ_INPUT_REGISTERS = 0x04,
+    WRITE_SINGLE_REGISTER = 0x06
+};
+
+enum class ModbusTransport {
+    TCP,    // MBAP over TCP, "192.168.1.50" or "192.168.1.50:502"
+    RTU     // Serial, "/dev/ttyUSB0"
+};
+
+constexpr uint16_t MODBUS_MAX_READ_REGISTERS = 125;
+constexpr int MODBUS_TCP_PORT = 502;
+constexpr size_t MODBUS_MAX_ADU = 260;
+constexpr size_t MODBUS_MBAP_SIZE = 7;
+
+struct ModbusConfig {
+    double pollRateHz = 5.0;
+    int timeoutMs = 100;        // Per-transaction response timeout
+    size_t maxInFlight = 8;     // TCP pipeline depth
+    uint16_t maxGap = 4;        // Unpolled registers allowed inside a merged block
+};
+
+// One merged block read and its last-known register image
+struct ModbusBlock {
+    uint8_t unitId;
+    ModbusFunction function;
+    uint16_t start;
+    uint16_t count;
+    std::vector<uint16_t> registers;
+    int64_t updatedNs;          // 0 until the first good response
+    uint64_t errors;
+};
+
+// Resolved location of a register inside the block table
+struct ModbusRegisterRef {
+    int block = -1;
+    uint16_t offset = 0;
+    bool valid() const { return block >= 0; }
+};
+
+struct ModbusWrite {
+    uint8_t unitId;
+    uint16_t address;
+    uint16_t value;
+};
+
+class ModbusEngine {
+private:
+    struct PollRange {
+        uint8_t unitId;
+        ModbusFunction function;
+        uint16_t start;
+        uint16_t count;
+    };
+
+    struct InFlight {
+        uint16_t transactionId;
+        int block;              // -1 for a write
+        int64_t deadlineNs;
+        bool active;
+    };
+
+    enum class IoResult { OK, TIMEOUT, BAD_RESPONSE, IO_ERROR };
+
+    std::string address_;
+    ModbusTransport transport_;
+    std::string host_;
+    int port_;
+    int baud_;
+    ModbusConfig config_;
+
+    std::vector<PollRange> polls_;
+    std::vector<ModbusBlock> blocks_;
+    bool finalized_;
+    mutable std::mutex cacheMutex_;     // Guards block images and error counts
+
+    // Control thread -> worker
+    SPSCQueue<ModbusWrite, 64> writeQueue_;
+
+    // Worker-owned
+    int fd_;
+    uint16_t nextTransaction_;
+    std::vector<InFlight> inFlight_;
+    size_t activeCount_;
+    std::array<uint8_t, MODBUS_MAX_ADU * 2> rxBuffer_;
+    size_t rxLength_;
+    int64_t rtuGapNs_;
+
+    std::thread worker_;
+    std::atomic<bool> running_;
+    std::atomic<bool> connected_;
+    std::atomic<uint64_t> transactions_;
+    std::atomic<uint64_t> timeouts_;
+    std::atomic<uint64_t> exceptions_;
+    std::atomic<uint64_t> crcErrors_;
+
+public:
+    ModbusEngine(const std::string& address, int baud = 9600,
+                 const ModbusConfig& config = ModbusConfig{})
+        : address_(address), port_(MODBUS_TCP_PORT), baud_(baud), config_(config),
+          finalized_(false), fd_(-1), nextTransaction_(1), activeCount_(0),
+          rxLength_(0), running_(false), connected_(false), transactions_(0),
+          timeouts_(0), exceptions_(0), crcErrors_(0) {
+        if (address.rfind("/dev/", 0) == 0) {
+            transport_ = ModbusTransport::RTU;
+        } else {
+            transport_ = ModbusTransport::TCP;
+            size_t colon = address.find(':');
+            host_ = address.substr(0, colon);
+            if (colon != std::string::npos) {
+                port_ = std::atoi(address.c_str() + colon + 1);
+            }
+        }
+        // 3.5 character times of silence between RTU frames (11 bits/char),
+        // fixed at 1.75 ms above 19200 baud per the spec
+        rtuGapNs_ = baud_ > 19200 ? 1750000
+                                  : static_cast<int64_t>(3.5 * 11 * 1e9 / std::max(baud_, 1));
+    }
+
+    ~ModbusEngine() { stop(); }
+
+    ModbusEngine(const ModbusEngine&) = delete;
+    ModbusEngine& operator=(const ModbusEngine&) = delete;
+
+    // Register a range to poll. Must be called before start() or the
+    // first findRegister(); overlapping and adjacent ranges are merged.
+    bool addPoll(uint8_t unitId, ModbusFunction function, uint16_t start, uint16_t count = 1) {
+        if (finalized_ || count == 0 || count > MODBUS_MAX_READ_REGISTERS ||
+            function == ModbusFunction::WRITE_SINGLE_REGISTER) {
+            return false;
+        }
+        polls_.push_back({unitId, function, start, count});
+        return true;
+    }
+
+    // Resolve a polled register to its slot in the cache (setup time only)
+    ModbusRegisterRef findRegister(uint8_t unitId, ModbusFunction function, uint16_t address) {
+        finalize();
+        ModbusRegisterRef ref;
+        for (size_t i = 0; i < blocks_.size(); i++) {
+            const auto& block = blocks_[i];
+            if (block.unitId == unitId && block.function == function &&
+                address >= block.start && address < block.start + block.count) {
+                ref.block = static_cast<int>(i);
+                ref.offset = static_cast<uint16_t>(address - block.start);
+                break;
+            }
+        }
+        return ref;
+    }
+
+    // Last-known value of a register. Returns false until it has been read.
+    bool readRegister(const ModbusRegisterRef& ref, uint16_t& value,
+                      int64_t* updatedNs = nullptr) const {
+        if (!ref.valid()) return false;
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        const auto& block = blocks_[ref.block];
+        if (block.updatedNs == 0) return false;
+        value = block.registers[ref.offset];
+        if (updatedNs) *updatedNs = block.updatedNs;
+        return true;
+    }
+
+    // Time of the last good block reply from a unit (0 = none yet)
+    int64_t getLastReplyNs(uint8_t unitId) const {
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        int64_t lastNs = 0;
+        for (const auto& block : blocks_) {
+            if (block.unitId == unitId) lastNs = std::max(lastNs, block.updatedNs);
+        }
+        return lastNs;
+    }
+
+    // Queue an FC06 write (single producer: the control thread)
+    bool queueWrite(uint8_t unitId, uint16_t address, uint16_t value) {
+        return writeQueue_.tryPush({unitId, address, value});
+    }
+
+    bool start() {
+        if (running_) return true;
+        finalize();
+        inFlight_.assign(std::max<size_t>(config_.maxInFlight, 1), InFlight{0, -1, 0, false});
+        running_ = true;
+        worker_ = std::thread(&ModbusEngine::workerLoop, this);
+        return true;
+    }
+
+    void stop() {
+        bool wasRunning = running_.exchange(false);
+        if (worker_.joinable()) {
+            worker_.join();
+        }
+        // Last commands (e.g. zero setpoints from shutdown()) still go out
+        if (wasRunning && fd_ >= 0 && !writeQueue_.empty()) {
+            if (transport_ == ModbusTransport::TCP) {
+                pollCycleTcp(false);
+            } else {
+                pollCycleRtu(false);
+            }
+        }
+        disconnect();
+    }
+
+    bool isConnected() const { return connected_; }
+    ModbusTransport getTransport() const { return transport_; }
+    size_t getBlockCount() const { return blocks_.size(); }
+    size_t getPollCount() const { return polls_.size(); }
+    uint64_t getTransactions() const { return transactions_; }
+    uint64_t getTimeouts() const { return timeouts_; }
+    uint64_t getExceptions() const { return exceptions_; }
+    uint64_t getCrcErrors() const { return crcErrors_; }
+    uint64_t getWriteDropped() const { return writeQueue_.getOverflowCount(); }
+
+    std::string getStatus() const {
+        return "Modbus " + std::string(transport_ == ModbusTransport::TCP ? "TCP " : "RTU ") +
+               address_ + ": " + (connected_ ? "Connected" : "Disconnected") +
+               ", " + std::to_string(polls_.size()) + " polls in " +
+               std::to_string(blocks_.size()) + " blocks, txn=" +
+               std::to_string(transactions_.load()) + " timeouts=" +
+               std::to_string(timeouts_.load()) + " exceptions=" +
+               std::to_string(exceptions_.load()) +
+               (transport_ == ModbusTransport::RTU
+                    ? " crc=" + std::to_string(crcErrors_.load()) : std::string()) +
+               " writeDrops=" + std::to_string(getWriteDropped());
+    }
+
+private:
+    // Merge sorted poll ranges into block reads. Small gaps are read
+    // through because one request costs far more bus time than a few
+    // extra registers.
+    void finalize() {
+        if (finalized_) return;
+        finalized_ = true;
+
+        std::vector<PollRange> sorted = polls_;
+        std::sort(sorted.begin(), sorted.end(), [](const PollRange& a, const PollRange& b) {
+            if (a.unitId != b.unitId) return a.unitId < b.unitId;
+            if (a.function != b.function) return a.function < b.function;
+            return a.start < b.start;
+        });
+
+        for (const auto& poll : sorted) {
+            uint32_t pollEnd = static_cast<uint32_t>(poll.start) + poll.count;
+            if (!blocks_.empty()) {
+                auto& block = blocks_.back();
+                uint32_t blockEnd = static_cast<uint32_t>(block.start) + block.count;
+                uint32_t mergedEnd = std::max(blockEnd, pollEnd);
+                if (block.unitId == poll.unitId && block.function == poll.function &&
+                    poll.start <= blockEnd + config_.maxGap &&
+                    mergedEnd - block.start <= MODBUS_MAX_READ_REGISTERS) {
+                    block.count = static_cast<uint16_t>(mergedEnd - block.start);
+                    continue;
+                }
+            }
+            blocks_.push_back({poll.unitId, poll.function, poll.start, poll.count, {}, 0, 0});
+        }
+
+        for (auto& block : blocks_) {
+            block.registers.assign(block.count, 0);
+        }
+    }
+
+    static void putU16(uint8_t* out, uint16_t value) {
+        out[0] = static_cast<uint8_t>(value >> 8);
+        out[1] = static_cast<uint8_t>(value);
+    }
+
+    static uint16_t getU16(const uint8_t* in) {
+        return static_cast<uint16_t>((in[0] << 8) | in[1]);
+    }
+
+    static size_t buildReadPdu(const ModbusBlock& block, uint8_t* pdu) {
+        pdu[0] = static_cast<uint8_t>(block.function);
+        putU16(pdu + 1, block.start);
+        putU16(pdu + 3, block.count);
+        return 5;
+    }
+
+    static size_t buildWritePdu(const ModbusWrite& write, uint8_t* pdu) {
+        pdu[0] = static_cast<uint8_t>(ModbusFunction::WRITE_SINGLE_REGISTER);
+        putU16(pdu + 1, write.address);
+        putU16(pdu + 3, write.value);
+        return 5;
+    }
+
+    // Store a read response in the block image
+    void applyReadResponse(int blockIndex, const uint8_t* pdu, size_t length) {
+        auto& block = blocks_[blockIndex];
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        if (length >= 2 && (pdu[0] & 0x80)) {
+            exceptions_++;
+            block.errors++;
+            return;
+        }
+        size_t bytes = static_cast<size_t>(block.count) * 2;
+        if (length < 2 + bytes || pdu[0] != static_cast<uint8_t>(block.function) ||
+            pdu[1] != bytes) {
+            block.errors++;
+            return;
+        }
+        for (uint16_t i = 0; i < block.count; i++) {
+            block.registers[i] = getU16(pdu + 2 + i * 2);
+        }
+        block.updatedNs = monotonicNowNs();
+    }
+
+    void applyWriteResponse(const uint8_t* pdu, size_t length) {
+        if (length >= 2 && (pdu[0] & 0x80)) {
+            exceptions_++;
+        }
+    }
+
+    // ---- Worker --------------------------------------------------------
+
+    void workerLoop() {
+        const int64_t periodNs = static_cast<int64_t>(1e9 / std::max(config_.pollRateHz, 0.1));
+        int64_t nextPollNs = monotonicNowNs();
+
+        while (running_) {
+            if (fd_ < 0 && !connect()) {
+                sleepWhileRunning(1000000000LL);
+                continue;
+            }
+
+            bool ok = transport_ == ModbusTransport::TCP ? pollCycleTcp() : pollCycleRtu();
+            if (!ok) {
+                disconnect();
+                continue;
+            }
+
+            int64_t now = monotonicNowNs();
+            nextPollNs = std::max(nextPollNs + periodNs, now);
+
+            // Between poll cycles only commands go out, so a setpoint
+            // change does not wait for the next poll
+            while (running_ && now < nextPollNs) {
+                if (!writeQueue_.empty()) {
+                    ok = transport_ == ModbusTransport::TCP ? pollCycleTcp(false)
+                                                            : pollCycleRtu(false);
+                    if (!ok) break;
+                } else {
+                    sleepWhileRunning(std::min<int64_t>(nextPollNs - now, 5000000));
+                }
+                now = monotonicNowNs();
+            }
+            if (!ok) disconnect();
+        }
+    }
+
+    void sleepWhileRunning(int64_t durationNs) {
+        int64_t deadline = monotonicNowNs() + durationNs;
+        while (running_) {
+            int64_t remaining = deadline - monotonicNowNs();
+            if (remaining <= 0) break;
+            timespec ts = nsToTimespec(std::min<int64_t>(remaining, 50000000));
+            nanosleep(&ts, nullptr);
+        }
+    }
+
+    bool connect() {
+        if (transport_ == ModbusTransport::RTU) {
+            fd_ = openSerialPort(address_, baud_);
+        } else {
+            fd_ = connectTcp();
+        }
+        rxLength_ = 0;
+        activeCount_ = 0;
+        for (auto& slot : inFlight_) slot.active = false;
+        connected_ = fd_ >= 0;
+        return connected_;
+    }
+
+    void disconnect() {
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+        connected_ = false;
+    }
+
+    int connectTcp() {
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(port_));
+        if (inet_pton(AF_INET, host_.c_str(), &addr.sin_addr) != 1) return -1;
+
+        int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) return -1;
+
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            if (errno != EINPROGRESS) {
+                ::close(fd);
+                return -1;
+            }
+            pollfd pfd{fd, POLLOUT, 0};
+            int error = 0;
+            socklen_t len = sizeof(error);
+            if (::poll(&pfd, 1, 1000) != 1 ||
+                getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &len) != 0 || error != 0) {
+                ::close(fd);
+                return -1;
+            }
+        }
+
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        return fd;
+    }
+
+    bool writeAll(const uint8_t* data, size_t length) {
+        size_t written = 0;
+        while (written < length) {
+            ssize_t n = ::write(fd_, data + written, length - written);
+            if (n > 0) {
+                written += static_cast<size_t>(n);
+                continue;
+            }
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && errno == EAGAIN) {
+                pollfd pfd{fd_, POLLOUT, 0};
+                if (::poll(&pfd, 1, config_.timeoutMs) == 1) continue;
+            }
+            return false;
+        }
+        return true;
+    }
+
+    // Read into rxBuffer_ until something arrives or the deadline passes
+    IoResult readSome(int64_t deadlineNs) {
+        if (rxLength_ >= rxBuffer_.size()) return IoResult::BAD_RESPONSE;
+        int64_t remaining = deadlineNs - monotonicNowNs();
+        if (remaining <= 0) return IoResult::TIMEOUT;
+
+        pollfd pfd{fd_, POLLIN, 0};
+        int ready = ::poll(&pfd, 1, static_cast<int>(std::max<int64_t>(remaining / 1000000, 1)));
+        if (ready < 0) return errno == EINTR ? IoResult::TIMEOUT : IoResult::IO_ERROR;
+        if (ready == 0) return IoResult::TIMEOUT;
+        if (pfd.revents & (POLLERR | POLLHUP)) return IoResult::IO_ERROR;
+
+        ssize_t n = ::read(fd_, rxBuffer_.data() + rxLength_, rxBuffer_.size() - rxLength_);
+        if (n > 0) {
+            rxLength_ += static_cast<size_t>(n);
+            return IoResult::OK;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EINTR)) return IoResult::TIMEOUT;
+        return IoResult::IO_ERROR; // EOF or error
+    }
+
+    // ---- TCP: pipelined by transaction ID -----------------------------
+
+    bool sendTcp(uint8_t unitId, const uint8_t* pdu, size_t pduLength, int block) {
+        uint8_t adu[MODBUS_MAX_ADU];
+        uint16_t transactionId = nextTransaction_++;
+        putU16(adu, transactionId);
+        putU16(adu + 2, 0); // Protocol ID
+        putU16(adu + 4, static_cast<uint16_t>(pduLength + 1));
+        adu[6] = unitId;
+        std::memcpy(adu + MODBUS_MBAP_SIZE, pdu, pduLength);
+        if (!writeAll(adu, MODBUS_MBAP_SIZE + pduLength)) return false;
+
+        for (auto& slot : inFlight_) {
+            if (!slot.active) {
+                slot = {transactionId, block,
+                        monotonicNowNs() + config_.timeoutMs * 1000000LL, true};
+                activeCount_++;
+                break;
+            }
+        }
+        transactions_++;
+        return true;
+    }
+
+    // Issue every block read (and any queued writes) keeping up to
+    // maxInFlight requests outstanding; responses may arrive in any order
+    bool pollCycleTcp(bool includeReads = true) {
+        size_t nextBlock = includeReads ? 0 : blocks_.size();
+        size_t issued = 0;
+        size_t answered = 0;
+        uint8_t pdu[8];
+
+        // Bounded by the per-transaction timeout even when stopping
+        while (true) {
+            while (activeCount_ < inFlight_.size()) {
+                ModbusWrite write;
+                if (writeQueue_.tryPop(write)) {
+                    if (!sendTcp(write.unitId, pdu, buildWritePdu(write, pdu), -1)) return false;
+                } else if (nextBlock < blocks_.size()) {
+                    const auto& block = blocks_[nextBlock];
+                    int index = static_cast<int>(nextBlock++);
+                    if (!sendTcp(block.unitId, pdu, buildReadPdu(block, pdu), index)) return false;
+                } else {
+                    break;
+                }
+                issued++;
+            }
+            if (activeCount_ == 0) break;
+
+            int64_t deadline = INT64_MAX;
+            for (const auto& slot : inFlight_) {
+                if (slot.active) deadline = std::min(deadline, slot.deadlineNs);
+            }
+
+            IoResult result = readSome(deadline);
+            if (result == IoResult::IO_ERROR || result == IoResult::BAD_RESPONSE) return false;
+            if (result == IoResult::OK) {
+                size_t parsed = parseTcpResponses();
+                if (parsed == SIZE_MAX) return false;
+                answered += parsed;
+            }
+            expireInFlight();
+        }
+
+        // Nothing answered at all: the link is gone even if the socket is open
+        return issued == 0 || answered > 0;
+    }
+
+    // Consume complete MBAP frames from rxBuffer_. SIZE_MAX on a corrupt stream.
+    size_t parseTcpResponses() {
+        size_t handled = 0;
+        size_t offset = 0;
+        while (rxLength_ - offset >= MODBUS_MBAP_SIZE) {
+            const uint8_t* adu = rxBuffer_.data() + offset;
+            uint16_t length = getU16(adu + 4);
+            if (getU16(adu + 2) != 0 || length < 2 || length + 6u > MODBUS_MAX_ADU) {
+                return SIZE_MAX;
+            }
+            size_t total = 6u + length;
+            if (rxLength_ - offset < total) break;
+
+            uint16_t transactionId = getU16(adu);
+            for (auto& slot : inFlight_) {
+                if (slot.active && slot.transactionId == transactionId) {
+                    const uint8_t* pdu = adu + MODBUS_MBAP_SIZE;
+                    size_t pduLength = length - 1u;
+                    if (slot.block >= 0) {
+                        applyReadResponse(slot.block, pdu, pduLength);
+                    } else {
+                        applyWriteResponse(pdu, pduLength);
+                    }
+                    slot.active = false;
+                    activeCount_--;
+                    handled++;
+                    break;
+                }
+            }
+            offset += total; // Late replies to expired transactions are dropped
+        }
+        std::memmove(rxBuffer_.data(), rxBuffer_.data() + offset, rxLength_ - offset);
+        rxLength_ -= offset;
+        return handled;
+    }
+
+    void expireInFlight() {
+        int64_t now = monotonicNowNs();
+        for (auto& slot : inFlight_) {
+            if (slot.active && now >= slot.deadlineNs) {
+                slot.active = false;
+                activeCount_--;
+                timeouts_++;
+                if (slot.block >= 0) {
+                    std::lock_guard<std::mutex> lock(cacheMutex_);
+                    blocks_[slot.block].errors++;
+                }
+            }
+        }
+    }
+
+    // ---- RTU: one transaction at a time -------------------------------
+
+    // Send a PDU and read the reply PDU into `reply`. `expectedLength` is
+    // the normal reply PDU length; exception replies are recognized early.
+    IoResult transactRtu(uint8_t unitId, const uint8_t* pdu, size_t pduLength,
+                         size_t expectedLength, uint8_t*& reply, size_t& replyLength) {
+        uint8_t adu[MODBUS_MAX_ADU];
+        adu[0] = unitId;
+        std::memcpy(adu + 1, pdu, pduLength);
+        uint16_t crc = crc16Modbus(adu, pduLength + 1);
+        adu[pduLength + 1] = static_cast<uint8_t>(crc);
+        adu[pduLength + 2] = static_cast<uint8_t>(crc >> 8);
+
+        tcflush(fd_, TCIFLUSH);
+        rxLength_ = 0;
+        if (!writeAll(adu, pduLength + 3)) return IoResult::IO_ERROR;
+        tcdrain(fd_);
+        transactions_++;
+
+        // Bytes on the wire plus the device's own response time
+        int64_t deadline = monotonicNowNs() + config_.timeoutMs * 1000000LL;
+        size_t needed = 1 + expectedLength + 2;
+        while (rxLength_ < needed) {
+            IoResult result = readSome(deadline);
+            if (result != IoResult::OK) {
+                if (result == IoResult::TIMEOUT) timeouts_++;
+                return result;
+            }
+            if (rxLength_ >= 2 && (rxBuffer_[1] & 0x80)) {
+                needed = 5; // unit, function|0x80, code, CRC
+            }
+        }
+
+        uint16_t received = static_cast<uint16_t>(rxBuffer_[needed - 2] |
+                                                  (rxBuffer_[needed - 1] << 8));
+        if (received != crc16Modbus(rxBuffer_.data(), needed - 2)) {
+            crcErrors_++;
+            return IoResult::BAD_RESPONSE;
+        }
+        if (rxBuffer_[0] != unitId) return IoResult::BAD_RESPONSE;
+
+        reply = rxBuffer_.data() + 1;
+        replyLength = needed - 3;
+        return IoResult::OK;
+    }
+
+    // Inter-frame silence before the next request
+    void rtuGap() {
+        timespec ts = nsToTimespec(rtuGapNs_);
+        nanosleep(&ts, nullptr);
+    }
+
+    bool pollCycleRtu(bool includeReads = true) {
+        uint8_t pdu[8];
+        uint8_t* reply = nullptr;
+        size_t replyLength = 0;
+
+        ModbusWrite write;
+        while (writeQueue_.tryPop(write)) {
+            IoResult result = transactRtu(write.unitId, pdu, buildWritePdu(write, pdu), 5,
+                                          reply, replyLength);
+            if (result == IoResult::IO_ERROR) return false;
+            if (result == IoResult::OK) applyWriteResponse(reply, replyLength);
+            rtuGap();
+        }
+
+        for (size_t i = 0; includeReads && running_ && i < blocks_.size(); i++) {
+            const auto& block = blocks_[i];
+            IoResult result = transactRtu(block.unitId, pdu, buildReadPdu(block, pdu),
+                                          2 + static_cast<size_t>(block.count) * 2,
+                                          reply, replyLength);
+            if (result == IoResult::IO_ERROR) return false;
+            if (result == IoResult::OK) {
+                applyReadResponse(static_cast<int>(i), reply, replyLength);
+            } else {
+                std::lock_guard<std::mutex> lock(cacheMutex_);
+                blocks_[i].errors++;
+            }
+            rtuGap();
+        }
+        return true;
+    }
+};
+
+#endif // MODBUS_HPP
@@ -0,0 +1,73 @@
+// Orientation
+#ifndef ORIENTATION_HPP
+#define ORIENTATION_HPP
+
+#include <cmath>
+#include <cstddef>
+
+// Quaternion -> Euler conversion for the BNO08x game rotation vector.
+// Same convention as the Teensy sketch and digem-pi5/orientation.py:
+//   roll  = atan2(2(wx + yz), 1 - 2(x^2 + y^2))
+//   pitch = asin(2(wy - zx))
+//   yaw   = atan2(2(wz + xy), 1 - 2(y^2 + z^2))
+// in degrees. The kernel is branch-free float math (polynomial atan2,
+// selects instead of branches) so the batched form vectorizes.
+
+struct Quaternion {
+    float w, x, y, z;
+};
+
+struct EulerAngles {
+    float roll, pitch, yaw;    // Degrees
+};
+
+constexpr float ORIENTATION_PI = 3.14159265358979f;
+constexpr float ORIENTATION_RAD_TO_DEG = 180.0f / ORIENTATION_PI;
+
+// atan2 with a degree-11 odd minimax polynomial on [0, 1], max error
+// ~1e-5 rad. The batched loop vectorizes at -O3 with -fno-math-errno
+// -fno-trapping-math (NEON on the Pi, SSE on x86).
+inline float fastAtan2f(float y, float x) {
+    float ax = std::fabs(x);
+    float ay = std::fabs(y);
+    float hi = ax > ay ? ax : ay;
+    float lo = ax > ay ? ay : ax;
+    float t = lo / (hi + 1e-30f);
+    float t2 = t * t;
+    float r = t * (0.99997726f + t2 * (-0.33262347f + t2 * (0.19354346f +
+              t2 * (-0.11643287f + t2 * (0.05265332f + t2 * -0.01172120f)))));
+    r = ay > ax ? ORIENTATION_PI * 0.5f - r : r;
+    r = x < 0.0f ? ORIENTATION_PI - r : r;
+    return std::copysign(r, y);
+}
+
+inline EulerAngles quaternionToEuler(float w, float x, float y, float z) {
+    float sinPitch = 2.0f * (w * y - z * x);
+    sinPitch = sinPitch > 1.0f ? 1.0f : (sinPitch < -1.0f ? -1.0f : sinPitch);
+    float cosSquared = 1.0f - sinPitch * sinPitch;
+    float cosPitch = std::sqrt(cosSquared > 0.0f ? cosSquared : 0.0f);
+    return {
+        ORIENTATION_RAD_TO_DEG * fastAtan2f(2.0f * (w * x + y * z), 1.0f - 2.0f * (x * x + y * y)),
+        ORIENTATION_RAD_TO_DEG * fastAtan2f(sinPitch, cosPitch),   // asin via atan2
+        ORIENTATION_RAD_TO_DEG * fastAtan2f(2.0f * (w * z + x * y), 1.0f - 2.0f * (y * y + z * z))
+    };
+}
+
+inline EulerAngles quaternionToEuler(const Quaternion& q) {
+    return quaternionToEuler(q.w, q.x, q.y, q.z);
+}
+
+// Batched form over structure-of-arrays input (replay, logs, bulk samples)
+inline void quaternionsToEuler(const float* __restrict w, const float* __restrict x,
+                               const float* __restrict y, const float* __restrict z,
+                               float* __restrict roll, float* __restrict pitch,
+                               float* __restrict yaw, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        EulerAngles e = quaternionToEuler(w[i], x[i], y[i], z[i]);
+        roll[i] = e.roll;
+        pitch[i] = e.pitch;
+        yaw[i] = e.yaw;
+    }
+}
+
+#endif // ORIENTATION_HPP
@@ -0,0 +1,256 @@
+// PID
+#ifndef PID_HPP
+#define PID_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+struct PIDGains {
+    double kp;
+    double ki;                  // Per second
+    double kd;                  // Seconds
+    double outputMin;
+    double outputMax;
+    double slewRate;            // Max output change per second (0 = unlimited)
+    double derivativeCutoffHz;  // Low-pass on the derivative term (0 = none)
+};
+
+// Fixed-step discrete PID. Coefficients are folded with dt once in
+// configure(), so step() is a handful of multiply-adds and never allocates.
+//  - Derivative acts on the measurement, so setpoint steps do not kick
+//  - Integration stops while the output is saturated in the error's
+//    direction, and the integrator is clamped to the output range
+//  - Output is slew-limited after saturation
+//  - angleWrap treats error and measurement deltas as degrees in [-180, 180)
+template <typename T = double>
+class PIDController {
+private:
+    T kp_;
+    T kiDt_;
+    T kdOverDt_;
+    T derivativeAlpha_;
+    T outputMin_;
+    T outputMax_;
+    T maxStep_;                 // Per-step slew limit (0 = unlimited)
+    bool angleWrap_;
+
+    T integrator_;
+    T derivative_;
+    T lastMeasurement_;
+    T output_;
+    bool primed_;
+
+    static T wrap(T degrees) {
+        degrees = std::fmod(degrees + T(180), T(360));
+        if (degrees < T(0)) degrees += T(360);
+        return degrees - T(180);
+    }
+
+public:
+    PIDController()
+        : kp_(0), kiDt_(0), kdOverDt_(0), derivativeAlpha_(1), outputMin_(0),
+          outputMax_(0), maxStep_(0), angleWrap_(false) {
+        reset();
+    }
+
+    void configure(const PIDGains& gains, double dt, bool angleWrap = false) {
+        kp_ = static_cast<T>(gains.kp);
+        kiDt_ = static_cast<T>(gains.ki * dt);
+        kdOverDt_ = static_cast<T>(dt > 0.0 ? gains.kd / dt : 0.0);
+        outputMin_ = static_cast<T>(gains.outputMin);
+        outputMax_ = static_cast<T>(gains.outputMax);
+        maxStep_ = static_cast<T>(gains.slewRate * dt);
+        angleWrap_ = angleWrap;
+
+        // First-order low-pass: alpha = dt / (RC + dt)
+        derivativeAlpha_ = T(1);
+        if (gains.derivativeCutoffHz > 0.0) {
+            double rc = 1.0 / (2.0 * M_PI * gains.derivativeCutoffHz);
+            derivativeAlpha_ = static_cast<T>(dt / (rc + dt));
+        }
+        reset();
+    }
+
+    // Clear state, holding output until the first step()
+    void reset(T output = T(0)) {
+        integrator_ = std::clamp(output, outputMin_, outputMax_);
+        derivative_ = T(0);
+        lastMeasurement_ = T(0);
+        output_ = integrator_;
+        primed_ = false;
+    }
+
+    // Bumpless (re-)engage at the current output: the integrator takes
+    // what the proportional and first integral terms will not add, so the
+    // first step() at this setpoint and measurement returns output, and
+    // the derivative starts from the measurement instead of kicking
+    void reset(T output, T setpoint, T measurement) {
+        reset(output);
+        T error = setpoint - measurement;
+        if (angleWrap_) error = wrap(error);
+        integrator_ = std::clamp(output_ - (kp_ + kiDt_) * error, outputMin_, outputMax_);
+        lastMeasurement_ = measurement;
+        primed_ = true;
+    }
+
+    T step(T setpoint, T measurement, T feedForward = T(0)) {
+        T error = setpoint - measurement;
+        if (angleWrap_) error = wrap(error);
+
+        if (primed_) {
+            T delta = measurement - lastMeasurement_;
+            if (angleWrap_) delta = wrap(delta);
+            derivative_ += derivativeAlpha_ * (-kdOverDt_ * delta - derivative_);
+        }
+        lastMeasurement_ = measurement;
+        primed_ = true;
+
+        T proportional = kp_ * error;
+        T candidate = std::clamp(integrator_ + kiDt_ * error, outputMin_, outputMax_);
+        T unsaturated = proportional + candidate + derivative_ + feedForward;
+
+        // Conditional integration: keep the new integrator value only if it
+        // does not drive an already saturated output further
+        bool saturatedHigh = unsaturated > outputMax_ && error > T(0);
+        bool saturatedLow = unsaturated < outputMin_ && error < T(0);
+        if (!saturatedHigh && !saturatedLow) {
+            integrator_ = candidate;
+        }
+
+        T output = std::clamp(proportional + integrator_ + derivative_ + feedForward,
+                              outputMin_, outputMax_);
+        if (maxStep_ > T(0)) {
+            output = std::clamp(output, output_ - maxStep_, output_ + maxStep_);
+        }
+        output_ = output;
+        return output;
+    }
+
+    T getOutput() const { return output_; }
+    T getIntegrator() const { return integrator_; }
+    // Input of the last step() (valid once stepped or engaged)
+    T getLastMeasurement() const { return lastMeasurement_; }
+    bool isPrimed() const { return primed_; }
+};
+
+// One closed loop: a sensor value (or one channel of a multi-axis sensor)
+// driving one actuator through a PID at its own rate-group rate
+struct ControlLoopConfig {
+    std::string name;
+    std::string sensor;         // Sensor component name
+    int channel;                // readVector() channel, -1 = readValue()
+    std::string actuator;       // Actuator component name
+    PIDGains gains;
+    double rateHz;
+    bool angleWrap;
+};
+
+struct ControlLoop {
+    ControlLoopConfig config;
+    size_t sensorIndex;
+    size_t actuatorIndex;
+    double dt;                  // Effective step of the loop's rate group
+    PIDController<double> pid;
+    double setpoint;
+    double output;
+    bool enabled;
+    bool bound;
+};
+
+// Named control loops. Names are resolved to component indices once at
+// setup; each loop then runs as a CONTROL task in its rate group.
+class ControllerRegistry {
+private:
+    std::vector<ControlLoop> loops_;
+
+public:
+    // Register before initialize(); returns false for a duplicate name
+    bool addLoop(const ControlLoopConfig& config) {
+        if (find(config.name)) return false;
+        ControlLoop loop{};
+        loop.config = config;
+        loops_.push_back(loop);
+        return true;
+    }
+
+    ControlLoop* find(const std::string& name) {
+        for (auto& loop : loops_) {
+            if (loop.config.name == name) return &loop;
+        }
+        return nullptr;
+    }
+
+    const ControlLoop* find(const std::string& name) const {
+        for (const auto& loop : loops_) {
+            if (loop.config.name == name) return &loop;
+        }
+        return nullptr;
+    }
+
+    // Precompute the PID coefficients for the loop's effective rate
+    void bind(ControlLoop& loop, size_t sensorIndex, size_t actuatorIndex, double rateHz) {
+        loop.sensorIndex = sensorIndex;
+        loop.actuatorIndex = actuatorIndex;
+        loop.dt = 1.0 / rateHz;
+        loop.pid.configure(loop.config.gains, loop.dt, loop.config.angleWrap);
+        loop.bound = true;
+    }
+
+    // Engaging resets the PID from the actuator's current command and the
+    // loop's measurement at its setpoint (bumpless). Without a finite
+    // measurement the PID only holds the command.
+    bool setEnabled(const std::string& name, bool enabled, double currentCommand = 0.0,
+                    double measurement = NAN) {
+        ControlLoop* loop = find(name);
+        if (!loop) return false;
+        if (enabled && !loop->enabled) {
+            if (std::isfinite(measurement)) {
+                loop->pid.reset(currentCommand, loop->setpoint, measurement);
+            } else {
+                loop->pid.reset(currentCommand);
+            }
+        }
+        loop->enabled = enabled;
+        return true;
+    }
+
+    bool setSetpoint(const std::string& name, double setpoint) {
+        ControlLoop* loop = find(name);
+        if (!loop) return false;
+        loop->setpoint = setpoint;
+        return true;
+    }
+
+    // Retune a bound loop in place, keeping its output (bumpless: the
+    // new gains are seeded at the setpoint and last measurement)
+    bool setGains(const std::string& name, double kp, double ki, double kd) {
+        ControlLoop* loop = find(name);
+        if (!loop) return false;
+        loop->config.gains.kp = kp;
+        loop->config.gains.ki = ki;
+        loop->config.gains.kd = kd;
+        if (loop->bound) {
+            bool primed = loop->pid.isPrimed();
+            double measurement = loop->pid.getLastMeasurement();
+            loop->pid.configure(loop->config.gains, loop->dt, loop->config.angleWrap);
+            if (primed) {
+                loop->pid.reset(loop->output, loop->setpoint, measurement);
+            } else {
+                loop->pid.reset(loop->output);
+            }
+        }
+        return true;
+    }
+
+    bool isEnabled(const std::string& name) const {
+        const ControlLoop* loop = find(name);
+        return loop && loop->enabled;
+    }
+
+    std::vector<ControlLoop>& getLoops() { return loops_; }
+    const std::vector<ControlLoop>& getLoops() const { return loops_; }
+};
+
+#endif // PID_HPP
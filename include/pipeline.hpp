@@ -0,0 +1,159 @@
+// Pipeline
+#ifndef PIPELINE_HPP
+#define PIPELINE_HPP
+
+#include "base.hpp"
+#include "rate_groups.hpp"
+#include "scheduler.hpp"
+#include "snapshot.hpp"
+#include "spsc_queue.hpp"
+#include <atomic>
+#include <cstring>
+#include <future>
+#include <thread>
+
+// Threads of the pipelined control system (TM_ControlSystem::setPipeline):
+//   control  the caller's thread at the highest priority: commands,
+//            sensors, snapshot, safety, control loops, actuators
+//   I/O      every comm interface: update, receive and send
+//   logging  telemetry recorder and downlink encoding
+// Each runs its own rate groups off its own scheduler and beats a
+// ThreadHeartbeat per cycle for SafetyMonitor. They share nothing but
+// the SPSC queues below, so a stalled link or SD card never delays the
+// safety check.
+
+// A frame to or from the comm interface at index `link`
+struct LinkFrame {
+    uint32_t link;
+    CommFrame frame;
+};
+
+constexpr size_t LINK_QUEUE_FRAMES = 64;
+constexpr size_t SNAPSHOT_QUEUE_DEPTH = 256;    // 256 ms of cycles at 1 kHz
+
+using LinkQueue = SPSCQueue<LinkFrame, LINK_QUEUE_FRAMES>;
+using SnapshotQueue = SPSCQueue<SystemSnapshot, SNAPSHOT_QUEUE_DEPTH>;
+
+// False if the queue is full (counted as its overflow). Received frames
+// carry their receive time.
+inline bool pushLinkFrame(LinkQueue& queue, uint32_t link, std::span<const uint8_t> data,
+                          int64_t timestampNs = 0) {
+    if (data.empty() || data.size() > MAX_FRAME_SIZE) return false;
+    return queue.tryEmplace([link, &data, timestampNs](LinkFrame& slot) {
+        slot.link = link;
+        slot.frame.length = static_cast<uint16_t>(data.size());
+        std::memcpy(slot.frame.data, data.data(), data.size());
+        slot.frame.timestampNs = timestampNs;
+    });
+}
+
+// Control-thread stand-in for a link the I/O thread owns: send() queues
+// the frame and the I/O thread makes the real send()
+class QueuedLink : public ICommunicationInterface {
+private:
+    std::shared_ptr<ICommunicationInterface> link_;
+    uint32_t index_;
+    LinkQueue& queue_;
+
+public:
+    QueuedLink(std::shared_ptr<ICommunicationInterface> link, uint32_t index, LinkQueue& queue)
+        : link_(std::move(link)), index_(index), queue_(queue) {}
+
+    bool initialize() override { return true; }
+    bool update() override { return true; }
+    bool shutdown() override { return true; }
+
+    using ICommunicationInterface::send;
+
+    bool send(std::span<const uint8_t> data) override {
+        return pushLinkFrame(queue_, index_, data);
+    }
+
+    // Received frames come through the system's inbound queue
+    size_t receiveInto(std::span<uint8_t> buffer) override {
+        (void)buffer;
+        return 0;
+    }
+
+    bool isConnected() const override { return link_->isConnected(); }
+    std::string getStatus() const override { return "Queued " + link_->getComponentName(); }
+    std::string getComponentName() const override { return link_->getComponentName(); }
+};
+
+struct PipelineThreadConfig {
+    double rateHz;                  // Base rate of the thread's rate groups
+    RealtimeConfig realtime;
+    int64_t heartbeatTimeoutNs;     // SafetyMonitor flags the thread after this long without a cycle
+};
+
+// One pipeline thread: its rate groups run on a PeriodicScheduler of
+// their own. Tasks are added to getExecutor() before start().
+class PipelineWorker {
+private:
+    std::string name_;
+    PipelineThreadConfig config_;
+    RateGroupExecutor executor_;
+    ThreadHeartbeat heartbeat_;
+    std::thread thread_;
+    std::atomic<bool> running_;
+    bool realtimeApplied_;
+    std::string schedulerStatus_;   // Written by the thread as it exits
+
+public:
+    PipelineWorker(const std::string& name, const PipelineThreadConfig& config)
+        : name_(name), config_(config), executor_(config.rateHz), running_(false),
+          realtimeApplied_(false) {
+        executor_.initialize();
+    }
+
+    ~PipelineWorker() { stop(); }
+
+    // Starts the thread and waits until its realtime settings are in
+    // place; false if requested settings could not be applied
+    bool start() {
+        if (thread_.joinable()) return false;
+        std::promise<bool> ready;
+        std::future<bool> applied = ready.get_future();
+        running_ = true;
+        thread_ = std::thread([this, ready = std::move(ready)]() mutable {
+            PeriodicScheduler scheduler(config_.rateHz, config_.realtime);
+            scheduler.initialize();
+            ready.set_value(scheduler.isRealtime());
+            heartbeat_.beat(monotonicNowNs());
+            while (running_.load(std::memory_order_relaxed)) {
+                scheduler.waitForNextCycle();
+                executor_.runCycle();
+                heartbeat_.beat(monotonicNowNs());
+            }
+            scheduler.shutdown();
+            schedulerStatus_ = scheduler.getStatus();
+        });
+        realtimeApplied_ = applied.get();
+        return realtimeApplied_ || !realtimeRequested(config_.realtime);
+    }
+
+    void stop() {
+        running_ = false;
+        if (thread_.joinable()) thread_.join();
+    }
+
+    RateGroupExecutor& getExecutor() { return executor_; }
+    const RateGroupExecutor& getExecutor() const { return executor_; }
+    const ThreadHeartbeat& getHeartbeat() const { return heartbeat_; }
+    const PipelineThreadConfig& getConfig() const { return config_; }
+    const std::string& getName() const { return name_; }
+    bool isRunning() const { return thread_.joinable(); }
+
+    // Scheduler statistics once stopped, the cycle count while running
+    std::string getStatus() const {
+        if (!schedulerStatus_.empty() && !thread_.joinable()) {
+            return name_ + " thread: " + schedulerStatus_;
+        }
+        return name_ + " thread " + std::to_string(static_cast<int>(config_.rateHz)) + " Hz" +
+               (realtimeApplied_ ? " [RT]" : "") + ": " +
+               (thread_.joinable() ? std::to_string(heartbeat_.getBeatCount()) + " cycles"
+                                   : std::string("not running"));
+    }
+};
+
+#endif // PIPELINE_HPP
@@ -0,0 +1,229 @@
+// RateGroups
+#ifndef RATE_GROUPS_HPP
+#define RATE_GROUPS_HPP
+
+#include "base.hpp"
+#include "instrumentation.hpp"
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <algorithm>
+
+// Stages of one control cycle. Within a cycle every due group runs its
+// tasks stage by stage, so a slow sensor sampled this cycle is still read
+// before safety and control run.
+enum class TaskStage : uint8_t {
+    COMMAND,            // Apply queued surface commands before anything reads state
+    ECU_HEALTH,
+    SENSOR_READ,
+    SNAPSHOT,           // Freeze this cycle's samples for every consumer
+    SAFETY,
+    CONTROL,
+    ACTUATOR_UPDATE,
+    COMMUNICATION,
+    HOUSEKEEPING
+};
+
+constexpr size_t TASK_STAGE_COUNT = 9;
+
+inline const char* taskStageName(size_t stage) {
+    static const char* const NAMES[TASK_STAGE_COUNT] = {
+        "COMMAND", "ECU_HEALTH", "SENSOR_READ", "SNAPSHOT", "SAFETY",
+        "CONTROL", "ACTUATOR_UPDATE", "COMMUNICATION", "HOUSEKEEPING"
+    };
+    return stage < TASK_STAGE_COUNT ? NAMES[stage] : "UNKNOWN";
+}
+
+struct RateTask {
+    std::string name;
+    std::function<void()> run;
+};
+
+// A set of tasks that runs every `divisor` base cycles
+class RateGroup {
+private:
+    uint32_t divisor_;
+    uint32_t phase_;
+    double rateHz_;
+    std::array<std::vector<RateTask>, TASK_STAGE_COUNT> stages_;
+    uint64_t runCount_;
+
+public:
+    RateGroup(uint32_t divisor, uint32_t phase, double rateHz)
+        : divisor_(divisor), phase_(phase), rateHz_(rateHz), runCount_(0) {}
+
+    void addTask(TaskStage stage, const std::string& name, std::function<void()> run) {
+        stages_[static_cast<size_t>(stage)].push_back({name, std::move(run)});
+    }
+
+    bool isDue(uint64_t cycle) const { return cycle % divisor_ == phase_; }
+
+    void runStage(size_t stage) {
+        for (auto& task : stages_[stage]) {
+            task.run();
+        }
+    }
+
+    void markRun() { runCount_++; }
+
+    size_t getTaskCount() const {
+        size_t count = 0;
+        for (const auto& stage : stages_) count += stage.size();
+        return count;
+    }
+
+    uint32_t getDivisor() const { return divisor_; }
+    uint32_t getPhase() const { return phase_; }
+    double getRateHz() const { return rateHz_; }
+    uint64_t getRunCount() const { return runCount_; }
+};
+
+// Executes harmonic rate groups off a single base-rate tick.
+// Each group runs at baseRate / N for an integer N; a component is placed
+// in the fastest group that does not exceed its declared rate, so devices
+// are never polled faster than they can answer.
+// Each stage (summed over the due groups) and the whole cycle are timed
+// into latency histograms; one timestamp per stage boundary.
+class RateGroupExecutor : public ISystemComponent {
+private:
+    double baseRateHz_;
+    std::vector<std::unique_ptr<RateGroup>> groups_;   // Fastest first
+    std::vector<uint8_t> dueThisCycle_;
+    uint64_t cycle_;
+    std::array<LatencyHistogram, TASK_STAGE_COUNT> stageTimes_;
+    LatencyHistogram cycleTime_;
+
+public:
+    explicit RateGroupExecutor(double baseRateHz)
+        : baseRateHz_(baseRateHz), cycle_(0) {}
+
+    bool initialize() override {
+        cycle_ = 0;
+        return true;
+    }
+
+    bool update() override {
+        runCycle();
+        return true;
+    }
+
+    bool shutdown() override { return true; }
+
+    // Get (or create) the group for a requested rate. A rate of 0 or
+    // anything at/above the base rate maps to the base group.
+    RateGroup& groupForRate(double rateHz) {
+        uint32_t divisor = 1;
+        if (rateHz > 0.0 && rateHz < baseRateHz_) {
+            divisor = static_cast<uint32_t>(std::ceil(baseRateHz_ / rateHz - 1e-9));
+        }
+
+        for (auto& group : groups_) {
+            if (group->getDivisor() == divisor) return *group;
+        }
+
+        // Offset each new slow group's phase so they don't all land on cycle 0
+        uint32_t phase = static_cast<uint32_t>(groups_.size()) % divisor;
+        groups_.push_back(std::make_unique<RateGroup>(divisor, phase,
+                                                      baseRateHz_ / divisor));
+        std::sort(groups_.begin(), groups_.end(),
+                  [](const auto& a, const auto& b) {
+                      return a->getDivisor() < b->getDivisor();
+                  });
+        dueThisCycle_.resize(groups_.size());
+
+        for (auto& group : groups_) {
+            if (group->getDivisor() == divisor) return *group;
+        }
+        return *groups_.front();
+    }
+
+    // Returns the rate the task will actually run at
+    double addTask(double rateHz, TaskStage stage, const std::string& name,
+                   std::function<void()> run) {
+        RateGroup& group = groupForRate(rateHz);
+        group.addTask(stage, name, std::move(run));
+        return group.getRateHz();
+    }
+
+    // Run one base-rate cycle
+    void runCycle() {
+        uint64_t cycleStart = TBM_PROFILE_TICKS();
+        for (size_t g = 0; g < groups_.size(); g++) {
+            dueThisCycle_[g] = groups_[g]->isDue(cycle_);
+        }
+
+        uint64_t stageStart = TBM_PROFILE_TICKS();
+        for (size_t stage = 0; stage < TASK_STAGE_COUNT; stage++) {
+            for (size_t g = 0; g < groups_.size(); g++) {
+                if (dueThisCycle_[g]) groups_[g]->runStage(stage);
+            }
+            uint64_t stageEnd = TBM_PROFILE_TICKS();
+            TBM_PROFILE_RECORD(stageTimes_[stage], stageEnd - stageStart);
+            stageStart = stageEnd;
+        }
+
+        for (size_t g = 0; g < groups_.size(); g++) {
+            if (dueThisCycle_[g]) groups_[g]->markRun();
+        }
+        TBM_PROFILE_RECORD(cycleTime_, TBM_PROFILE_TICKS() - cycleStart);
+        cycle_++;
+    }
+
+    double getBaseRateHz() const { return baseRateHz_; }
+    uint64_t getCycleCount() const { return cycle_; }
+    const std::vector<std::unique_ptr<RateGroup>>& getGroups() const { return groups_; }
+    const LatencyHistogram& getStageTiming(TaskStage stage) const {
+        return stageTimes_[static_cast<size_t>(stage)];
+    }
+    const LatencyHistogram& getCycleTiming() const { return cycleTime_; }
+
+    // One line per stage plus the whole cycle, for status output
+    std::string getTimingStatus() const {
+        std::string status;
+        for (size_t stage = 0; stage < TASK_STAGE_COUNT; stage++) {
+            char line[48];
+            snprintf(line, sizeof(line), "%-16s", taskStageName(stage));
+            status += line + stageTimes_[stage].summary() + "\n";
+        }
+        char line[48];
+        snprintf(line, sizeof(line), "%-16s", "CYCLE");
+        status += line + cycleTime_.summary();
+        return status;
+    }
+
+    // {"base_rate_hz":..,"cycles":..,"stages":{"ECU_HEALTH":{...},...},"cycle":{...}}
+    std::string getTimingJson() const {
+        char header[96];
+        snprintf(header, sizeof(header), "{\"base_rate_hz\":%.6g,\"cycles\":%llu,\"stages\":{",
+                 baseRateHz_, static_cast<unsigned long long>(cycle_));
+        std::string json = header;
+        for (size_t stage = 0; stage < TASK_STAGE_COUNT; stage++) {
+            if (stage > 0) json += ",";
+            json += "\"" + std::string(taskStageName(stage)) + "\":" + stageTimes_[stage].toJson();
+        }
+        json += "},\"cycle\":" + cycleTime_.toJson() + "}";
+        return json;
+    }
+
+    void resetTiming() {
+        for (auto& histogram : stageTimes_) histogram.reset();
+        cycleTime_.reset();
+    }
+
+    std::string getStatus() const override {
+        std::string status = "Rate groups:";
+        for (const auto& group : groups_) {
+            char rate[32];
+            snprintf(rate, sizeof(rate), " %.4g Hz", group->getRateHz());
+            status += rate;
+            status += " (" + std::to_string(group->getTaskCount()) + " tasks)";
+        }
+        return status;
+    }
+
+    std::string getComponentName() const override { return "RateGroupExecutor"; }
+};
+
+#endif // RATE_GROUPS_HPP
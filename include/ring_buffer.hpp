@@ -0,0 +1,143 @@
+// RingBuffer
+#ifndef RING_BUFFER_HPP
+#define RING_BUFFER_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+// Fixed-capacity circular buffer. Pushing into a full buffer overwrites
+// the oldest element. No allocation after construction.
+template <typename T, size_t N>
+class RingBuffer {
+    static_assert(N > 0, "RingBuffer capacity must be non-zero");
+
+private:
+    std::array<T, N> data_;
+    size_t head_;   // Index of the oldest element
+    size_t count_;
+
+public:
+    RingBuffer() : data_{}, head_(0), count_(0) {}
+
+    // Returns the element that was overwritten (T{} if none)
+    T push(const T& value) {
+        T evicted{};
+        if (count_ < N) {
+            data_[(head_ + count_) % N] = value;
+            count_++;
+        } else {
+            evicted = data_[head_];
+            data_[head_] = value;
+            head_ = (head_ + 1) % N;
+        }
+        return evicted;
+    }
+
+    // 0 = oldest, size() - 1 = newest
+    const T& operator[](size_t index) const { return data_[(head_ + index) % N]; }
+    const T& back() const { return (*this)[count_ - 1]; }
+
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    bool full() const { return count_ == N; }
+    void clear() { head_ = 0; count_ = 0; }
+    static constexpr size_t capacity() { return N; }
+
+    // Copy contents oldest-first into out (must hold size() elements)
+    void copyTo(T* out) const {
+        for (size_t i = 0; i < count_; i++) out[i] = (*this)[i];
+    }
+};
+
+// Filter policies for FilteredSensor. Each takes raw samples with push()
+// and answers value() without touching its state, so the filtered value
+// can be read any number of times per cycle.
+
+// Moving average over the last N samples with an O(1) running sum. The
+// sum is rebuilt from the window every RESUM_INTERVAL samples so rounding
+// error cannot accumulate at kHz sample rates.
+template <size_t N>
+class RunningMeanFilter {
+private:
+    static constexpr size_t RESUM_INTERVAL = 1024;
+
+    RingBuffer<double, N> window_;
+    double sum_;
+    size_t sinceResum_;
+
+public:
+    RunningMeanFilter() : sum_(0.0), sinceResum_(0) {}
+
+    void push(double sample) {
+        bool wasFull = window_.full();
+        double evicted = window_.push(sample);
+        sum_ += sample - (wasFull ? evicted : 0.0);
+
+        if (++sinceResum_ >= RESUM_INTERVAL) {
+            sum_ = 0.0;
+            for (size_t i = 0; i < window_.size(); i++) sum_ += window_[i];
+            sinceResum_ = 0;
+        }
+    }
+
+    double value() const { return window_.empty() ? 0.0 : sum_ / window_.size(); }
+    size_t count() const { return window_.size(); }
+    void reset() { window_.clear(); sum_ = 0.0; sinceResum_ = 0; }
+};
+
+// Exponential moving average, alpha = 2 / (N + 1) (N-sample span).
+// The first sample seeds the average.
+template <size_t N>
+class EmaFilter {
+private:
+    static constexpr double ALPHA = 2.0 / (N + 1.0);
+
+    double average_;
+    size_t count_;
+
+public:
+    EmaFilter() : average_(0.0), count_(0) {}
+
+    void push(double sample) {
+        average_ = count_ == 0 ? sample : average_ + ALPHA * (sample - average_);
+        if (count_ < N) count_++;
+    }
+
+    double value() const { return average_; }
+    size_t count() const { return count_; }
+    void reset() { average_ = 0.0; count_ = 0; }
+};
+
+// Median of the last N samples (rejects single-sample spikes). The
+// median is computed when a sample arrives, so value() is O(1).
+template <size_t N>
+class MedianFilter {
+private:
+    RingBuffer<double, N> window_;
+    double median_;
+
+public:
+    MedianFilter() : median_(0.0) {}
+
+    void push(double sample) {
+        window_.push(sample);
+        std::array<double, N> sorted;
+        size_t size = window_.size();
+        window_.copyTo(sorted.data());
+        auto middle = sorted.begin() + size / 2;
+        std::nth_element(sorted.begin(), middle, sorted.begin() + size);
+        if (size % 2 == 1) {
+            median_ = *middle;
+        } else {
+            double lower = *std::max_element(sorted.begin(), middle);
+            median_ = (lower + *middle) / 2.0;
+        }
+    }
+
+    double value() const { return median_; }
+    size_t count() const { return window_.size(); }
+    void reset() { window_.clear(); median_ = 0.0; }
+};
+
+#endif // RING_BUFFER_HPP
@@ -5,59 +5,92 @@
 #include "base.hpp"
 #include "sensors.hpp"
 #include "actuators.hpp"
+#include "scheduler.hpp"
+#include "snapshot.hpp"
 #include <vector>
 #include <memory>
-#include <functional>
-
-struct SafetyLimit {
-    std::string name;
-    std::function<double()> getValue;
-    double minValue;
-    double maxValue;
-    bool isActive;
-};
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+constexpr size_t SAFETY_MAX_LIMITS = 64;    // One bit per limit in the violation mask
+constexpr size_t SAFETY_MAX_HEARTBEATS = 8;
 
+// Limit checks over the cycle's SystemSnapshot. Limits are compiled into
+// parallel min/max/source arrays and every limit is evaluated on each
+// pass, so all active violations are reported, not just the first. A
+// missing or unhealthy sensor reads as NaN and violates its limits.
+// Evaluation runs inline (evaluate() from the control thread) or on the
+// monitor's own thread reading the published snapshot. Only the
+// interlock latch and violation masks cross threads: actuators are
+// zeroed by the control thread in applyInterlock().
+// Each pass also checks the watched thread heartbeats. A heartbeat is
+// stale once it has not beaten within its timeout (it is watched from
+// its first beat); a critical one latches the interlock like a limit.
 class SafetyMonitor : public ISystemComponent {
 private:
-    std::vector<SafetyLimit> limits_;
+    // Limit table (structure of arrays, fixed once evaluation starts)
+    std::vector<std::string> names_;
+    std::vector<uint32_t> sources_;
+    std::vector<double> minValues_;
+    std::vector<double> maxValues_;
+
+    // Evaluation scratch (owned by whichever thread evaluates)
+    std::vector<double> limitValues_;
+    std::vector<uint8_t> violated_;
+
+    std::array<std::atomic<double>, SAFETY_MAX_LIMITS> violationValues_;
+    std::atomic<uint64_t> activeMask_;      // Limits violated on the last pass
+    std::atomic<uint64_t> tripMask_;        // Limits violated since the latch was set
+    std::atomic<bool> interlockLatched_;
+    std::atomic<bool> emergencyStop_;       // Operator e-stop latched the interlock
+    std::atomic<uint64_t> evaluations_;
+
+    // Watched thread heartbeats (fixed once evaluation starts)
+    struct HeartbeatWatch {
+        std::string name;
+        const ThreadHeartbeat* heartbeat;
+        int64_t timeoutNs;
+    };
+    std::vector<HeartbeatWatch> heartbeats_;
+    uint32_t criticalHeartbeats_;           // Mask of the ones that latch
+    std::array<std::atomic<int64_t>, SAFETY_MAX_HEARTBEATS> heartbeatAgeNs_;
+    std::atomic<uint32_t> staleMask_;       // Stale on the last pass
+    std::atomic<uint32_t> heartbeatTripMask_;   // Critical ones stale since the latch was set
+
     std::vector<std::shared_ptr<IActuator>> controlledActuators_;
-    bool systemSafe_;
-    std::string lastViolation_;
+
+    std::thread thread_;
+    std::atomic<bool> threadRunning_;
+    double threadRateHz_;
 
 public:
-    SafetyMonitor() : systemSafe_(true) {}
+    SafetyMonitor()
+        : activeMask_(0), tripMask_(0), interlockLatched_(false), emergencyStop_(false),
+          evaluations_(0), criticalHeartbeats_(0), staleMask_(0), heartbeatTripMask_(0),
+          threadRunning_(false), threadRateHz_(0.0) {
+        for (auto& value : violationValues_) value.store(0.0, std::memory_order_relaxed);
+        for (auto& age : heartbeatAgeNs_) age.store(0, std::memory_order_relaxed);
+    }
+
+    ~SafetyMonitor() { stopThread(); }
 
     bool initialize() override {
-        systemSafe_ = true;
+        activeMask_ = 0;
+        tripMask_ = 0;
+        interlockLatched_ = false;
+        emergencyStop_ = false;
+        staleMask_ = 0;
+        heartbeatTripMask_ = 0;
         return true;
     }
 
-    bool update() override {
-        systemSafe_ = true;
-        
-        for (auto& limit : limits_) {
-            double value = limit.getValue();
-            
-            if (value < limit.minValue || value > limit.maxValue) {
-                systemSafe_ = false;
-                lastViolation_ = limit.name + " out of range: " + 
-                                std::to_string(value);
-                limit.isActive = true;
-                
-                // Trigger interlocks
-                for (auto& actuator : controlledActuators_) {
-                    actuator->setCommand(0.0);
-                }
-                break;
-            } else {
-                limit.isActive = false;
-            }
-        }
-        
-        return true;
-    }
+    // Limits are evaluated by evaluate() or the monitor thread
+    bool update() override { return true; }
 
     bool shutdown() override {
+        stopThread();
         // Safe shutdown of all actuators
         for (auto& actuator : controlledActuators_) {
             actuator->shutdown();
@@ -65,24 +98,207 @@ public:
         return true;
     }
 
-    void addLimit(const std::string& name, 
-                  std::function<double()> getValue,
+    // Bind a limit to a snapshot sensor slot. Not allowed once the monitor thread runs.
+    bool addLimit(const std::string& name, size_t sensorIndex,
                   double minVal, double maxVal) {
-        limits_.push_back({name, getValue, minVal, maxVal, false});
+        if (names_.size() >= SAFETY_MAX_LIMITS || sensorIndex >= SNAPSHOT_MAX_SENSORS ||
+            threadRunning_) {
+            return false;
+        }
+        names_.push_back(name);
+        sources_.push_back(static_cast<uint32_t>(sensorIndex));
+        minValues_.push_back(minVal);
+        maxValues_.push_back(maxVal);
+        limitValues_.push_back(0.0);
+        violated_.push_back(0);
+        return true;
+    }
+
+    // Watch a thread's heartbeat; it must outlive the monitor's evaluation.
+    // Not allowed once the monitor thread runs.
+    bool watchHeartbeat(const std::string& name, const ThreadHeartbeat& heartbeat,
+                        int64_t timeoutNs, bool critical) {
+        if (heartbeats_.size() >= SAFETY_MAX_HEARTBEATS || timeoutNs <= 0 || threadRunning_) {
+            return false;
+        }
+        if (critical) criticalHeartbeats_ |= 1u << heartbeats_.size();
+        heartbeats_.push_back({name, &heartbeat, timeoutNs});
+        return true;
     }
 
     void addActuator(std::shared_ptr<IActuator> actuator) {
         controlledActuators_.push_back(actuator);
     }
 
-    bool isSystemSafe() const { return systemSafe_; }
-    std::string getLastViolation() const { return lastViolation_; }
+    // Evaluate on a dedicated thread reading the published snapshot.
+    // While it runs, evaluate() from the control thread is a no-op.
+    bool startThread(double rateHz, const SnapshotBuffer& source,
+                     const RealtimeConfig& rtConfig = {0, -1, false}) {
+        if (threadRunning_ || rateHz <= 0.0) return false;
+        threadRateHz_ = rateHz;
+        threadRunning_ = true;
+        thread_ = std::thread([this, rateHz, &source, rtConfig]() {
+            PeriodicScheduler scheduler(rateHz, rtConfig);
+            scheduler.initialize();
+            SystemSnapshot snapshot;
+            while (threadRunning_) {
+                scheduler.waitForNextCycle();
+                if (source.read(snapshot) != 0) {
+                    check(snapshot);
+                }
+            }
+        });
+        return true;
+    }
+
+    // Inline evaluation from the control thread
+    void evaluate(const SystemSnapshot& snapshot) {
+        if (!threadRunning_) check(snapshot);
+    }
+
+    void stopThread() {
+        threadRunning_ = false;
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    // Control thread: hold every actuator at zero while latched
+    void applyInterlock() {
+        for (auto& actuator : controlledActuators_) {
+            actuator->setCommand(0.0);
+        }
+    }
+
+    // Operator e-stop (any thread): latches the interlock like a tripped
+    // limit until resetInterlock()
+    void emergencyStop() {
+        emergencyStop_.store(true, std::memory_order_relaxed);
+        interlockLatched_.store(true, std::memory_order_release);
+    }
+
+    // Clear the latch once no limit is violated and every critical
+    // heartbeat is back
+    bool resetInterlock() {
+        if (activeMask_.load(std::memory_order_acquire) != 0 ||
+            (staleMask_.load(std::memory_order_acquire) & criticalHeartbeats_) != 0) {
+            return false;
+        }
+        emergencyStop_ = false;
+        tripMask_ = 0;
+        heartbeatTripMask_ = 0;
+        interlockLatched_.store(false, std::memory_order_release);
+        return true;
+    }
+
+    bool isInterlockLatched() const { return interlockLatched_.load(std::memory_order_acquire); }
+    bool isSystemSafe() const { return !isInterlockLatched(); }
+    bool isEmergencyStopped() const { return emergencyStop_.load(std::memory_order_acquire); }
+    uint64_t getViolationMask() const { return activeMask_.load(std::memory_order_acquire); }
+    uint64_t getTripMask() const { return tripMask_.load(std::memory_order_acquire); }
+    uint64_t getEvaluationCount() const { return evaluations_.load(std::memory_order_relaxed); }
+    uint32_t getStaleHeartbeats() const { return staleMask_.load(std::memory_order_acquire); }
+    bool isCriticalHeartbeat(uint32_t mask) const { return (mask & criticalHeartbeats_) != 0; }
+    size_t getLimitCount() const { return names_.size(); }
+    const std::string& getLimitName(size_t index) const { return names_[index]; }
+
+    // Every active violation, or the limits that tripped the latch
+    std::string getLastViolation() const {
+        uint64_t mask = getViolationMask();
+        if (mask == 0) mask = getTripMask();
+        uint32_t heartbeats = getStaleHeartbeats() & criticalHeartbeats_;
+        if (heartbeats == 0) heartbeats = heartbeatTripMask_.load(std::memory_order_acquire);
+        if (mask == 0 && heartbeats == 0 && isEmergencyStopped()) return "Emergency stop";
+        std::string text = describe(mask);
+        std::string threads = describeHeartbeats(heartbeats);
+        if (!text.empty() && !threads.empty()) text += "; ";
+        return text + threads;
+    }
+
+    std::string describe(uint64_t mask) const {
+        std::string text;
+        for (size_t i = 0; i < names_.size(); i++) {
+            if (!(mask & (1ULL << i))) continue;
+            if (!text.empty()) text += "; ";
+            text += names_[i] + " out of range: " +
+                    std::to_string(violationValues_[i].load(std::memory_order_relaxed));
+        }
+        return text;
+    }
+
+    std::string describeHeartbeats(uint32_t mask) const {
+        std::string text;
+        for (size_t i = 0; i < heartbeats_.size(); i++) {
+            if (!(mask & (1u << i))) continue;
+            if (!text.empty()) text += "; ";
+            text += heartbeats_[i].name + " thread heartbeat lost (" +
+                    std::to_string(heartbeatAgeNs_[i].load(std::memory_order_relaxed) / 1000000) +
+                    " ms)";
+        }
+        return text;
+    }
 
     std::string getStatus() const override {
-        return systemSafe_ ? "System Safe" : "FAULT: " + lastViolation_;
+        std::string mode = threadRunning_
+            ? " [thread " + std::to_string(static_cast<int>(threadRateHz_)) + " Hz]" : "";
+        if (isSystemSafe()) return "System Safe" + mode;
+        return "FAULT: " + getLastViolation() + mode;
     }
 
     std::string getComponentName() const override { return "SafetyMonitor"; }
+
+private:
+    void check(const SystemSnapshot& snapshot) {
+        const size_t count = names_.size();
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+
+        // Gather, then a branch-free compare over contiguous arrays.
+        // The negated form also flags NaN (missing or unhealthy source).
+        for (size_t i = 0; i < count; i++) {
+            uint32_t source = sources_[i];
+            limitValues_[i] = source < snapshot.sensorCount && snapshot.sensorHealthy[source]
+                                  ? snapshot.sensorValues[source] : nan;
+        }
+        const double* values = limitValues_.data();
+        const double* mins = minValues_.data();
+        const double* maxs = maxValues_.data();
+        uint8_t* violated = violated_.data();
+        for (size_t i = 0; i < count; i++) {
+            violated[i] = !(values[i] >= mins[i] && values[i] <= maxs[i]);
+        }
+
+        uint64_t mask = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (violated[i]) {
+                mask |= 1ULL << i;
+                violationValues_[i].store(values[i], std::memory_order_relaxed);
+            }
+        }
+
+        activeMask_.store(mask, std::memory_order_release);
+        if (mask != 0) {
+            tripMask_.fetch_or(mask, std::memory_order_relaxed);
+            interlockLatched_.store(true, std::memory_order_release);
+        }
+        if (!heartbeats_.empty()) checkHeartbeats(monotonicNowNs());
+        evaluations_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void checkHeartbeats(int64_t nowNs) {
+        uint32_t stale = 0;
+        for (size_t i = 0; i < heartbeats_.size(); i++) {
+            int64_t last = heartbeats_[i].heartbeat->getLastBeatNs();
+            if (last != 0 && nowNs - last > heartbeats_[i].timeoutNs) {
+                stale |= 1u << i;
+                heartbeatAgeNs_[i].store(nowNs - last, std::memory_order_relaxed);
+            }
+        }
+        staleMask_.store(stale, std::memory_order_release);
+        if (stale & criticalHeartbeats_) {
+            heartbeatTripMask_.fetch_or(stale & criticalHeartbeats_, std::memory_order_relaxed);
+            interlockLatched_.store(true, std::memory_order_release);
+        }
+    }
 };
 
-#endif
\ No newline at end of file
+#endif
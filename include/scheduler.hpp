@@ -0,0 +1,198 @@
+// Scheduler
+#ifndef SCHEDULER_HPP
+#define SCHEDULER_HPP
+
+#include "base.hpp"
+#include <cstdint>
+#include <cerrno>
+#include <algorithm>
+#include <atomic>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+#include <sys/mman.h>
+
+// Timing helpers (CLOCK_MONOTONIC, nanoseconds)
+inline int64_t monotonicNowNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+inline timespec nsToTimespec(int64_t ns) {
+    timespec ts;
+    ts.tv_sec = static_cast<time_t>(ns / 1000000000LL);
+    ts.tv_nsec = static_cast<long>(ns % 1000000000LL);
+    return ts;
+}
+
+// Realtime options for the thread that runs the scheduler
+struct RealtimeConfig {
+    int fifoPriority;   // SCHED_FIFO priority (1-99), 0 = keep SCHED_OTHER
+    int cpuCore;        // Pin to this core, -1 = no pinning
+    bool lockMemory;    // mlockall() to avoid page faults in the loop
+};
+
+inline bool realtimeRequested(const RealtimeConfig& config) {
+    return config.fifoPriority > 0 || config.cpuCore >= 0 || config.lockMemory;
+}
+
+// Liveness of a periodic thread. The thread beats once per completed
+// cycle; any other thread can read when it last did (0 = not started).
+class ThreadHeartbeat {
+private:
+    std::atomic<int64_t> lastBeatNs_;
+    std::atomic<uint64_t> beats_;
+
+public:
+    ThreadHeartbeat() : lastBeatNs_(0), beats_(0) {}
+
+    ThreadHeartbeat(const ThreadHeartbeat&) = delete;
+    ThreadHeartbeat& operator=(const ThreadHeartbeat&) = delete;
+
+    // Owning thread only
+    void beat(int64_t nowNs) {
+        beats_.store(beats_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        lastBeatNs_.store(nowNs, std::memory_order_release);
+    }
+
+    int64_t getLastBeatNs() const { return lastBeatNs_.load(std::memory_order_acquire); }
+    uint64_t getBeatCount() const { return beats_.load(std::memory_order_relaxed); }
+};
+
+// Periodic scheduler built on absolute deadlines.
+// The next deadline is always advanced by exactly one period, so the
+// loop does not drift, and the thread sleeps in clock_nanosleep() until
+// the deadline instead of polling.
+class PeriodicScheduler : public ISystemComponent {
+private:
+    int64_t periodNs_;
+    RealtimeConfig rtConfig_;
+    int64_t nextDeadlineNs_;
+    bool realtimeApplied_;
+    bool running_;
+
+    // Statistics
+    uint64_t cycleCount_;
+    uint64_t overrunCount_;     // Cycles that started after their deadline
+    uint64_t skippedCycles_;    // Whole periods dropped to catch up
+    int64_t lastJitterNs_;
+    int64_t maxJitterNs_;
+
+public:
+    PeriodicScheduler(double rateHz, const RealtimeConfig& rtConfig = {0, -1, false})
+        : periodNs_(static_cast<int64_t>(1e9 / rateHz)), rtConfig_(rtConfig),
+          nextDeadlineNs_(0), realtimeApplied_(false), running_(false),
+          cycleCount_(0), overrunCount_(0), skippedCycles_(0),
+          lastJitterNs_(0), maxJitterNs_(0) {}
+
+    // Must be called from the thread that will run the loop, since the
+    // priority and affinity settings apply to the calling thread
+    bool initialize() override {
+        realtimeApplied_ = applyRealtimeConfig();
+        resetStatistics();
+        nextDeadlineNs_ = monotonicNowNs() + periodNs_;
+        running_ = true;
+        return true;
+    }
+
+    bool update() override {
+        return waitForNextCycle();
+    }
+
+    bool shutdown() override {
+        running_ = false;
+        return true;
+    }
+
+    // Block until the start of the next cycle
+    bool waitForNextCycle() {
+        if (!running_) return false;
+
+        int64_t now = monotonicNowNs();
+        int64_t lateNs = now - nextDeadlineNs_;
+
+        if (lateNs > 0) {
+            // Previous cycle ran past this deadline: start immediately and
+            // skip any fully missed periods instead of bursting to catch up
+            overrunCount_++;
+            int64_t missed = lateNs / periodNs_;
+            if (missed > 0) {
+                skippedCycles_ += missed;
+                nextDeadlineNs_ += missed * periodNs_;
+            }
+        } else {
+            timespec deadline = nsToTimespec(nextDeadlineNs_);
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME,
+                                   &deadline, nullptr) == EINTR) {}
+            now = monotonicNowNs();
+        }
+
+        lastJitterNs_ = now - nextDeadlineNs_;
+        maxJitterNs_ = std::max(maxJitterNs_, lastJitterNs_);
+
+        nextDeadlineNs_ += periodNs_;
+        cycleCount_++;
+        return true;
+    }
+
+    void resetStatistics() {
+        cycleCount_ = 0;
+        overrunCount_ = 0;
+        skippedCycles_ = 0;
+        lastJitterNs_ = 0;
+        maxJitterNs_ = 0;
+    }
+
+    // Getters
+    int64_t getPeriodNs() const { return periodNs_; }
+    double getRateHz() const { return 1e9 / periodNs_; }
+    uint64_t getCycleCount() const { return cycleCount_; }
+    uint64_t getOverrunCount() const { return overrunCount_; }
+    uint64_t getSkippedCycles() const { return skippedCycles_; }
+    int64_t getLastJitterNs() const { return lastJitterNs_; }
+    int64_t getMaxJitterNs() const { return maxJitterNs_; }
+    bool isRealtime() const { return realtimeApplied_; }
+
+    std::string getStatus() const override {
+        return "Scheduler " + std::to_string(static_cast<int>(getRateHz())) + " Hz" +
+               (realtimeApplied_ ? " [RT]" : "") +
+               ": cycles=" + std::to_string(cycleCount_) +
+               " overruns=" + std::to_string(overrunCount_) +
+               " skipped=" + std::to_string(skippedCycles_) +
+               " maxJitter=" + std::to_string(maxJitterNs_ / 1000) + "us";
+    }
+
+    std::string getComponentName() const override { return "PeriodicScheduler"; }
+
+private:
+    bool applyRealtimeConfig() {
+        bool ok = true;
+
+        if (rtConfig_.lockMemory) {
+            if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) ok = false;
+        }
+
+        if (rtConfig_.cpuCore >= 0) {
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            CPU_SET(rtConfig_.cpuCore, &cpuset);
+            if (pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset) != 0) {
+                ok = false;
+            }
+        }
+
+        if (rtConfig_.fifoPriority > 0) {
+            sched_param param{};
+            param.sched_priority = rtConfig_.fifoPriority;
+            // Needs CAP_SYS_NICE (run as root or set rtprio in limits.conf)
+            if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0) {
+                ok = false;
+            }
+        }
+
+        return ok && realtimeRequested(rtConfig_);
+    }
+};
+
+#endif // SCHEDULER_HPP
@@ -3,34 +3,57 @@
 #define SENSORS_HPP
 
 #include "base.hpp"
-#include <deque>
+#include "ring_buffer.hpp"
+#include "orientation.hpp"
+#include "scheduler.hpp"
+#include "status_format.hpp"
+#include "teensy_protocol.hpp"
 #include <algorithm>
-#include <numeric>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/gpio.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
 
-// Concrete sensor implementations
-class PressureSensor : public ISensor {
-private:
+// Scalar sensor with a compile-time filter policy (see ring_buffer.hpp).
+// update() takes one raw sample and feeds the filter; readValue() only
+// reads the filtered value, so it can be called any number of times per
+// cycle without changing it.
+template <typename Filter>
+class FilteredSensor : public ISensor {
+protected:
     std::string name_;
-    double currentValue_;
+    double currentValue_;       // Latest raw sample
     double calibrationOffset_;
     bool healthy_;
-    std::deque<double> historyBuffer_;
-    static constexpr size_t BUFFER_SIZE = 10;
+    Filter filter_;
+
+    // Read one raw sample from hardware (placeholder)
+    // In real implementation, read from ADC/I2C
+    virtual bool sample(double& raw) {
+        raw = currentValue_;
+        return healthy_;
+    }
 
 public:
-    PressureSensor(const std::string& name) 
-        : name_(name), currentValue_(0.0), 
+    FilteredSensor(const std::string& name)
+        : name_(name), currentValue_(0.0),
           calibrationOffset_(0.0), healthy_(false) {}
 
     bool initialize() override {
         healthy_ = true;
+        filter_.reset();
         return true;
     }
 
     bool update() override {
-        // Read from hardware (placeholder)
-        // In real implementation, read from ADC/I2C
-        return healthy_;
+        double raw = 0.0;
+        if (!sample(raw)) return false;
+        currentValue_ = raw;
+        filter_.push(raw + calibrationOffset_);
+        return true;
     }
 
     bool shutdown() override {
@@ -39,82 +62,337 @@ public:
     }
 
     double readValue() override {
-        if (historyBuffer_.size() >= BUFFER_SIZE) {
-            historyBuffer_.pop_front();
-        }
-        historyBuffer_.push_back(currentValue_ + calibrationOffset_);
-        
-        // Return filtered value (moving average)
-        return std::accumulate(historyBuffer_.begin(), 
-                              historyBuffer_.end(), 0.0) / historyBuffer_.size();
+        return filter_.count() > 0 ? filter_.value() : currentValue_ + calibrationOffset_;
+    }
+
+    bool isHealthy() const override { return healthy_; }
+    std::string getStatus() const override { return statusText(*this); }
+
+    size_t formatStatus(char* buffer, size_t size) const override {
+        StatusWriter out(buffer, size);
+        return out.text(name_).text(": ").fixed(currentValue_).text(" ").text(getUnits()).length();
     }
+    std::string getComponentName() const override { return name_; }
+};
+
+// Concrete sensor implementations
+class PressureSensor : public FilteredSensor<RunningMeanFilter<10>> {
+public:
+    PressureSensor(const std::string& name) : FilteredSensor(name) {}
 
     bool calibrate() override {
         calibrationOffset_ = -currentValue_;
+        filter_.reset();
         return true;
     }
 
-    bool isHealthy() const override { return healthy_; }
     std::string getUnits() const override { return "PSI"; }
-    std::string getStatus() const override { 
-        return name_ + ": " + std::to_string(currentValue_) + " " + getUnits();
-    }
-    std::string getComponentName() const override { return name_; }
 };
 
-class TemperatureSensor : public ISensor {
-private:
-    std::string name_;
-    double currentValue_;
-    bool healthy_;
-
+// Median of 3 rejects single bad conversions at the 1 Hz read rate
+class TemperatureSensor : public FilteredSensor<MedianFilter<3>> {
 public:
-    TemperatureSensor(const std::string& name) 
-        : name_(name), currentValue_(0.0), healthy_(false) {}
+    TemperatureSensor(const std::string& name) : FilteredSensor(name) {}
 
-    bool initialize() override { healthy_ = true; return true; }
-    bool update() override { return healthy_; }
-    bool shutdown() override { healthy_ = false; return true; }
-    double readValue() override { return currentValue_; }
     bool calibrate() override { return true; }
-    bool isHealthy() const override { return healthy_; }
     std::string getUnits() const override { return "°C"; }
-    std::string getStatus() const override { 
-        return name_ + ": " + std::to_string(currentValue_) + " " + getUnits();
-    }
-    std::string getComponentName() const override { return name_; }
 };
 
+// Orientation from the Teensy BNO08x node. The sketch streams game
+// rotation vector quaternions (IMU_QUATERNION packets); the control
+// system hands them to ingestQuaternion() and update() converts the
+// latest one to Euler angles. readValue() is yaw, readVector() returns
+// every axis at once. Each quaternion comes with the time the node took
+// it, on the Pi clock once the node's clock is synced (time_sync.hpp).
 class IMUSensor : public ISensor {
+public:
+    enum Channel : size_t { ROLL, PITCH, YAW, QUAT_W, QUAT_X, QUAT_Y, QUAT_Z, CHANNEL_COUNT };
+
 private:
+    static constexpr int64_t STALE_TIMEOUT_NS = 200000000LL; // 20 missed 100 Hz reports
+
     std::string name_;
     struct IMUData {
         double roll, pitch, yaw;
-        double accelX, accelY, accelZ;
+        Quaternion quaternion;
     } data_;
+    Quaternion pending_;
+    bool hasPending_;
+    int64_t lastSampleNs_;      // Of the latest quaternion
+    int64_t sampleNs_;          // Of the one in data_
+    bool initialized_;
     bool healthy_;
 
+    uint8_t lastSequence_;
+    uint64_t samples_;
+    uint64_t droppedSamples_;
+
 public:
     IMUSensor(const std::string& name) 
-        : name_(name), healthy_(false) {
-        data_ = {0, 0, 0, 0, 0, 0};
+        : name_(name), pending_{1, 0, 0, 0}, hasPending_(false), lastSampleNs_(0),
+          sampleNs_(0), initialized_(false), healthy_(false), lastSequence_(0), samples_(0),
+          droppedSamples_(0) {
+        data_ = {0, 0, 0, {1, 0, 0, 0}};
+    }
+
+    bool initialize() override { initialized_ = true; return true; }
+
+    bool update() override { return updateAt(monotonicNowNs()); }
+
+    // Healthy while quaternions keep arriving. Sample times are on the
+    // cycle's clock, so staleness is measured against it too.
+    bool updateAt(int64_t cycleNs) override {
+        if (hasPending_) {
+            EulerAngles euler = quaternionToEuler(pending_);
+            data_ = {euler.roll, euler.pitch, euler.yaw, pending_};
+            sampleNs_ = lastSampleNs_;
+            hasPending_ = false;
+        }
+        healthy_ = initialized_ && samples_ > 0 &&
+                   cycleNs - lastSampleNs_ < STALE_TIMEOUT_NS;
+        return healthy_;
+    }
+
+    bool shutdown() override { initialized_ = false; healthy_ = false; return true; }
+
+    // Called from the communication stage for every IMU_QUATERNION packet,
+    // with the time the sample was taken
+    void ingestQuaternion(const QuaternionSample& sample, int64_t timestampNs) {
+        if (samples_ > 0) {
+            droppedSamples_ += static_cast<uint8_t>(sample.sequence - lastSequence_ - 1);
+        }
+        lastSequence_ = sample.sequence;
+        samples_++;
+        pending_ = {sample.w, sample.x, sample.y, sample.z};
+        hasPending_ = true;
+        lastSampleNs_ = timestampNs;
     }
 
-    bool initialize() override { healthy_ = true; return true; }
-    bool update() override { return healthy_; }
-    bool shutdown() override { healthy_ = false; return true; }
     double readValue() override { return data_.yaw; } // Return primary value
+    int64_t getSampleTimeNs() const override { return sampleNs_; }
+
+    size_t getChannelCount() const override { return CHANNEL_COUNT; }
+
+    size_t readVector(std::span<double> out) override {
+        const double values[CHANNEL_COUNT] = {
+            data_.roll, data_.pitch, data_.yaw,
+            data_.quaternion.w, data_.quaternion.x, data_.quaternion.y, data_.quaternion.z
+        };
+        size_t count = std::min(out.size(), static_cast<size_t>(CHANNEL_COUNT));
+        std::copy(values, values + count, out.begin());
+        return count;
+    }
+
     bool calibrate() override { return true; }
     bool isHealthy() const override { return healthy_; }
     std::string getUnits() const override { return "degrees"; }
-    std::string getStatus() const override { 
-        return name_ + ": R=" + std::to_string(data_.roll) + 
-               " P=" + std::to_string(data_.pitch) + 
-               " Y=" + std::to_string(data_.yaw);
+    std::string getStatus() const override { return statusText(*this); }
+
+    size_t formatStatus(char* buffer, size_t size) const override {
+        StatusWriter out(buffer, size);
+        out.text(name_).text(": R=").fixed(data_.roll).text(" P=").fixed(data_.pitch)
+           .text(" Y=").fixed(data_.yaw).text(" samples=").number(samples_)
+           .text(" dropped=").number(droppedSamples_);
+        return out.length();
     }
     std::string getComponentName() const override { return name_; }
     
     IMUData getData() const { return data_; }
+    uint64_t getSampleCount() const { return samples_; }
+    uint64_t getDroppedSamples() const { return droppedSamples_; }
+};
+
+// FL-608 slurry flow meter on a GPIO line (open collector, pull-up).
+// F = 7.5 * Q with Q in L/min, i.e. 450 pulses per litre. Falling edges
+// come from the gpiochip character device (GPIO v2 uAPI) with kernel
+// CLOCK_MONOTONIC timestamps; update() drains them in batches and takes
+// the rate from the inter-pulse periods, so a 100 Hz read rate gives
+// sub-second resolution instead of a 1 s counting window. Between edges
+// the rate is bounded by the time since the last one, so it decays to
+// zero when the flow stops. readValue() is L/min.
+class FlowSensor : public ISensor {
+public:
+    enum Channel : size_t { FLOW_LPM, TOTAL_LITERS, PULSE_HZ, CHANNEL_COUNT };
+
+private:
+    static constexpr uint32_t DEBOUNCE_US = 1000;               // Half-period at 30 L/min is 2.2 ms
+    static constexpr uint32_t KERNEL_EVENT_BUFFER = 256;
+    static constexpr size_t EVENT_BATCH = 32;
+    static constexpr int64_t STOP_TIMEOUT_NS = 2000000000LL;   // No edge for 2 s = no flow
+
+    std::string name_;
+    std::string chipPath_;
+    int line_;                  // -1 = not wired on this tool
+    double pulsesPerLiter_;
+    int lineFd_;
+    int lineError_;             // errno of the failed line request (0 = open)
+    bool healthy_;
+
+    uint64_t pulses_;
+    uint64_t missedEdges_;      // Kernel event buffer overflows (seqno gaps)
+    uint32_t lastSeqno_;
+    int64_t lastEdgeNs_;        // 0 = no edge yet
+    int64_t periodNs_;          // Mean period of the latest batch
+    double pulseHz_;
+    double totalOffset_;        // Pulses at the last calibrate()
+
+    void closeLine() {
+        if (lineFd_ >= 0) ::close(lineFd_);
+        lineFd_ = -1;
+    }
+
+public:
+    // Chip and line from the tool's topology (Topology::gpioChip and the
+    // meter's channel on the main controller)
+    FlowSensor(const std::string& name, const std::string& chipPath = "/dev/gpiochip0",
+               int line = 17, double pulsesPerLiter = 450.0)
+        : name_(name), chipPath_(chipPath), line_(line), pulsesPerLiter_(pulsesPerLiter),
+          lineFd_(-1), lineError_(0), healthy_(false), pulses_(0), missedEdges_(0),
+          lastSeqno_(0), lastEdgeNs_(0), periodNs_(0), pulseHz_(0.0), totalOffset_(0.0) {}
+
+    ~FlowSensor() override { closeLine(); }
+
+    // A missing chip or line does not fail startup: the sensor stays
+    // unhealthy, so its limits see NaN and latch the interlock
+    bool initialize() override {
+        closeLine();
+        healthy_ = false;
+        lineError_ = line_ < 0 ? ENODEV : 0;
+        if (lineError_ != 0) return true;
+        int chipFd = ::open(chipPath_.c_str(), O_RDONLY | O_CLOEXEC);
+        if (chipFd < 0) {
+            lineError_ = errno;
+            return true;
+        }
+
+        gpio_v2_line_request request{};
+        request.offsets[0] = static_cast<uint32_t>(line_);
+        request.num_lines = 1;
+        std::snprintf(request.consumer, sizeof(request.consumer), "tbm-%s", name_.c_str());
+        request.config.flags = GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_EDGE_FALLING |
+                               GPIO_V2_LINE_FLAG_BIAS_PULL_UP;
+        request.config.num_attrs = 1;
+        request.config.attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_DEBOUNCE;
+        request.config.attrs[0].attr.debounce_period_us = DEBOUNCE_US;
+        request.config.attrs[0].mask = 1;
+        request.event_buffer_size = KERNEL_EVENT_BUFFER;
+
+        int result = ioctl(chipFd, GPIO_V2_GET_LINE_IOCTL, &request);
+        lineError_ = result < 0 ? errno : 0;
+        ::close(chipFd);
+        if (result < 0) return true;
+
+        lineFd_ = request.fd;
+        fcntl(lineFd_, F_SETFL, fcntl(lineFd_, F_GETFL) | O_NONBLOCK);
+        lastEdgeNs_ = 0;
+        periodNs_ = 0;
+        pulseHz_ = 0.0;
+        healthy_ = true;
+        return true;
+    }
+
+    bool update() override {
+        if (lineFd_ < 0) return false;
+
+        gpio_v2_line_event events[EVENT_BATCH];
+        int64_t firstEdgeNs = lastEdgeNs_;
+        uint64_t periods = 0;
+        for (;;) {
+            ssize_t length = read(lineFd_, events, sizeof(events));
+            if (length < 0) {
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN) break;
+                healthy_ = false;
+                return false;
+            }
+            size_t count = static_cast<size_t>(length) / sizeof(gpio_v2_line_event);
+            for (size_t i = 0; i < count; i++) {
+                const gpio_v2_line_event& event = events[i];
+                int64_t edgeNs = static_cast<int64_t>(event.timestamp_ns);
+                uint32_t gap = pulses_ > 0 ? event.line_seqno - lastSeqno_ : 1;
+                lastSeqno_ = event.line_seqno;
+                pulses_ += gap;
+                if (gap > 1) missedEdges_ += gap - 1;
+
+                // Lost edges or a restart after no flow: keep the total,
+                // restart the period measurement
+                if (gap > 1 || edgeNs - lastEdgeNs_ > STOP_TIMEOUT_NS) {
+                    firstEdgeNs = 0;
+                    periods = 0;
+                }
+                if (firstEdgeNs == 0) {
+                    firstEdgeNs = edgeNs;
+                } else {
+                    periods++;
+                }
+                lastEdgeNs_ = edgeNs;
+            }
+            if (count < EVENT_BATCH) break;
+        }
+
+        if (periods > 0 && lastEdgeNs_ > firstEdgeNs) {
+            periodNs_ = (lastEdgeNs_ - firstEdgeNs) / static_cast<int64_t>(periods);
+            pulseHz_ = 1e9 / static_cast<double>(periodNs_);
+        } else if (lastEdgeNs_ != 0) {
+            int64_t sinceEdge = monotonicNowNs() - lastEdgeNs_;
+            if (sinceEdge > STOP_TIMEOUT_NS) {
+                pulseHz_ = 0.0;
+            } else if (sinceEdge > periodNs_) {
+                pulseHz_ = std::min(pulseHz_, 1e9 / static_cast<double>(sinceEdge));
+            }
+        }
+        healthy_ = true;
+        return true;
+    }
+
+    bool shutdown() override {
+        closeLine();
+        healthy_ = false;
+        return true;
+    }
+
+    double readValue() override { return pulseHz_ * 60.0 / pulsesPerLiter_; }
+
+    size_t getChannelCount() const override { return CHANNEL_COUNT; }
+
+    size_t readVector(std::span<double> out) override {
+        const double values[CHANNEL_COUNT] = {readValue(), getTotalLiters(), pulseHz_};
+        size_t count = std::min(out.size(), static_cast<size_t>(CHANNEL_COUNT));
+        std::copy(values, values + count, out.begin());
+        return count;
+    }
+
+    // Zeroes the volume total
+    bool calibrate() override {
+        totalOffset_ = static_cast<double>(pulses_);
+        return true;
+    }
+
+    bool isHealthy() const override { return healthy_; }
+    std::string getUnits() const override { return "L/min"; }
+    std::string getStatus() const override { return statusText(*this); }
+
+    size_t formatStatus(char* buffer, size_t size) const override {
+        StatusWriter out(buffer, size);
+        if (lineError_ != 0) {
+            out.text(name_).text(": no GPIO line ").text(chipPath_).text(" ").number(line_)
+               .text(" (").text(std::strerror(lineError_)).text(")");
+            return out.length();
+        }
+        out.text(name_).text(": ").fixed(pulseHz_ * 60.0 / pulsesPerLiter_).text(" L/min")
+           .text(" total=").fixed(getTotalLiters()).text(" L")
+           .text(" pulses=").number(pulses_).text(" missed=").number(missedEdges_);
+        return out.length();
+    }
+    std::string getComponentName() const override { return name_; }
+
+    // Pulse seen within the stop timeout (flow_monitor.py's ACTIVE state)
+    bool isFlowing() const { return pulseHz_ > 0.0; }
+    double getTotalLiters() const {
+        return (static_cast<double>(pulses_) - totalOffset_) / pulsesPerLiter_;
+    }
+    uint64_t getPulseCount() const { return pulses_; }
+    uint64_t getMissedEdges() const { return missedEdges_; }
 };
 
-#endif
\ No newline at end of file
+#endif
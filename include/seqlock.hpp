@@ -0,0 +1,69 @@
+// Seqlock
+#ifndef SEQLOCK_HPP
+#define SEQLOCK_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Single-writer sequence lock for a trivially copyable value.
+// The writer never blocks; readers retry if a write overlapped their
+// copy. The payload is stored as relaxed atomic words so concurrent
+// access is well defined.
+template <typename T>
+class Seqlock {
+    static_assert(std::is_trivially_copyable_v<T>, "Seqlock payload must be trivially copyable");
+
+private:
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    alignas(64) std::atomic<uint32_t> sequence_;
+    std::array<std::atomic<uint64_t>, WORDS> words_;
+
+public:
+    Seqlock() : sequence_(0) {
+        for (auto& word : words_) word.store(0, std::memory_order_relaxed);
+    }
+
+    Seqlock(const Seqlock&) = delete;
+    Seqlock& operator=(const Seqlock&) = delete;
+
+    // Writer thread only
+    void write(const T& value) {
+        uint64_t buffer[WORDS] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+
+        uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(sequence + 1, std::memory_order_relaxed); // Odd: write in progress
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; i++) {
+            words_[i].store(buffer[i], std::memory_order_relaxed);
+        }
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+    // Any thread. Returns the sequence number of the copy (0 = never written).
+    uint32_t read(T& out) const {
+        uint64_t buffer[WORDS];
+        uint32_t before, after;
+        do {
+            before = sequence_.load(std::memory_order_acquire);
+            if (before & 1) continue;
+            for (size_t i = 0; i < WORDS; i++) {
+                buffer[i] = words_[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence_.load(std::memory_order_relaxed);
+            if (before == after) break;
+        } while (true);
+
+        std::memcpy(&out, buffer, sizeof(T));
+        return before;
+    }
+
+    uint32_t getSequence() const { return sequence_.load(std::memory_order_acquire); }
+};
+
+#endif // SEQLOCK_HPP
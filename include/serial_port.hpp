@@ -0,0 +1,53 @@
+// SerialPort
+#ifndef SERIAL_PORT_HPP
+#define SERIAL_PORT_HPP
+
+#include <string>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+// termios speed constant for a numeric baud rate (B0 if unsupported)
+inline speed_t baudToSpeed(int baud) {
+    switch (baud) {
+        case 9600: return B9600;
+        case 19200: return B19200;
+        case 38400: return B38400;
+        case 57600: return B57600;
+        case 115200: return B115200;
+        case 230400: return B230400;
+        case 460800: return B460800;
+        case 921600: return B921600;
+        default: return B0;
+    }
+}
+
+// Open a serial device in raw, nonblocking 8N1 mode. Returns fd or -1.
+inline int openSerialPort(const std::string& path, int baud) {
+    int fd = ::open(path.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    termios tty{};
+    if (tcgetattr(fd, &tty) != 0) {
+        ::close(fd);
+        return -1;
+    }
+
+    cfmakeraw(&tty);
+    tty.c_cflag |= CLOCAL | CREAD;
+    tty.c_cflag &= ~(CSTOPB | CRTSCTS | PARENB);
+    tty.c_cc[VMIN] = 0;
+    tty.c_cc[VTIME] = 0;
+
+    speed_t speed = baudToSpeed(baud);
+    if (speed == B0 || cfsetispeed(&tty, speed) != 0 || cfsetospeed(&tty, speed) != 0 ||
+        tcsetattr(fd, TCSANOW, &tty) != 0) {
+        ::close(fd);
+        return -1;
+    }
+
+    tcflush(fd, TCIOFLUSH);
+    return fd;
+}
+
+#endif // SERIAL_PORT_HPP
@@ -0,0 +1,460 @@
+// Simulation
+#ifndef SIMULATION_HPP
+#define SIMULATION_HPP
+
+#include "controlSystem.hpp"
+#include <cmath>
+#include <functional>
+
+// Plant models and simulated devices for running TM_ControlSystem off
+// the vehicle. The Simulator steps the plants and the control system on
+// a VirtualClock, so a run goes as fast as the CPU allows and repeats
+// exactly (noise is seeded). The simulated Teensy nodes speak the real
+// packet formats, so the IMU and actuator output paths are exercised
+// end to end. TelemetryReplay feeds a recorded .tlm segment back through
+// ReplaySensors instead of the plants. See tools/tbm_sim.cpp.
+
+constexpr double SIM_PSI_PER_METER = 1.4223;     // Fresh water
+
+class VirtualClock {
+private:
+    int64_t nowNs_;
+
+public:
+    explicit VirtualClock(int64_t startNs) : nowNs_(startNs) {}
+
+    int64_t now() const { return nowNs_; }
+    void advance(int64_t deltaNs) { nowNs_ += deltaNs; }
+};
+
+// Gaussian noise from a fixed seed (xorshift64*, Box-Muller)
+class SimNoise {
+private:
+    uint64_t state_;
+
+    double uniform() {
+        state_ ^= state_ >> 12;
+        state_ ^= state_ << 25;
+        state_ ^= state_ >> 27;
+        return static_cast<double>((state_ * 0x2545F4914F6CDD1DULL) >> 11) * 0x1.0p-53;
+    }
+
+public:
+    explicit SimNoise(uint64_t seed) : state_(seed ? seed : 1) {}
+
+    double gaussian(double sigma) {
+        if (sigma <= 0.0) return 0.0;
+        double u1 = std::max(uniform(), 1e-300);
+        return sigma * std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * M_PI * uniform());
+    }
+};
+
+// Vertical motion. Positive thrust (percent of maxThrustN) drives down;
+// the vehicle is slightly positively buoyant, so it surfaces unpowered.
+struct DepthPlant {
+    double massKg = 45.0;           // Including added mass
+    double dragNsPerM = 60.0;
+    double maxThrustN = 50.0;
+    double buoyancyN = 2.0;
+    double depthM = 0.0;
+    double velocityMps = 0.0;
+
+    void step(double thrustPercent, double dt) {
+        double force = maxThrustN * std::clamp(thrustPercent, -100.0, 100.0) / 100.0 -
+                       buoyancyN - dragNsPerM * velocityMps;
+        velocityMps += force / massKg * dt;
+        depthM += velocityMps * dt;
+        if (depthM < 0.0) {
+            depthM = 0.0;
+            velocityMps = std::max(velocityMps, 0.0);
+        }
+    }
+
+    double pressurePsi() const { return depthM * SIM_PSI_PER_METER; }
+};
+
+// Yaw. Positive thrust turns towards increasing heading (degrees, +-180).
+struct HeadingPlant {
+    double inertiaKgM2 = 6.0;
+    double dragNmsPerRad = 8.0;
+    double maxTorqueNm = 10.0;
+    double headingDeg = 0.0;
+    double rateDegps = 0.0;
+
+    void step(double thrustPercent, double dt) {
+        double rate = rateDegps * M_PI / 180.0;
+        double torque = maxTorqueNm * std::clamp(thrustPercent, -100.0, 100.0) / 100.0 -
+                        dragNmsPerRad * rate;
+        rate += torque / inertiaKgM2 * dt;
+        rateDegps = rate * 180.0 / M_PI;
+        headingDeg = std::remainder(headingDeg + rateDegps * dt, 360.0);
+    }
+};
+
+// Hydraulic cylinder behind a proportional valve: position follows the
+// valve opening as a first-order lag, rate-limited by the pump flow
+struct CylinderPlant {
+    double strokeMm = 150.0;
+    double timeConstantS = 0.4;
+    double maxSpeedMmps = 80.0;
+    double positionMm = 0.0;
+
+    void step(double valvePercent, double dt) {
+        double target = strokeMm * std::clamp(valvePercent, 0.0, 100.0) / 100.0;
+        double speed = std::clamp((target - positionMm) / timeConstantS, -maxSpeedMmps, maxSpeedMmps);
+        positionMm = std::clamp(positionMm + speed * dt, 0.0, strokeMm);
+    }
+};
+
+// VFD and motor: output frequency ramps towards the command at the
+// drive's acceleration limit, with slip under load
+struct VFDPlant {
+    double accelHzps = 10.0;
+    double slipHz = 0.8;            // At full load
+    double loadFraction = 0.5;
+    double outputHz = 0.0;
+
+    void step(double commandHz, double dt) {
+        double step = accelHzps * dt;
+        outputHz += std::clamp(commandHz - outputHz, -step, step);
+    }
+
+    double shaftHz() const { return std::max(0.0, outputHz - slipHz * loadFraction); }
+};
+
+// Scalar sensor reading a plant value, with noise and fault injection
+class SimulatedSensor : public ISensor {
+private:
+    std::string name_;
+    std::string units_;
+    std::function<double()> source_;
+    double noiseSigma_;
+    SimNoise noise_;
+    double value_;
+    bool initialized_;
+    bool failed_;
+
+public:
+    SimulatedSensor(const std::string& name, const std::string& units,
+                    std::function<double()> source, double noiseSigma = 0.0,
+                    uint64_t seed = 1)
+        : name_(name), units_(units), source_(std::move(source)), noiseSigma_(noiseSigma),
+          noise_(seed), value_(0.0), initialized_(false), failed_(false) {}
+
+    bool initialize() override { initialized_ = true; return true; }
+
+    bool update() override {
+        if (!isHealthy()) return false;
+        value_ = source_() + noise_.gaussian(noiseSigma_);
+        return true;
+    }
+
+    bool shutdown() override { initialized_ = false; return true; }
+    double readValue() override { return value_; }
+    bool calibrate() override { return true; }
+    bool isHealthy() const override { return initialized_ && !failed_; }
+    std::string getUnits() const override { return units_; }
+    std::string getStatus() const override {
+        return name_ + ": " + std::to_string(value_) + " " + units_ + (failed_ ? " (failed)" : "");
+    }
+    std::string getComponentName() const override { return name_; }
+
+    // Reads as unhealthy until cleared
+    void setFailed(bool failed) { failed_ = failed; }
+};
+
+// VFD whose feedback is the plant's shaft frequency
+class SimulatedVFD : public MotorController {
+private:
+    const VFDPlant& plant_;
+
+public:
+    SimulatedVFD(const std::string& name, const VFDPlant& plant, double maxHz = 60.0)
+        : MotorController(name, 0.0, maxHz), plant_(plant) {}
+
+    bool update() override {
+        bool ok = MotorController::update();
+        feedbackValue_ = plant_.shaftHz();
+        return ok;
+    }
+};
+
+// Teensy sensor node: IMU_QUATERNION packets from the heading plant at
+// the sketch's 100 Hz, timed by the virtual clock. Its micros() runs off
+// the virtual clock with an offset and a crystal error, and it answers
+// TIME_PINGs as the sketch does.
+class SimulatedSensorNode : public ICommunicationInterface {
+private:
+    static constexpr int64_t REPORT_PERIOD_NS = 10000000LL;
+
+    std::string name_;
+    const VirtualClock& clock_;
+    const HeadingPlant& heading_;
+    int64_t startNs_;
+    uint32_t bootUs_;           // micros() at startNs_
+    double driftPpm_;
+    int64_t nextReportNs_;
+    uint32_t reportUs_;
+    uint8_t sequence_;
+    bool pending_;
+    TimePong pong_;
+    bool pongPending_;
+    bool connected_;
+
+    uint32_t deviceMicros() const {
+        double elapsedUs = (clock_.now() - startNs_) * (1.0 + driftPpm_ * 1e-6) / 1000.0;
+        return bootUs_ + static_cast<uint32_t>(static_cast<int64_t>(elapsedUs));
+    }
+
+public:
+    SimulatedSensorNode(const std::string& name, const VirtualClock& clock,
+                        const HeadingPlant& heading, uint32_t bootUs = 4000000,
+                        double driftPpm = 30.0)
+        : name_(name), clock_(clock), heading_(heading), startNs_(clock.now()),
+          bootUs_(bootUs), driftPpm_(driftPpm), nextReportNs_(0), reportUs_(0), sequence_(0),
+          pending_(false), pong_{}, pongPending_(false), connected_(false) {}
+
+    bool initialize() override {
+        connected_ = true;
+        nextReportNs_ = clock_.now();
+        return true;
+    }
+
+    bool update() override {
+        if (connected_ && clock_.now() >= nextReportNs_) {
+            pending_ = true;
+            reportUs_ = deviceMicros();
+            nextReportNs_ += REPORT_PERIOD_NS;
+            if (nextReportNs_ < clock_.now()) nextReportNs_ = clock_.now() + REPORT_PERIOD_NS;
+        }
+        return connected_;
+    }
+
+    bool shutdown() override { connected_ = false; return true; }
+
+    bool send(std::span<const uint8_t> data) override {
+        if (connected_ && parseTimePing(data.data(), data.size(), pong_.sequence, pong_.pingNs)) {
+            pong_.receiveUs = deviceMicros();
+            pongPending_ = true;
+        }
+        return connected_;
+    }
+
+    size_t receiveInto(std::span<uint8_t> buffer) override {
+        if (pongPending_ && buffer.size() >= TIME_PONG_PACKET_SIZE) {
+            pongPending_ = false;
+            pong_.transmitUs = deviceMicros();
+            return encodeTimePong(pong_, buffer.data());
+        }
+        if (!pending_ || buffer.size() < IMU_QUATERNION_TIMED_PACKET_SIZE) return 0;
+        pending_ = false;
+        double halfYaw = heading_.headingDeg * M_PI / 360.0;
+        QuaternionSample sample{sequence_++, static_cast<float>(std::cos(halfYaw)), 0.0f, 0.0f,
+                                static_cast<float>(std::sin(halfYaw)), true, reportUs_};
+        return encodeImuQuaternion(sample, buffer.data());
+    }
+
+    bool isConnected() const override { return connected_; }
+    std::string getStatus() const override { return name_ + ": simulated"; }
+    std::string getComponentName() const override { return name_; }
+};
+
+// Teensy actuator node: decodes ACTUATOR_FRAMEs and holds the channel
+// outputs, dropping to failsafe (zero) when frames stop
+class SimulatedActuatorNode : public ICommunicationInterface {
+private:
+    std::string name_;
+    const VirtualClock& clock_;
+    ActuatorFrame frame_;
+    int64_t lastFrameNs_;
+    uint64_t frames_;
+    bool connected_;
+
+public:
+    SimulatedActuatorNode(const std::string& name, const VirtualClock& clock)
+        : name_(name), clock_(clock), frame_{}, lastFrameNs_(0), frames_(0),
+          connected_(false) {}
+
+    bool initialize() override { connected_ = true; return true; }
+    bool update() override { return connected_; }
+    bool shutdown() override { connected_ = false; return true; }
+
+    bool send(std::span<const uint8_t> data) override {
+        if (!connected_) return false;
+        if (parseActuatorFrame(data.data(), data.size(), frame_)) {
+            lastFrameNs_ = clock_.now();
+            frames_++;
+        }
+        return true;
+    }
+
+    size_t receiveInto(std::span<uint8_t>) override { return 0; }
+
+    // Output in percent, as the node would drive it
+    double channelPercent(size_t channel) const {
+        bool live = frames_ > 0 &&
+                    clock_.now() - lastFrameNs_ <= ACTUATOR_FRAME_TIMEOUT_MS * 1000000LL;
+        if (!live || channel >= ACTUATOR_FRAME_CHANNELS || !(frame_.mask & (1u << channel))) {
+            return 0.0;
+        }
+        return frame_.values[channel] / ACTUATOR_COMMAND_SCALE;
+    }
+
+    uint64_t getFrameCount() const { return frames_; }
+    bool isConnected() const override { return connected_; }
+    std::string getStatus() const override {
+        return name_ + ": simulated, " + std::to_string(frames_) + " frames";
+    }
+    std::string getComponentName() const override { return name_; }
+};
+
+// Steps the plants and the control system on the virtual clock. Plants
+// run first each cycle, so the sensors sample the state the previous
+// cycle's commands produced.
+class Simulator {
+private:
+    TM_ControlSystem& system_;
+    VirtualClock clock_;
+    int64_t periodNs_;
+    double periodS_;
+    std::vector<std::function<void(double)>> plants_;
+    uint64_t cycles_;
+
+public:
+    Simulator(TM_ControlSystem& system, double loopRateHz, int64_t startNs)
+        : system_(system), clock_(startNs),
+          periodNs_(static_cast<int64_t>(1e9 / loopRateHz)), periodS_(1.0 / loopRateHz),
+          cycles_(0) {}
+
+    VirtualClock& getClock() { return clock_; }
+
+    // step(dt) is called once per cycle before the control system runs
+    void addPlant(std::function<void(double)> step) { plants_.push_back(std::move(step)); }
+
+    void step() {
+        for (auto& plant : plants_) plant(periodS_);
+        clock_.advance(periodNs_);
+        system_.runCycle(clock_.now());
+        cycles_++;
+    }
+
+    // Runs for a span of virtual time; onCycle runs after every cycle
+    void runFor(double seconds, const std::function<void()>& onCycle = {}) {
+        uint64_t cycles = static_cast<uint64_t>(seconds / periodS_ + 0.5);
+        for (uint64_t i = 0; i < cycles; i++) {
+            step();
+            if (onCycle) onCycle();
+        }
+    }
+
+    uint64_t getCycleCount() const { return cycles_; }
+    double getElapsedSeconds() const { return cycles_ * periodS_; }
+};
+
+// Sensor fed from a recording (TelemetryReplay). Unhealthy until its
+// channel has appeared in the segment.
+class ReplaySensor : public ISensor {
+private:
+    std::string name_;
+    std::string units_;
+    double value_;
+    bool initialized_;
+    bool hasValue_;
+
+public:
+    ReplaySensor(const std::string& name, const std::string& units = "")
+        : name_(name), units_(units), value_(0.0), initialized_(false), hasValue_(false) {}
+
+    bool initialize() override { initialized_ = true; return true; }
+    bool update() override { return isHealthy(); }
+    bool shutdown() override { initialized_ = false; return true; }
+    double readValue() override { return value_; }
+    bool calibrate() override { return true; }
+    bool isHealthy() const override { return initialized_ && hasValue_; }
+    std::string getUnits() const override { return units_; }
+    std::string getStatus() const override { return name_ + ": " + std::to_string(value_) + " (replay)"; }
+    std::string getComponentName() const override { return name_; }
+
+    void setValue(double value) {
+        value_ = value;
+        hasValue_ = true;
+    }
+};
+
+// Plays a telemetry segment against the virtual clock: every record up
+// to the current time is applied to the ReplaySensor bound to its
+// channel, and the latest value of every channel is kept so recorded
+// actuator commands can be compared with the ones recomputed now.
+class TelemetryReplay {
+private:
+    TelemetrySegmentReader reader_;
+    uint64_t next_;
+    std::vector<std::shared_ptr<ReplaySensor>> sensors_;    // By channel ID
+    std::vector<double> latest_;
+    std::vector<uint8_t> seen_;
+
+public:
+    TelemetryReplay() : next_(0) {}
+
+    bool open(const std::string& path) {
+        if (!reader_.open(path)) return false;
+        uint32_t channels = reader_.header().channelCount;
+        sensors_.assign(channels, nullptr);
+        latest_.assign(channels, 0.0);
+        seen_.assign(channels, 0);
+        next_ = 0;
+        return true;
+    }
+
+    uint32_t getChannelCount() const { return static_cast<uint32_t>(latest_.size()); }
+    std::string getChannelName(uint32_t channel) const { return reader_.getChannelName(channel); }
+
+    // Channel ID for a name, -1 if not in the segment
+    int findChannel(const std::string& name) const {
+        for (uint32_t i = 0; i < latest_.size(); i++) {
+            if (reader_.getChannelName(i) == name) return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    bool bind(const std::string& channelName, std::shared_ptr<ReplaySensor> sensor) {
+        int channel = findChannel(channelName);
+        if (channel < 0) return false;
+        sensors_[channel] = std::move(sensor);
+        return true;
+    }
+
+    uint64_t getRecordCount() const { return reader_.getRecordCount(); }
+    int64_t getStartNs() const {
+        return getRecordCount() > 0 ? reader_.getRecord(0).timestampNs : 0;
+    }
+    int64_t getEndNs() const {
+        return getRecordCount() > 0 ? reader_.getRecord(getRecordCount() - 1).timestampNs : 0;
+    }
+    bool isFinished() const { return next_ >= getRecordCount(); }
+
+    void advanceTo(int64_t nowNs) {
+        uint64_t count = getRecordCount();
+        while (next_ < count) {
+            const TelemetryRecord& record = reader_.getRecord(next_);
+            if (record.timestampNs > nowNs) break;
+            if (record.channelId < latest_.size()) {
+                latest_[record.channelId] = record.value;
+                seen_[record.channelId] = 1;
+                if (sensors_[record.channelId]) sensors_[record.channelId]->setValue(record.value);
+            }
+            next_++;
+        }
+    }
+
+    // Latest recorded value of a channel at the current replay time
+    bool getLatest(int channel, double& value) const {
+        if (channel < 0 || static_cast<size_t>(channel) >= latest_.size() || !seen_[channel]) {
+            return false;
+        }
+        value = latest_[channel];
+        return true;
+    }
+};
+
+#endif // SIMULATION_HPP
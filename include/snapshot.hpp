@@ -0,0 +1,51 @@
+// SystemSnapshot
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include "seqlock.hpp"
+#include <cstdint>
+
+constexpr size_t SNAPSHOT_MAX_SENSORS = 32;
+constexpr size_t SNAPSHOT_MAX_ACTUATORS = 32;
+constexpr size_t SNAPSHOT_MAX_VECTOR_VALUES = 64;
+constexpr size_t SNAPSHOT_MAX_ECUS = 32;
+
+// Everything sampled in one control cycle, in one contiguous block.
+// Sensors are sampled once per cycle by their SENSOR_READ tasks (at their
+// rate group's rate, so each slot carries its own sample time). The
+// SNAPSHOT stage then freezes the cycle's copy and every later consumer
+// (safety, control, telemetry, logging) reads only that copy.
+// Multi-channel sensors (ISensor::readVector) also store every channel in
+// vectorValues, at vectorOffset[i] for vectorCount[i] values; scalar
+// sensors have vectorCount 0. Actuator values are as of the end of the
+// previous cycle. Status flags and ECU status are taken with the sensors,
+// so a reader on another thread needs nothing but the snapshot.
+struct SystemSnapshot {
+    uint64_t cycle;
+    int64_t timestampNs;                        // Monotonic, start of cycle
+
+    uint32_t sensorCount;
+    uint32_t actuatorCount;
+
+    double sensorValues[SNAPSHOT_MAX_SENSORS];
+    int64_t sensorSampleNs[SNAPSHOT_MAX_SENSORS];
+    uint8_t sensorHealthy[SNAPSHOT_MAX_SENSORS];
+    uint8_t vectorCount[SNAPSHOT_MAX_SENSORS];
+    uint16_t vectorOffset[SNAPSHOT_MAX_SENSORS];
+    double vectorValues[SNAPSHOT_MAX_VECTOR_VALUES];
+
+    double actuatorCommands[SNAPSHOT_MAX_ACTUATORS];
+    double actuatorFeedback[SNAPSHOT_MAX_ACTUATORS];
+    int64_t actuatorSampleNs[SNAPSHOT_MAX_ACTUATORS];
+
+    uint8_t statusFlags;                        // TELEMETRY_FLAG_*
+    uint32_t ecuCount;
+    uint8_t ecuStatus[SNAPSHOT_MAX_ECUS];       // ECUStatus codes
+};
+
+// Published copy for readers on other threads (telemetry, visualizer
+// bridge). Written once per cycle by the control thread; reads never
+// block the writer.
+using SnapshotBuffer = Seqlock<SystemSnapshot>;
+
+#endif // SNAPSHOT_HPP
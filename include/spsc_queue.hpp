@@ -0,0 +1,92 @@
+// SPSCQueue
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Bounded lock-free single-producer/single-consumer ring.
+// All slots are preallocated; push/pop never allocate or block. Exactly
+// one thread may push and exactly one (other) thread may pop. Producer
+// and consumer indices live on separate cache lines so the two threads
+// do not false-share.
+template <typename T, size_t Capacity>
+class SPSCQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SPSCQueue capacity must be a power of two");
+
+private:
+    static constexpr size_t MASK = Capacity - 1;
+
+    alignas(64) std::atomic<size_t> head_;   // Next slot to pop (consumer)
+
+    // Producer-owned line: index plus counters (written only by the producer)
+    alignas(64) std::atomic<size_t> tail_;   // Next slot to push (producer)
+    std::atomic<size_t> highWaterMark_;      // Deepest occupancy seen
+    std::atomic<uint64_t> overflowCount_;    // Pushes rejected because full
+
+    alignas(64) std::array<T, Capacity> slots_;
+
+public:
+    SPSCQueue() : head_(0), tail_(0), highWaterMark_(0), overflowCount_(0) {}
+
+    SPSCQueue(const SPSCQueue&) = delete;
+    SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+    bool tryPush(const T& item) {
+        return tryEmplace([&item](T& slot) { slot = item; });
+    }
+
+    // Fill the next free slot in place (avoids a temporary copy)
+    template <typename Fill>
+    bool tryEmplace(Fill&& fill) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t depth = tail - head_.load(std::memory_order_acquire);
+        if (depth >= Capacity) {
+            overflowCount_.store(overflowCount_.load(std::memory_order_relaxed) + 1,
+                                 std::memory_order_relaxed);
+            return false; // Full
+        }
+        fill(slots_[tail & MASK]);
+        tail_.store(tail + 1, std::memory_order_release);
+        if (depth + 1 > highWaterMark_.load(std::memory_order_relaxed)) {
+            highWaterMark_.store(depth + 1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    bool tryPop(T& out) {
+        T* item = front();
+        if (!item) return false;
+        out = *item;
+        pop();
+        return true;
+    }
+
+    // Peek at the oldest item without copying it (consumer only)
+    T* front() {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) return nullptr;
+        return &slots_[head & MASK];
+    }
+
+    // Release the slot returned by front()
+    void pop() {
+        head_.store(head_.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_release);
+    }
+
+    size_t size() const {
+        return tail_.load(std::memory_order_acquire) -
+               head_.load(std::memory_order_acquire);
+    }
+
+    bool empty() const { return size() == 0; }
+    size_t getHighWaterMark() const { return highWaterMark_.load(std::memory_order_relaxed); }
+    uint64_t getOverflowCount() const { return overflowCount_.load(std::memory_order_relaxed); }
+    static constexpr size_t capacity() { return Capacity; }
+};
+
+#endif // SPSC_QUEUE_HPP
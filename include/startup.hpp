@@ -0,0 +1,163 @@
+// StartupSequencer
+#ifndef STARTUP_HPP
+#define STARTUP_HPP
+
+#include "scheduler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Brings components up concurrently in dependency stages. Every task of
+// a stage runs on its own thread and the next stage starts once the
+// whole stage has finished or timed out, so startup takes the slowest
+// component of each stage rather than the sum of all of them. A task
+// that misses its timeout is reported as failed and left to finish on
+// its detached thread; tasks must only capture what they own (shared
+// pointers), never the caller. Tasks must not log: the results are
+// logged by the caller once run() returns.
+
+struct StartupResult {
+    std::string name;
+    size_t stage;
+    bool ok;
+    bool timedOut;
+    bool started;               // False if an earlier stage failed
+    int64_t elapsedNs;
+};
+
+class StartupSequencer {
+private:
+    struct Task {
+        size_t stage;
+        std::string name;
+        std::function<bool()> run;
+        int timeoutMs;
+    };
+
+    // Shared with the task threads, which may outlive the sequencer
+    struct Completion {
+        std::mutex mutex;
+        std::condition_variable done;
+        std::vector<uint8_t> finished;
+        std::vector<uint8_t> ok;
+        std::vector<int64_t> endNs;
+    };
+
+    std::vector<Task> tasks_;
+    std::vector<StartupResult> results_;
+    int64_t elapsedNs_;
+
+    bool runStage(size_t stage) {
+        std::vector<size_t> members;
+        for (size_t i = 0; i < tasks_.size(); i++) {
+            if (tasks_[i].stage == stage) members.push_back(i);
+        }
+        if (members.empty()) return true;
+
+        auto completion = std::make_shared<Completion>();
+        completion->finished.assign(members.size(), 0);
+        completion->ok.assign(members.size(), 0);
+        completion->endNs.assign(members.size(), 0);
+
+        int64_t startNs = monotonicNowNs();
+        for (size_t slot = 0; slot < members.size(); slot++) {
+            std::thread([completion, slot, run = tasks_[members[slot]].run]() {
+                bool ok = false;
+                try {
+                    ok = run();
+                } catch (...) {
+                    ok = false;
+                }
+                std::lock_guard<std::mutex> lock(completion->mutex);
+                completion->ok[slot] = ok;
+                completion->endNs[slot] = monotonicNowNs();
+                completion->finished[slot] = 1;
+                completion->done.notify_all();
+            }).detach();
+        }
+
+        // All tasks started together, so each waits to its own absolute deadline
+        bool stageOk = true;
+        std::unique_lock<std::mutex> lock(completion->mutex);
+        for (size_t slot = 0; slot < members.size(); slot++) {
+            const Task& task = tasks_[members[slot]];
+            auto deadline = std::chrono::steady_clock::now() +
+                            std::chrono::nanoseconds(startNs + task.timeoutMs * 1000000LL -
+                                                     monotonicNowNs());
+            bool finished = completion->done.wait_until(lock, deadline, [&]() {
+                return completion->finished[slot] != 0;
+            });
+
+            StartupResult& result = results_[members[slot]];
+            result.started = true;
+            result.timedOut = !finished;
+            result.ok = finished && completion->ok[slot];
+            result.elapsedNs = finished ? completion->endNs[slot] - startNs
+                                        : monotonicNowNs() - startNs;
+            stageOk = stageOk && result.ok;
+        }
+        return stageOk;
+    }
+
+public:
+    StartupSequencer() : elapsedNs_(0) {}
+
+    void addTask(size_t stage, const std::string& name, std::function<bool()> run,
+                 int timeoutMs) {
+        tasks_.push_back({stage, name, std::move(run), timeoutMs});
+    }
+
+    // Runs the stages in order, stopping after the first one with a
+    // failure. True if every task succeeded.
+    bool run() {
+        results_.clear();
+        size_t stages = 0;
+        for (const auto& task : tasks_) {
+            results_.push_back({task.name, task.stage, false, false, false, 0});
+            stages = std::max(stages, task.stage + 1);
+        }
+
+        int64_t startNs = monotonicNowNs();
+        bool ok = true;
+        for (size_t stage = 0; stage < stages && ok; stage++) {
+            ok = runStage(stage);
+        }
+        elapsedNs_ = monotonicNowNs() - startNs;
+        return ok;
+    }
+
+    const std::vector<StartupResult>& getResults() const { return results_; }
+
+    const StartupResult* findResult(const std::string& name) const {
+        for (const auto& result : results_) {
+            if (result.name == name) return &result;
+        }
+        return nullptr;
+    }
+
+    int64_t getElapsedNs() const { return elapsedNs_; }
+    size_t getTaskCount() const { return tasks_.size(); }
+
+    // Milliseconds with one decimal
+    static std::string formatMs(int64_t ns) {
+        std::string ms = std::to_string(ns / 100000 / 10.0);
+        return ms.substr(0, ms.find('.') + 2);
+    }
+
+    // "Initialized: X (1.2 ms)" style line for one result
+    static std::string describe(const StartupResult& result) {
+        std::string ms = formatMs(result.elapsedNs);
+        if (!result.started) return "Not started: " + result.name + " (earlier stage failed)";
+        if (result.timedOut) return "Timed out initializing: " + result.name + " after " + ms + " ms";
+        if (!result.ok) return "Failed to initialize: " + result.name + " (" + ms + " ms)";
+        return "Initialized: " + result.name + " (" + ms + " ms)";
+    }
+};
+
+#endif // STARTUP_HPP
@@ -0,0 +1,245 @@
+// StateBus
+#ifndef STATE_BUS_HPP
+#define STATE_BUS_HPP
+
+#include "snapshot.hpp"
+#include "ecu_mangr.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Shared-memory state bus (POSIX shm "/tbm_state_bus", i.e.
+// /dev/shm/tbm_state_bus). The control system publishes the frozen cycle
+// snapshot and ECU health into it; dashboards mmap it read-only instead
+// of talking to the hardware (reader: digem-pi5/state_bus.py).
+//
+// Layout (version 1, little-endian, no implicit padding)
+//
+//   Offset  Size  Field
+//   Header
+//   0       4     Magic 0x534D4254 ("TBMS")
+//   4       2     Version
+//   6       2     Header size (64)
+//   8       4     Total size
+//   12      4     Frame sequence (seqlock: odd while the frame is written)
+//   16      4     Max sensors (32)
+//   20      4     Max actuators (32)
+//   24      4     Max vector values (64)
+//   28      4     Max ECUs (16)
+//   32      4     Directory offset
+//   36      4     Frame offset
+//   40      4     Writer PID
+//   44      4     Reserved
+//   48      8     Publish rate (float64 Hz)
+//   56      8     Reserved
+//   Directory (written once; valid once the sequence is non-zero)
+//   64      32*32 Sensors: name[24], units[8] (NUL padded)
+//   1088    32*32 Actuators: name[32]
+//   2112    32*16 ECUs: id[8], name[24]
+//   Frame (StateBusFrame, read under the seqlock)
+//   2624    2096
+//
+// Readers copy the frame, then re-read the sequence and retry if it was
+// odd or changed. Timestamps are CLOCK_MONOTONIC ns, comparable with
+// time.monotonic_ns() on the same host.
+
+constexpr const char* STATE_BUS_NAME = "/tbm_state_bus";
+constexpr uint32_t STATE_BUS_MAGIC = 0x534D4254;
+constexpr uint16_t STATE_BUS_VERSION = 1;
+constexpr size_t STATE_BUS_MAX_ECUS = 16;
+
+struct StateBusHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t headerSize;
+    uint32_t totalSize;
+    uint32_t sequence;
+    uint32_t maxSensors;
+    uint32_t maxActuators;
+    uint32_t maxVectorValues;
+    uint32_t maxEcus;
+    uint32_t directoryOffset;
+    uint32_t frameOffset;
+    int32_t writerPid;
+    uint32_t reserved0;
+    double publishRateHz;
+    uint64_t reserved1;
+};
+
+struct StateBusSensorEntry { char name[24]; char units[8]; };
+struct StateBusActuatorEntry { char name[32]; };
+struct StateBusECUEntry { char id[8]; char name[24]; };
+
+struct StateBusDirectory {
+    StateBusSensorEntry sensors[SNAPSHOT_MAX_SENSORS];
+    StateBusActuatorEntry actuators[SNAPSHOT_MAX_ACTUATORS];
+    StateBusECUEntry ecus[STATE_BUS_MAX_ECUS];
+};
+
+struct StateBusFrame {
+    uint64_t cycle;
+    int64_t timestampNs;
+    uint32_t flags;                 // TELEMETRY_FLAG_*
+    uint32_t sensorCount;
+    uint32_t actuatorCount;
+    uint32_t ecuCount;
+
+    double sensorValues[SNAPSHOT_MAX_SENSORS];
+    int64_t sensorSampleNs[SNAPSHOT_MAX_SENSORS];
+    uint8_t sensorHealthy[SNAPSHOT_MAX_SENSORS];
+    uint8_t vectorCount[SNAPSHOT_MAX_SENSORS];
+    uint16_t vectorOffset[SNAPSHOT_MAX_SENSORS];
+    double vectorValues[SNAPSHOT_MAX_VECTOR_VALUES];
+    double actuatorCommands[SNAPSHOT_MAX_ACTUATORS];
+    double actuatorFeedback[SNAPSHOT_MAX_ACTUATORS];
+
+    uint8_t ecuStatus[STATE_BUS_MAX_ECUS];      // ECUStatus ordinal
+    uint32_t ecuErrors[STATE_BUS_MAX_ECUS];
+    float ecuCpuPercent[STATE_BUS_MAX_ECUS];
+    float ecuMemoryPercent[STATE_BUS_MAX_ECUS];
+    float ecuTemperatureC[STATE_BUS_MAX_ECUS];
+    int64_t ecuLastReplyNs[STATE_BUS_MAX_ECUS];
+};
+
+struct StateBusLayout {
+    StateBusHeader header;
+    StateBusDirectory directory;
+    StateBusFrame frame;
+};
+
+// The Python reader hard-codes these
+static_assert(sizeof(StateBusHeader) == 64, "StateBus header layout changed");
+static_assert(sizeof(StateBusDirectory) == 2560, "StateBus directory layout changed");
+static_assert(sizeof(StateBusFrame) == 2096, "StateBus frame layout changed");
+static_assert(offsetof(StateBusLayout, frame) == 2624, "StateBus frame offset changed");
+static_assert(offsetof(StateBusFrame, ecuLastReplyNs) == 1968, "StateBus frame layout changed");
+
+class StateBusWriter {
+private:
+    std::string name_;
+    StateBusLayout* bus_;
+    StateBusFrame frame_;           // Built here, copied in under the seqlock
+    uint64_t published_;
+
+    static void copyName(char* out, size_t size, const std::string& name) {
+        std::memset(out, 0, size);
+        std::memcpy(out, name.data(), std::min(name.size(), size - 1));
+    }
+
+public:
+    StateBusWriter() : bus_(nullptr), frame_{}, published_(0) {}
+    ~StateBusWriter() { close(); }
+
+    StateBusWriter(const StateBusWriter&) = delete;
+    StateBusWriter& operator=(const StateBusWriter&) = delete;
+
+    // Create (or take over) the region. Readers see magic = 0 until the
+    // header is complete.
+    bool open(const std::string& name = STATE_BUS_NAME, double publishRateHz = 0.0) {
+        close();
+        int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+        if (fd < 0) return false;
+        if (ftruncate(fd, sizeof(StateBusLayout)) != 0) {
+            ::close(fd);
+            return false;
+        }
+        void* region = mmap(nullptr, sizeof(StateBusLayout), PROT_READ | PROT_WRITE,
+                            MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (region == MAP_FAILED) return false;
+
+        name_ = name;
+        bus_ = static_cast<StateBusLayout*>(region);
+        std::memset(bus_, 0, sizeof(StateBusLayout));
+
+        StateBusHeader& header = bus_->header;
+        header.version = STATE_BUS_VERSION;
+        header.headerSize = sizeof(StateBusHeader);
+        header.totalSize = sizeof(StateBusLayout);
+        header.maxSensors = SNAPSHOT_MAX_SENSORS;
+        header.maxActuators = SNAPSHOT_MAX_ACTUATORS;
+        header.maxVectorValues = SNAPSHOT_MAX_VECTOR_VALUES;
+        header.maxEcus = STATE_BUS_MAX_ECUS;
+        header.directoryOffset = offsetof(StateBusLayout, directory);
+        header.frameOffset = offsetof(StateBusLayout, frame);
+        header.writerPid = getpid();
+        header.publishRateHz = publishRateHz;
+        std::atomic_ref<uint32_t>(header.magic).store(STATE_BUS_MAGIC, std::memory_order_release);
+        return true;
+    }
+
+    // Unmaps and removes the region so readers can tell the writer is gone
+    void close() {
+        if (!bus_) return;
+        munmap(bus_, sizeof(StateBusLayout));
+        shm_unlink(name_.c_str());
+        bus_ = nullptr;
+    }
+
+    bool isOpen() const { return bus_ != nullptr; }
+
+    void setSensor(size_t index, const std::string& name, const std::string& units) {
+        if (!bus_ || index >= SNAPSHOT_MAX_SENSORS) return;
+        copyName(bus_->directory.sensors[index].name, 24, name);
+        copyName(bus_->directory.sensors[index].units, 8, units);
+    }
+
+    void setActuator(size_t index, const std::string& name) {
+        if (!bus_ || index >= SNAPSHOT_MAX_ACTUATORS) return;
+        copyName(bus_->directory.actuators[index].name, 32, name);
+    }
+
+    void setECU(size_t index, const std::string& id, const std::string& name) {
+        if (!bus_ || index >= STATE_BUS_MAX_ECUS) return;
+        copyName(bus_->directory.ecus[index].id, 8, id);
+        copyName(bus_->directory.ecus[index].name, 24, name);
+    }
+
+    // Control thread. Copies the snapshot and the manager's cached ECU
+    // health (no ECU is polled here).
+    void publish(const SystemSnapshot& snapshot, uint32_t flags, const ECUManager& ecus) {
+        if (!bus_) return;
+
+        frame_.cycle = snapshot.cycle;
+        frame_.timestampNs = snapshot.timestampNs;
+        frame_.flags = flags;
+        frame_.sensorCount = snapshot.sensorCount;
+        frame_.actuatorCount = snapshot.actuatorCount;
+        std::memcpy(frame_.sensorValues, snapshot.sensorValues, sizeof(frame_.sensorValues));
+        std::memcpy(frame_.sensorSampleNs, snapshot.sensorSampleNs, sizeof(frame_.sensorSampleNs));
+        std::memcpy(frame_.sensorHealthy, snapshot.sensorHealthy, sizeof(frame_.sensorHealthy));
+        std::memcpy(frame_.vectorCount, snapshot.vectorCount, sizeof(frame_.vectorCount));
+        std::memcpy(frame_.vectorOffset, snapshot.vectorOffset, sizeof(frame_.vectorOffset));
+        std::memcpy(frame_.vectorValues, snapshot.vectorValues, sizeof(frame_.vectorValues));
+        std::memcpy(frame_.actuatorCommands, snapshot.actuatorCommands, sizeof(frame_.actuatorCommands));
+        std::memcpy(frame_.actuatorFeedback, snapshot.actuatorFeedback, sizeof(frame_.actuatorFeedback));
+
+        size_t ecuCount = std::min(ecus.getTotalECUCount(), STATE_BUS_MAX_ECUS);
+        frame_.ecuCount = static_cast<uint32_t>(ecuCount);
+        for (ECUHandle handle = 0; handle < ecuCount; handle++) {
+            const ECU& ecu = ecus.ecuAt(handle);
+            frame_.ecuStatus[handle] = static_cast<uint8_t>(ecus.getECUStatus(handle));
+            frame_.ecuErrors[handle] = ecus.getErrorCount(handle);
+            frame_.ecuCpuPercent[handle] = static_cast<float>(ecu.getCPUUsage());
+            frame_.ecuMemoryPercent[handle] = static_cast<float>(ecu.getMemoryUsage());
+            frame_.ecuTemperatureC[handle] = static_cast<float>(ecu.getTemperature());
+            frame_.ecuLastReplyNs[handle] = ecus.getLastCommunicationNs(handle);
+        }
+
+        std::atomic_ref<uint32_t> sequence(bus_->header.sequence);
+        uint32_t value = sequence.load(std::memory_order_relaxed);
+        sequence.store(value + 1, std::memory_order_relaxed);   // Odd: write in progress
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(&bus_->frame, &frame_, sizeof(StateBusFrame));
+        sequence.store(value + 2, std::memory_order_release);
+        published_++;
+    }
+
+    uint64_t getPublishedCount() const { return published_; }
+};
+
+#endif // STATE_BUS_HPP
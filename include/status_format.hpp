@@ -0,0 +1,139 @@
+// StatusFormat - Status and diagnostics text without heap allocation
+#ifndef STATUS_FORMAT_HPP
+#define STATUS_FORMAT_HPP
+
+#include "base.hpp"
+#include <charconv>
+#include <string_view>
+#include <type_traits>
+
+// Appends text and numbers (std::to_chars) to a caller-provided buffer.
+// The buffer is always nul-terminated; what does not fit is dropped and
+// flagged as truncated instead of growing anything.
+class StatusWriter {
+private:
+    char* buffer_;
+    size_t capacity_;               // Excluding the terminator
+    size_t length_;
+    bool truncated_;
+
+    void terminate() { if (buffer_) buffer_[length_] = '\0'; }
+
+public:
+    StatusWriter(char* buffer, size_t size)
+        : buffer_(size > 0 ? buffer : nullptr), capacity_(size > 0 ? size - 1 : 0),
+          length_(0), truncated_(false) {
+        terminate();
+    }
+
+    StatusWriter& text(std::string_view value) {
+        size_t count = std::min(value.size(), capacity_ - length_);
+        if (count < value.size()) truncated_ = true;
+        if (count > 0) std::memcpy(buffer_ + length_, value.data(), count);
+        length_ += count;
+        terminate();
+        return *this;
+    }
+
+    template <typename T, typename = std::enable_if_t<std::is_integral_v<T>>>
+    StatusWriter& number(T value) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        return text(std::string_view(digits, result.ptr - digits));
+    }
+
+    // Fixed notation; 6 decimals matches std::to_string
+    StatusWriter& fixed(double value, int precision = 6) {
+        char digits[64];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value,
+                                    std::chars_format::fixed, precision);
+        if (result.ec != std::errc()) return text("overflow");
+        return text(std::string_view(digits, result.ptr - digits));
+    }
+
+    // Another component's formatStatus() into the remaining space
+    StatusWriter& status(const ISystemComponent& component) {
+        if (!buffer_) return *this;
+        size_t room = capacity_ - length_;
+        length_ += std::min(component.formatStatus(buffer_ + length_, room + 1), room);
+        terminate();
+        return *this;
+    }
+
+    const char* c_str() const { return buffer_ ? buffer_ : ""; }
+    std::string_view view() const { return std::string_view(c_str(), length_); }
+    size_t length() const { return length_; }
+    bool truncated() const { return truncated_; }
+};
+
+// Buffer size for one component's status line
+constexpr size_t STATUS_TEXT_SIZE = 256;
+
+// getStatus() for components that implement formatStatus()
+inline std::string statusText(const ISystemComponent& component) {
+    char buffer[STATUS_TEXT_SIZE];
+    size_t length = component.formatStatus(buffer, sizeof(buffer));
+    return std::string(buffer, std::min(length, sizeof(buffer) - 1));
+}
+
+// Stable 64-bit key for a message (FNV-1a)
+constexpr uint64_t messageKey(std::string_view text) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (char c : text) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Deduplicates a repeating warning. A message with a new key is let
+// through at once; the same key again only after the interval, carrying
+// the number of repeats that were held back in between.
+class WarningLimiter {
+private:
+    int64_t intervalNs_;
+    uint64_t key_;
+    int64_t lastLoggedNs_;
+    uint32_t suppressed_;
+    uint64_t totalSuppressed_;
+    bool active_;
+
+public:
+    explicit WarningLimiter(int64_t intervalNs = 30000000000LL)
+        : intervalNs_(intervalNs), key_(0), lastLoggedNs_(0), suppressed_(0),
+          totalSuppressed_(0), active_(false) {}
+
+    // True if the message should be logged now
+    bool allow(uint64_t key, int64_t nowNs) {
+        if (active_ && key == key_ && nowNs - lastLoggedNs_ < intervalNs_) {
+            suppressed_++;
+            totalSuppressed_++;
+            return false;
+        }
+        if (!active_ || key != key_) suppressed_ = 0;
+        key_ = key;
+        lastLoggedNs_ = nowNs;
+        active_ = true;
+        return true;
+    }
+
+    // Repeats held back before the message allow() just let through
+    uint32_t takeSuppressed() {
+        uint32_t count = suppressed_;
+        suppressed_ = 0;
+        return count;
+    }
+
+    // The condition cleared; true if a warning had been logged for it
+    bool clear() {
+        bool wasActive = active_;
+        active_ = false;
+        suppressed_ = 0;
+        return wasActive;
+    }
+
+    bool isActive() const { return active_; }
+    uint64_t getTotalSuppressed() const { return totalSuppressed_; }
+};
+
+#endif // STATUS_FORMAT_HPP
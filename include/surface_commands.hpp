@@ -0,0 +1,261 @@
+// SurfaceCommands
+#ifndef SURFACE_COMMANDS_HPP
+#define SURFACE_COMMANDS_HPP
+
+#include "base.hpp"
+#include "telemetry.hpp"
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+// Surface command packet (version 1, little-endian)
+//
+//   Offset  Size  Field
+//   0       2     Magic 0x4354 ("TC")
+//   2       1     Version
+//   3       1     Command count (N)
+//   4       4     Sequence number (increases by one per packet)
+//   8       ..    N commands: [1] opcode  [1] payload length L  [L] payload
+//   ..      2     CRC-16/CCITT over all preceding bytes
+//
+// The opcode's high nibble is its priority class. A packet is accepted
+// whole or not at all; one whose sequence is not newer than the last
+// accepted packet is a duplicate and dropped.
+constexpr uint16_t SURFACE_COMMAND_MAGIC = 0x4354;
+constexpr uint8_t SURFACE_COMMAND_VERSION = 1;
+constexpr size_t SURFACE_COMMAND_HEADER_SIZE = 8;
+constexpr size_t SURFACE_COMMAND_MAX_PAYLOAD = 64;
+
+enum class CommandPriority : uint8_t {
+    EMERGENCY,      // E-stop and interlock reset: all applied every cycle
+    SETPOINT,       // Auto modes and setpoints: all applied every cycle
+    CONFIG,         // Loop tuning: a few per cycle
+    BULK            // Operator notes and the like: one per cycle
+};
+
+constexpr size_t COMMAND_PRIORITY_COUNT = 4;
+
+enum class SurfaceOpcode : uint8_t {
+    EMERGENCY_STOP = 0x01,      // No payload
+    RESET_INTERLOCK = 0x02,     // No payload
+    SET_AUTO_DEPTH = 0x10,      // [1] enabled  [4] setpoint PSI (float32)
+    SET_AUTO_HEADING = 0x11,    // [1] enabled  [4] setpoint degrees (float32)
+    SET_LOOP_GAINS = 0x20,      // [1] loop (0 depth, 1 heading)  [4] kp  [4] ki  [4] kd
+    REQUEST_KEYFRAME = 0x21,    // No payload: resync the telemetry downlink
+    OPERATOR_NOTE = 0x30        // [L] text, written to the log
+};
+
+inline CommandPriority commandPriority(uint8_t opcode) {
+    return static_cast<CommandPriority>(std::min<uint8_t>(opcode >> 4, COMMAND_PRIORITY_COUNT - 1));
+}
+
+struct SurfaceCommand {
+    uint32_t sequence;          // Of the packet it came in
+    uint8_t opcode;
+    uint8_t length;
+    uint8_t payload[SURFACE_COMMAND_MAX_PAYLOAD];
+
+    float getFloat(size_t offset) const {
+        float value = 0.0f;
+        if (offset + 4 <= length) std::memcpy(&value, payload + offset, 4);
+        return value;
+    }
+};
+
+// Builds a packet (surface side; also used by the simulator)
+class SurfaceCommandEncoder {
+private:
+    std::array<uint8_t, MAX_FRAME_SIZE> buffer_;
+    size_t length_;
+    uint8_t count_;
+
+public:
+    SurfaceCommandEncoder() : length_(0), count_(0) {}
+
+    void begin(uint32_t sequence) {
+        putU16(buffer_.data(), SURFACE_COMMAND_MAGIC);
+        buffer_[2] = SURFACE_COMMAND_VERSION;
+        buffer_[3] = 0;
+        putU32(buffer_.data() + 4, sequence);
+        length_ = SURFACE_COMMAND_HEADER_SIZE;
+        count_ = 0;
+    }
+
+    // False if the command does not fit
+    bool add(SurfaceOpcode opcode, const void* payload = nullptr, size_t length = 0) {
+        if (length > SURFACE_COMMAND_MAX_PAYLOAD || count_ == UINT8_MAX ||
+            length_ + 2 + length + TELEMETRY_CRC_SIZE > buffer_.size()) {
+            return false;
+        }
+        buffer_[length_] = static_cast<uint8_t>(opcode);
+        buffer_[length_ + 1] = static_cast<uint8_t>(length);
+        if (length > 0) std::memcpy(buffer_.data() + length_ + 2, payload, length);
+        length_ += 2 + length;
+        buffer_[3] = ++count_;
+        return true;
+    }
+
+    bool addMode(SurfaceOpcode opcode, bool enabled, float setpoint) {
+        uint8_t payload[5] = {static_cast<uint8_t>(enabled ? 1 : 0)};
+        std::memcpy(payload + 1, &setpoint, 4);
+        return add(opcode, payload, sizeof(payload));
+    }
+
+    std::span<const uint8_t> finish() {
+        putU16(buffer_.data() + length_, crc16Ccitt(buffer_.data(), length_));
+        return std::span<const uint8_t>(buffer_.data(), length_ + TELEMETRY_CRC_SIZE);
+    }
+};
+
+// Single-pass parser feeding one bounded queue per priority class, plus
+// the per-cycle drain. Both run on the control thread: packets are parsed
+// as the COMMUNICATION stage receives them and the queues are drained at
+// the start of the next cycle, highest class first, so an e-stop is
+// applied within one cycle however much config or bulk traffic is queued
+// ahead of it. Nothing allocates after construction.
+class SurfaceCommandIntake {
+private:
+    static constexpr size_t QUEUE_SLOTS = 32;
+    static constexpr std::array<size_t, COMMAND_PRIORITY_COUNT> QUEUE_CAPACITY = {8, 16, 32, 32};
+    static constexpr std::array<size_t, COMMAND_PRIORITY_COUNT> PER_CYCLE = {8, 16, 4, 1};
+
+    struct Queue {
+        std::array<SurfaceCommand, QUEUE_SLOTS> slots;
+        size_t head;
+        size_t count;
+    };
+
+    std::array<Queue, COMMAND_PRIORITY_COUNT> queues_;
+    uint32_t lastSequence_;
+    bool sequenced_;            // A packet has been accepted
+
+    uint64_t packets_;
+    uint64_t commands_;
+    uint64_t rejected_;         // Bad CRC, version or layout
+    uint64_t duplicates_;
+    uint64_t gaps_;             // Packets missing between accepted ones
+    uint64_t dropped_;          // Queue full
+    std::array<uint64_t, COMMAND_PRIORITY_COUNT> applied_;
+
+    bool push(const SurfaceCommand& command) {
+        size_t priority = static_cast<size_t>(commandPriority(command.opcode));
+        Queue& queue = queues_[priority];
+        size_t capacity = QUEUE_CAPACITY[priority];
+        if (queue.count >= capacity) {
+            dropped_++;
+            return false;
+        }
+        queue.slots[(queue.head + queue.count) % capacity] = command;
+        queue.count++;
+        return true;
+    }
+
+public:
+    SurfaceCommandIntake()
+        : queues_{}, lastSequence_(0), sequenced_(false), packets_(0), commands_(0),
+          rejected_(0), duplicates_(0), gaps_(0), dropped_(0), applied_{} {}
+
+    static bool isCommandPacket(const uint8_t* data, size_t length) {
+        return length >= 2 && getU16(data) == SURFACE_COMMAND_MAGIC;
+    }
+
+    // Queues every command of a packet. False if the packet was rejected
+    // or a duplicate.
+    bool parse(const uint8_t* data, size_t length) {
+        if (length < SURFACE_COMMAND_HEADER_SIZE + TELEMETRY_CRC_SIZE ||
+            getU16(data) != SURFACE_COMMAND_MAGIC || data[2] != SURFACE_COMMAND_VERSION ||
+            getU16(data + length - TELEMETRY_CRC_SIZE) !=
+                crc16Ccitt(data, length - TELEMETRY_CRC_SIZE)) {
+            rejected_++;
+            return false;
+        }
+
+        uint32_t sequence = getU32(data + 4);
+        int32_t ahead = static_cast<int32_t>(sequence - lastSequence_);
+        if (sequenced_ && ahead <= 0) {
+            duplicates_++;
+            return false;
+        }
+
+        // One pass over the records, queueing as it goes; a layout error
+        // rolls the queues back so the packet is not half applied
+        std::array<size_t, COMMAND_PRIORITY_COUNT> counts;
+        for (size_t i = 0; i < COMMAND_PRIORITY_COUNT; i++) counts[i] = queues_[i].count;
+        uint64_t dropped = dropped_;
+
+        size_t count = data[3];
+        size_t end = length - TELEMETRY_CRC_SIZE;
+        size_t offset = SURFACE_COMMAND_HEADER_SIZE;
+        size_t queued = 0;
+        bool valid = true;
+        for (size_t i = 0; i < count; i++) {
+            size_t payload = offset + 2 <= end ? data[offset + 1] : SIZE_MAX;
+            if (payload > SURFACE_COMMAND_MAX_PAYLOAD || offset + 2 + payload > end) {
+                valid = false;
+                break;
+            }
+            SurfaceCommand command;
+            command.sequence = sequence;
+            command.opcode = data[offset];
+            command.length = static_cast<uint8_t>(payload);
+            std::memcpy(command.payload, data + offset + 2, payload);
+            if (push(command)) queued++;
+            offset += 2 + payload;
+        }
+        if (!valid || offset != end) {
+            for (size_t i = 0; i < COMMAND_PRIORITY_COUNT; i++) queues_[i].count = counts[i];
+            dropped_ = dropped;
+            rejected_++;
+            return false;
+        }
+
+        if (sequenced_) gaps_ += static_cast<uint32_t>(ahead - 1);
+        lastSequence_ = sequence;
+        sequenced_ = true;
+        packets_++;
+        commands_ += queued;
+        return true;
+    }
+
+    // Applies queued commands, highest class first, up to each class's
+    // per-cycle budget. Returns the number applied.
+    template <typename Apply>
+    size_t drain(Apply&& apply) {
+        size_t total = 0;
+        for (size_t priority = 0; priority < COMMAND_PRIORITY_COUNT; priority++) {
+            Queue& queue = queues_[priority];
+            for (size_t n = 0; n < PER_CYCLE[priority] && queue.count > 0; n++) {
+                const SurfaceCommand& command = queue.slots[queue.head];
+                apply(command);
+                queue.head = (queue.head + 1) % QUEUE_CAPACITY[priority];
+                queue.count--;
+                applied_[priority]++;
+                total++;
+            }
+        }
+        return total;
+    }
+
+    size_t getPending(CommandPriority priority) const {
+        return queues_[static_cast<size_t>(priority)].count;
+    }
+    uint64_t getApplied(CommandPriority priority) const {
+        return applied_[static_cast<size_t>(priority)];
+    }
+    uint64_t getPacketCount() const { return packets_; }
+    uint64_t getRejectedCount() const { return rejected_; }
+    uint64_t getDuplicateCount() const { return duplicates_; }
+    uint64_t getDroppedCount() const { return dropped_; }
+
+    uint64_t getMissedCount() const { return gaps_; }
+
+    std::string getStatus() const {
+        return "Surface commands: " + std::to_string(packets_) + " packets, " +
+               std::to_string(commands_) + " commands (" +
+               std::to_string(applied_[0]) + " emergency), " + std::to_string(rejected_) +
+               " rejected, " + std::to_string(duplicates_) + " duplicates, " +
+               std::to_string(gaps_) + " missed, " + std::to_string(dropped_) + " dropped";
+    }
+};
+
+#endif // SURFACE_COMMANDS_HPP
@@ -0,0 +1,195 @@
+// TeensyProtocol
+#ifndef TEENSY_PROTOCOL_HPP
+#define TEENSY_PROTOCOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// Binary packets exchanged with the Teensy nodes over the framed serial
+// link (see framing.hpp). Byte 0 of every payload is the packet type;
+// multi-byte fields are little-endian. Keep in sync with the sketches
+// under teensy41/.
+enum class TeensyPacketType : uint8_t {
+    IMU_QUATERNION = 0x01,   // Teensy -> Pi
+    ACTUATOR_FRAME = 0x02,   // Pi -> Teensy
+    TIME_PING = 0x03,        // Pi -> Teensy
+    TIME_PONG = 0x04         // Teensy -> Pi
+};
+
+inline void putLittleEndian(uint8_t* out, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++) out[i] = static_cast<uint8_t>(value >> (8 * i));
+}
+
+inline uint64_t getLittleEndian(const uint8_t* in, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; i++) value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    return value;
+}
+
+// IMU_QUATERNION: game rotation vector, Q14 fixed point (1.0 = 16384)
+//   [0] type  [1] sequence  [2..3] real  [4..5] i  [6..7] j  [8..9] k
+//   [10..13] node micros() when the sensor took the sample
+// Sketches older than the timestamp send the first 10 bytes only.
+constexpr size_t IMU_QUATERNION_PACKET_SIZE = 10;
+constexpr size_t IMU_QUATERNION_TIMED_PACKET_SIZE = 14;
+constexpr float QUATERNION_Q14_SCALE = 1.0f / 16384.0f;
+
+struct QuaternionSample {
+    uint8_t sequence;
+    float w, x, y, z;
+    bool timed;             // deviceUs is valid
+    uint32_t deviceUs;
+};
+
+inline bool parseImuQuaternion(const uint8_t* payload, size_t length,
+                               QuaternionSample& out) {
+    if (length < IMU_QUATERNION_PACKET_SIZE ||
+        payload[0] != static_cast<uint8_t>(TeensyPacketType::IMU_QUATERNION)) {
+        return false;
+    }
+    auto q14 = [payload](size_t offset) {
+        int16_t raw = static_cast<int16_t>(payload[offset] | (payload[offset + 1] << 8));
+        return raw * QUATERNION_Q14_SCALE;
+    };
+    out.sequence = payload[1];
+    out.w = q14(2);
+    out.x = q14(4);
+    out.y = q14(6);
+    out.z = q14(8);
+    out.timed = length >= IMU_QUATERNION_TIMED_PACKET_SIZE;
+    out.deviceUs = out.timed ? static_cast<uint32_t>(getLittleEndian(payload + 10, 4)) : 0;
+    return true;
+}
+
+// Inverse of parseImuQuaternion (the sketch's encoder; used by the simulator)
+inline size_t encodeImuQuaternion(const QuaternionSample& sample, uint8_t* out) {
+    auto q14 = [out](size_t offset, float value) {
+        float scaled = value * 16384.0f;
+        scaled = scaled > 32767.0f ? 32767.0f : (scaled < -32768.0f ? -32768.0f : scaled);
+        uint16_t raw = static_cast<uint16_t>(static_cast<int16_t>(scaled + (scaled >= 0 ? 0.5f : -0.5f)));
+        out[offset] = static_cast<uint8_t>(raw & 0xFF);
+        out[offset + 1] = static_cast<uint8_t>(raw >> 8);
+    };
+    out[0] = static_cast<uint8_t>(TeensyPacketType::IMU_QUATERNION);
+    out[1] = sample.sequence;
+    q14(2, sample.w);
+    q14(4, sample.x);
+    q14(6, sample.y);
+    q14(8, sample.z);
+    if (!sample.timed) return IMU_QUATERNION_PACKET_SIZE;
+    putLittleEndian(out + 10, sample.deviceUs, 4);
+    return IMU_QUATERNION_TIMED_PACKET_SIZE;
+}
+
+// TIME_PING / TIME_PONG: one clock-sync exchange (see time_sync.hpp)
+//   PING  [0] type  [1] sequence  [2..9] Pi monotonic ns as it was sent
+//   PONG  [0] type  [1] sequence  [2..9] the ping's Pi time, echoed
+//         [10..13] micros() when the ping arrived
+//         [14..17] micros() as the pong was written
+// The node answers every ping at once and keeps no state. The Pi time is
+// restamped as the ping is written to the port (stampTimePing), so time
+// spent in send queues does not count as transport delay.
+constexpr size_t TIME_PING_PACKET_SIZE = 10;
+constexpr size_t TIME_PONG_PACKET_SIZE = 18;
+
+struct TimePong {
+    uint8_t sequence;
+    int64_t pingNs;
+    uint32_t receiveUs;
+    uint32_t transmitUs;
+};
+
+inline size_t encodeTimePing(uint8_t sequence, int64_t sentNs, uint8_t* out) {
+    out[0] = static_cast<uint8_t>(TeensyPacketType::TIME_PING);
+    out[1] = sequence;
+    putLittleEndian(out + 2, static_cast<uint64_t>(sentNs), 8);
+    return TIME_PING_PACKET_SIZE;
+}
+
+// Overwrites the send time if the payload is a TIME_PING; false otherwise
+inline bool stampTimePing(uint8_t* payload, size_t length, int64_t sentNs) {
+    if (length != TIME_PING_PACKET_SIZE ||
+        payload[0] != static_cast<uint8_t>(TeensyPacketType::TIME_PING)) {
+        return false;
+    }
+    putLittleEndian(payload + 2, static_cast<uint64_t>(sentNs), 8);
+    return true;
+}
+
+// The sketch's reply (used by the simulator)
+inline size_t encodeTimePong(const TimePong& pong, uint8_t* out) {
+    out[0] = static_cast<uint8_t>(TeensyPacketType::TIME_PONG);
+    out[1] = pong.sequence;
+    putLittleEndian(out + 2, static_cast<uint64_t>(pong.pingNs), 8);
+    putLittleEndian(out + 10, pong.receiveUs, 4);
+    putLittleEndian(out + 14, pong.transmitUs, 4);
+    return TIME_PONG_PACKET_SIZE;
+}
+
+inline bool parseTimePong(const uint8_t* payload, size_t length, TimePong& out) {
+    if (length < TIME_PONG_PACKET_SIZE ||
+        payload[0] != static_cast<uint8_t>(TeensyPacketType::TIME_PONG)) {
+        return false;
+    }
+    out.sequence = payload[1];
+    out.pingNs = static_cast<int64_t>(getLittleEndian(payload + 2, 8));
+    out.receiveUs = static_cast<uint32_t>(getLittleEndian(payload + 10, 4));
+    out.transmitUs = static_cast<uint32_t>(getLittleEndian(payload + 14, 4));
+    return true;
+}
+
+// The node's side of the exchange (used by the simulator)
+inline bool parseTimePing(const uint8_t* payload, size_t length, uint8_t& sequence,
+                          int64_t& sentNs) {
+    if (length < TIME_PING_PACKET_SIZE ||
+        payload[0] != static_cast<uint8_t>(TeensyPacketType::TIME_PING)) {
+        return false;
+    }
+    sequence = payload[1];
+    sentNs = static_cast<int64_t>(getLittleEndian(payload + 2, 8));
+    return true;
+}
+
+// ACTUATOR_FRAME: every output channel of one node in one packet
+//   [0] type  [1] sequence  [2] channel mask (bit n = channel n driven)
+//   [3..18] channels 0..7, int16 command in 0.01 % (-10000 .. 10000)
+// Channels outside the mask stay at the node's failsafe output. The node
+// falls back to failsafe on every channel if no frame arrives within
+// ACTUATOR_FRAME_TIMEOUT_MS; the Pi resends unchanged frames well inside it.
+constexpr size_t ACTUATOR_FRAME_CHANNELS = 8;
+constexpr size_t ACTUATOR_FRAME_PACKET_SIZE = 3 + 2 * ACTUATOR_FRAME_CHANNELS;
+constexpr double ACTUATOR_COMMAND_SCALE = 100.0;
+constexpr uint32_t ACTUATOR_FRAME_TIMEOUT_MS = 500;
+
+struct ActuatorFrame {
+    uint8_t sequence;
+    uint8_t mask;
+    int16_t values[ACTUATOR_FRAME_CHANNELS];
+};
+
+inline size_t encodeActuatorFrame(const ActuatorFrame& frame, uint8_t* out) {
+    out[0] = static_cast<uint8_t>(TeensyPacketType::ACTUATOR_FRAME);
+    out[1] = frame.sequence;
+    out[2] = frame.mask;
+    for (size_t i = 0; i < ACTUATOR_FRAME_CHANNELS; i++) {
+        uint16_t raw = static_cast<uint16_t>(frame.values[i]);
+        out[3 + 2 * i] = static_cast<uint8_t>(raw & 0xFF);
+        out[4 + 2 * i] = static_cast<uint8_t>(raw >> 8);
+    }
+    return ACTUATOR_FRAME_PACKET_SIZE;
+}
+
+inline bool parseActuatorFrame(const uint8_t* payload, size_t length, ActuatorFrame& out) {
+    if (length < ACTUATOR_FRAME_PACKET_SIZE ||
+        payload[0] != static_cast<uint8_t>(TeensyPacketType::ACTUATOR_FRAME)) {
+        return false;
+    }
+    out.sequence = payload[1];
+    out.mask = payload[2];
+    for (size_t i = 0; i < ACTUATOR_FRAME_CHANNELS; i++) {
+        out.values[i] = static_cast<int16_t>(payload[3 + 2 * i] | (payload[4 + 2 * i] << 8));
+    }
+    return true;
+}
+
+#endif // TEENSY_PROTOCOL_HPP
@@ -0,0 +1,209 @@
+// Telemetry
+#ifndef TELEMETRY_HPP
+#define TELEMETRY_HPP
+
+#include "crc.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+
+// Telemetry frame wire format (version 1, little-endian)
+//
+//   Offset  Size  Field
+//   0       2     Magic 0x5442 ("TB")
+//   2       1     Version
+//   3       1     Flags (TELEMETRY_FLAG_*)
+//   4       4     Sequence number
+//   8       4     Timestamp (ms since system start, monotonic)
+//   12      1     Sensor count (S)
+//   13      1     Actuator count (A)
+//   14      1     ECU count (E)
+//   15      1     Reserved
+//   16      4*S   Sensor values (float32)
+//   ..      S/8   Sensor healthy bitmask (rounded up)
+//   ..      4*A   Actuator command, feedback (int16, value x 100)
+//   ..      E/2   ECU status, 4 bits each (ECUStatus ordinal, rounded up)
+//   ..      2     CRC-16/CCITT over all preceding bytes
+constexpr uint16_t TELEMETRY_MAGIC = 0x5442;
+constexpr uint8_t TELEMETRY_VERSION = 1;
+constexpr size_t TELEMETRY_FRAME_HEADER_SIZE = 16;
+constexpr size_t TELEMETRY_CRC_SIZE = 2;
+constexpr double TELEMETRY_ACTUATOR_SCALE = 100.0;
+
+constexpr uint8_t TELEMETRY_FLAG_SAFETY_FAULT = 0x01;
+constexpr uint8_t TELEMETRY_FLAG_AUTO_DEPTH = 0x02;
+constexpr uint8_t TELEMETRY_FLAG_AUTO_HEADING = 0x04;
+constexpr uint8_t TELEMETRY_FLAG_ECUS_DEGRADED = 0x08;
+
+inline size_t telemetryFrameSize(size_t sensors, size_t actuators, size_t ecus) {
+    return TELEMETRY_FRAME_HEADER_SIZE + 4 * sensors + (sensors + 7) / 8 +
+           4 * actuators + (ecus + 1) / 2 + TELEMETRY_CRC_SIZE;
+}
+
+// Little-endian field helpers
+inline void putU16(uint8_t* p, uint16_t v) {
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+inline void putU32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+inline uint16_t getU16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+inline uint32_t getU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline int16_t quantizeActuator(double value) {
+    double scaled = std::round(value * TELEMETRY_ACTUATOR_SCALE);
+    return static_cast<int16_t>(std::clamp(scaled, -32768.0, 32767.0));
+}
+
+// Per-cycle values to serialize. Views only; the caller owns the arrays.
+struct TelemetryInput {
+    uint32_t timestampMs;
+    uint8_t flags;
+    const double* sensorValues;
+    const uint8_t* sensorHealthy;
+    size_t sensorCount;
+    const double* actuatorCommands;
+    const double* actuatorFeedback;
+    size_t actuatorCount;
+    const uint8_t* ecuStatus;
+    size_t ecuCount;
+};
+
+// Serializes frames into one reusable buffer. After the first frame of a
+// given shape, encode() does not allocate.
+class TelemetryEncoder {
+private:
+    std::vector<uint8_t> buffer_;
+    uint32_t sequence_;
+
+public:
+    TelemetryEncoder() : sequence_(0) {}
+
+    const std::vector<uint8_t>& encode(const TelemetryInput& in) {
+        size_t sensors = std::min<size_t>(in.sensorCount, 255);
+        size_t actuators = std::min<size_t>(in.actuatorCount, 255);
+        size_t ecus = std::min<size_t>(in.ecuCount, 255);
+
+        buffer_.resize(telemetryFrameSize(sensors, actuators, ecus));
+        uint8_t* p = buffer_.data();
+
+        putU16(p, TELEMETRY_MAGIC);
+        p[2] = TELEMETRY_VERSION;
+        p[3] = in.flags;
+        putU32(p + 4, sequence_++);
+        putU32(p + 8, in.timestampMs);
+        p[12] = static_cast<uint8_t>(sensors);
+        p[13] = static_cast<uint8_t>(actuators);
+        p[14] = static_cast<uint8_t>(ecus);
+        p[15] = 0;
+        p += TELEMETRY_FRAME_HEADER_SIZE;
+
+        for (size_t i = 0; i < sensors; i++) {
+            float value = static_cast<float>(in.sensorValues[i]);
+            std::memcpy(p, &value, 4);
+            p += 4;
+        }
+
+        size_t maskBytes = (sensors + 7) / 8;
+        std::memset(p, 0, maskBytes);
+        for (size_t i = 0; i < sensors; i++) {
+            if (in.sensorHealthy[i]) p[i / 8] |= static_cast<uint8_t>(1u << (i % 8));
+        }
+        p += maskBytes;
+
+        for (size_t i = 0; i < actuators; i++) {
+            putU16(p, static_cast<uint16_t>(quantizeActuator(in.actuatorCommands[i])));
+            putU16(p + 2, static_cast<uint16_t>(quantizeActuator(in.actuatorFeedback[i])));
+            p += 4;
+        }
+
+        size_t statusBytes = (ecus + 1) / 2;
+        std::memset(p, 0, statusBytes);
+        for (size_t i = 0; i < ecus; i++) {
+            p[i / 2] |= static_cast<uint8_t>((in.ecuStatus[i] & 0x0F) << (4 * (i % 2)));
+        }
+        p += statusBytes;
+
+        size_t crcOffset = static_cast<size_t>(p - buffer_.data());
+        putU16(p, crc16Ccitt(buffer_.data(), crcOffset));
+
+        return buffer_;
+    }
+
+    const std::vector<uint8_t>& getFrame() const { return buffer_; }
+    uint32_t getSequence() const { return sequence_; }
+};
+
+// Decoded frame (surface side)
+struct TelemetryFrame {
+    uint8_t version;
+    uint8_t flags;
+    uint32_t sequence;
+    uint32_t timestampMs;
+    std::vector<float> sensorValues;
+    std::vector<bool> sensorHealthy;
+    std::vector<double> actuatorCommands;
+    std::vector<double> actuatorFeedback;
+    std::vector<uint8_t> ecuStatus;
+};
+
+// Validate and decode one frame. Returns false on bad magic, version,
+// length or CRC.
+inline bool decodeTelemetryFrame(const uint8_t* data, size_t length, TelemetryFrame& out) {
+    if (length < TELEMETRY_FRAME_HEADER_SIZE + TELEMETRY_CRC_SIZE) return false;
+    if (getU16(data) != TELEMETRY_MAGIC || data[2] != TELEMETRY_VERSION) return false;
+
+    size_t sensors = data[12];
+    size_t actuators = data[13];
+    size_t ecus = data[14];
+    size_t frameSize = telemetryFrameSize(sensors, actuators, ecus);
+    if (length < frameSize) return false;
+
+    size_t crcOffset = frameSize - TELEMETRY_CRC_SIZE;
+    if (getU16(data + crcOffset) != crc16Ccitt(data, crcOffset)) return false;
+
+    out.version = data[2];
+    out.flags = data[3];
+    out.sequence = getU32(data + 4);
+    out.timestampMs = getU32(data + 8);
+
+    const uint8_t* p = data + TELEMETRY_FRAME_HEADER_SIZE;
+    out.sensorValues.resize(sensors);
+    for (size_t i = 0; i < sensors; i++) {
+        std::memcpy(&out.sensorValues[i], p, 4);
+        p += 4;
+    }
+
+    out.sensorHealthy.resize(sensors);
+    for (size_t i = 0; i < sensors; i++) {
+        out.sensorHealthy[i] = (p[i / 8] >> (i % 8)) & 1;
+    }
+    p += (sensors + 7) / 8;
+
+    out.actuatorCommands.resize(actuators);
+    out.actuatorFeedback.resize(actuators);
+    for (size_t i = 0; i < actuators; i++) {
+        out.actuatorCommands[i] = static_cast<int16_t>(getU16(p)) / TELEMETRY_ACTUATOR_SCALE;
+        out.actuatorFeedback[i] = static_cast<int16_t>(getU16(p + 2)) / TELEMETRY_ACTUATOR_SCALE;
+        p += 4;
+    }
+
+    out.ecuStatus.resize(ecus);
+    for (size_t i = 0; i < ecus; i++) {
+        out.ecuStatus[i] = (p[i / 2] >> (4 * (i % 2))) & 0x0F;
+    }
+    return true;
+}
+
+#endif // TELEMETRY_HPP
@@ -0,0 +1,485 @@
+// TelemetryDelta
+#ifndef TELEMETRY_DELTA_HPP
+#define TELEMETRY_DELTA_HPP
+
+#include "telemetry.hpp"
+#include <array>
+#include <span>
+#include <string>
+
+// Compressed downlink (version 1, little-endian). Every value travels as
+// an integer count of its channel's resolution, zigzag + LEB128 varint
+// encoded.
+//
+//   Offset  Size  Field
+//   0       2     Magic 0x5444 ("TD")
+//   2       1     Version
+//   3       1     Frame type (TELEMETRY_KEYFRAME / TELEMETRY_DELTA)
+//   4       1     Flags (TELEMETRY_FLAG_*)
+//
+//   KEYFRAME (the whole state, every keyframe interval)
+//     4     Sequence number
+//     4     Timestamp (ms since system start)
+//     1     Sensor count (S), 1 actuator count (A), 1 ECU count (E)
+//     4*S   Sensor resolution (float32)
+//     S/8   Sensor healthy bitmask
+//     ..    Counts of the S sensors, A commands, A feedbacks (varint;
+//           actuators always in 1 / TELEMETRY_ACTUATOR_SCALE)
+//     E/2   ECU status nibbles
+//
+//   DELTA (only what changed since the frame before it)
+//     1     Sequence number, low byte
+//     ..    Milliseconds since the frame before it (varint)
+//     1     Sections: bit 0 healthy mask present, bit 1 ECU status present
+//     ..    Changed bitmap over S sensors, A commands, A feedbacks
+//     S/8   Sensor healthy bitmask (if present)
+//     E/2   ECU status nibbles (if present)
+//     ..    Count difference per changed channel (varint), bitmap order
+//
+//   ..      2     CRC-16/CCITT over all preceding bytes
+//
+// A delta applies to the frame before it: after a lost frame the
+// receiver waits for the next keyframe. Non-finite values go out as 0
+// (the healthy bit says whether to trust them).
+constexpr uint16_t TELEMETRY_DELTA_MAGIC = 0x5444;
+constexpr uint8_t TELEMETRY_DELTA_VERSION = 1;
+constexpr uint8_t TELEMETRY_KEYFRAME = 1;
+constexpr uint8_t TELEMETRY_DELTA = 2;
+constexpr uint8_t TELEMETRY_SECTION_HEALTH = 0x01;
+constexpr uint8_t TELEMETRY_SECTION_ECUS = 0x02;
+constexpr size_t TELEMETRY_KEYFRAME_HEADER_SIZE = 16;
+constexpr uint32_t TELEMETRY_KEYFRAME_INTERVAL_MS = 1000;
+
+// How a channel is quantized and how often it may be resent
+struct TelemetryChannelConfig {
+    double resolution;          // Value of one count on the wire
+    double deadband;            // Change needed before it is resent (0 = one count)
+    double maxRateHz;           // Resend cap between keyframes (0 = every frame)
+};
+
+constexpr TelemetryChannelConfig TELEMETRY_SENSOR_DEFAULT{0.001, 0.0, 0.0};
+constexpr TelemetryChannelConfig TELEMETRY_ACTUATOR_DEFAULT{1.0 / TELEMETRY_ACTUATOR_SCALE, 0.0, 0.0};
+
+inline size_t putVarint(uint8_t* p, int64_t value) {
+    uint64_t zigzag = (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    size_t n = 0;
+    while (zigzag >= 0x80) {
+        p[n++] = static_cast<uint8_t>(zigzag | 0x80);
+        zigzag >>= 7;
+    }
+    p[n++] = static_cast<uint8_t>(zigzag);
+    return n;
+}
+
+// 0 if the varint runs past end or is longer than 10 bytes
+inline size_t getVarint(const uint8_t* p, const uint8_t* end, int64_t& value) {
+    uint64_t zigzag = 0;
+    for (size_t n = 0; n < 10 && p + n < end; n++) {
+        zigzag |= static_cast<uint64_t>(p[n] & 0x7F) << (7 * n);
+        if (!(p[n] & 0x80)) {
+            value = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+            return n + 1;
+        }
+    }
+    return 0;
+}
+
+inline int64_t quantizeCount(double value, double resolution) {
+    if (!std::isfinite(value) || resolution <= 0.0) return 0;
+    constexpr double LIMIT = 9.0e15;   // Well inside int64 and a double's integers
+    return static_cast<int64_t>(std::clamp(std::round(value / resolution), -LIMIT, LIMIT));
+}
+
+// Stateful encoder: one instance per downlink, fed every frame the link
+// sends. Same input as TelemetryEncoder; after the first keyframe of a
+// given shape, encode() does not allocate.
+class TelemetryDeltaEncoder {
+private:
+    struct Channel {
+        TelemetryChannelConfig config;
+        int64_t sent;               // Count the receiver holds
+        uint32_t sentMs;
+    };
+
+    std::vector<uint8_t> buffer_;           // Sized for the worst case
+    size_t frameLength_;
+    std::vector<Channel> channels_;         // Sensors, then commands, then feedbacks
+    std::vector<TelemetryChannelConfig> sensorConfig_;
+    std::vector<TelemetryChannelConfig> actuatorConfig_;
+    std::array<uint8_t, 32> sentHealthy_;
+    std::array<uint8_t, 128> sentEcus_;
+    size_t sensors_;
+    size_t actuators_;
+    size_t ecus_;
+    uint32_t sequence_;
+    uint32_t keyframeIntervalMs_;
+    uint32_t lastKeyframeMs_;
+    uint32_t lastFrameMs_;
+    bool keyframeDue_;
+
+    uint64_t keyframes_;
+    uint64_t deltas_;
+    uint64_t bytes_;
+    uint64_t fullBytes_;                    // What full frames would have cost
+
+    void reshape(size_t sensors, size_t actuators, size_t ecus) {
+        sensors_ = sensors;
+        actuators_ = actuators;
+        ecus_ = ecus;
+        channels_.assign(sensors + 2 * actuators, Channel{TELEMETRY_SENSOR_DEFAULT, 0, 0});
+        for (size_t i = 0; i < sensors; i++) {
+            if (i < sensorConfig_.size()) channels_[i].config = sensorConfig_[i];
+            // Counts are scaled by the float32 resolution the receiver gets
+            channels_[i].config.resolution =
+                static_cast<float>(channels_[i].config.resolution);
+        }
+        for (size_t i = 0; i < actuators; i++) {
+            TelemetryChannelConfig config =
+                i < actuatorConfig_.size() ? actuatorConfig_[i] : TELEMETRY_ACTUATOR_DEFAULT;
+            channels_[sensors + i].config = config;
+            channels_[sensors + actuators + i].config = config;
+        }
+        buffer_.resize(TELEMETRY_FRAME_HEADER_SIZE + 1 + (channels_.size() + 7) / 8 +
+                       4 * sensors + 10 * channels_.size() + (sensors + 7) / 8 +
+                       (ecus + 1) / 2 + TELEMETRY_CRC_SIZE);
+        keyframeDue_ = true;
+    }
+
+    double channelValue(const TelemetryInput& in, size_t index) const {
+        if (index < sensors_) return in.sensorValues[index];
+        index -= sensors_;
+        return index < actuators_ ? in.actuatorCommands[index]
+                                  : in.actuatorFeedback[index - actuators_];
+    }
+
+    size_t healthyBytes() const { return (sensors_ + 7) / 8; }
+    size_t ecuBytes() const { return (ecus_ + 1) / 2; }
+
+    void packHealthy(const TelemetryInput& in, uint8_t* p) const {
+        std::memset(p, 0, healthyBytes());
+        for (size_t i = 0; i < sensors_; i++) {
+            if (in.sensorHealthy[i]) p[i / 8] |= static_cast<uint8_t>(1u << (i % 8));
+        }
+    }
+
+    void packEcus(const TelemetryInput& in, uint8_t* p) const {
+        std::memset(p, 0, ecuBytes());
+        for (size_t i = 0; i < ecus_; i++) {
+            p[i / 2] |= static_cast<uint8_t>((in.ecuStatus[i] & 0x0F) << (4 * (i % 2)));
+        }
+    }
+
+    uint8_t* encodeKeyframe(const TelemetryInput& in, uint8_t* p) {
+        for (size_t i = 0; i < sensors_; i++) {
+            float resolution = static_cast<float>(channels_[i].config.resolution);
+            std::memcpy(p, &resolution, 4);
+            p += 4;
+        }
+        packHealthy(in, p);
+        std::memcpy(sentHealthy_.data(), p, healthyBytes());
+        p += healthyBytes();
+        for (size_t i = 0; i < channels_.size(); i++) {
+            Channel& channel = channels_[i];
+            channel.sent = quantizeCount(channelValue(in, i), channel.config.resolution);
+            channel.sentMs = in.timestampMs;
+            p += putVarint(p, channel.sent);
+        }
+        packEcus(in, p);
+        std::memcpy(sentEcus_.data(), p, ecuBytes());
+        return p + ecuBytes();
+    }
+
+    uint8_t* encodeDelta(const TelemetryInput& in, uint8_t* p) {
+        uint8_t* sections = p++;
+        *sections = 0;
+        uint8_t* bitmap = p;
+        size_t bitmapBytes = (channels_.size() + 7) / 8;
+        std::memset(bitmap, 0, bitmapBytes);
+        p += bitmapBytes;
+
+        std::array<uint8_t, 32> healthy;
+        packHealthy(in, healthy.data());
+        if (std::memcmp(healthy.data(), sentHealthy_.data(), healthyBytes()) != 0) {
+            *sections |= TELEMETRY_SECTION_HEALTH;
+            std::memcpy(p, healthy.data(), healthyBytes());
+            sentHealthy_ = healthy;
+            p += healthyBytes();
+        }
+        std::array<uint8_t, 128> status;
+        packEcus(in, status.data());
+        if (std::memcmp(status.data(), sentEcus_.data(), ecuBytes()) != 0) {
+            *sections |= TELEMETRY_SECTION_ECUS;
+            std::memcpy(p, status.data(), ecuBytes());
+            sentEcus_ = status;
+            p += ecuBytes();
+        }
+
+        for (size_t i = 0; i < channels_.size(); i++) {
+            Channel& channel = channels_[i];
+            const TelemetryChannelConfig& config = channel.config;
+            if (config.maxRateHz > 0.0 &&
+                in.timestampMs - channel.sentMs < 1000.0 / config.maxRateHz) {
+                continue;
+            }
+            int64_t count = quantizeCount(channelValue(in, i), config.resolution);
+            int64_t difference = count - channel.sent;
+            if (difference == 0 ||
+                std::fabs(static_cast<double>(difference) * config.resolution) < config.deadband) {
+                continue;
+            }
+            bitmap[i / 8] |= static_cast<uint8_t>(1u << (i % 8));
+            p += putVarint(p, difference);
+            channel.sent = count;
+            channel.sentMs = in.timestampMs;
+        }
+        return p;
+    }
+
+public:
+    TelemetryDeltaEncoder()
+        : frameLength_(0), sentHealthy_{}, sentEcus_{}, sensors_(SIZE_MAX), actuators_(0),
+          ecus_(0), sequence_(0), keyframeIntervalMs_(TELEMETRY_KEYFRAME_INTERVAL_MS),
+          lastKeyframeMs_(0), lastFrameMs_(0), keyframeDue_(true), keyframes_(0), deltas_(0), bytes_(0),
+          fullBytes_(0) {}
+
+    // Per-channel settings by snapshot index; takes effect with a keyframe
+    void configureSensor(size_t index, const TelemetryChannelConfig& config) {
+        if (sensorConfig_.size() <= index) sensorConfig_.resize(index + 1, TELEMETRY_SENSOR_DEFAULT);
+        sensorConfig_[index] = config;
+        sensors_ = SIZE_MAX;
+    }
+
+    // Deadband and rate cap for an actuator's command and feedback. Their
+    // resolution is fixed (the keyframe carries sensor resolutions only),
+    // so config.resolution is ignored.
+    void configureActuator(size_t index, const TelemetryChannelConfig& config) {
+        if (actuatorConfig_.size() <= index) {
+            actuatorConfig_.resize(index + 1, TELEMETRY_ACTUATOR_DEFAULT);
+        }
+        actuatorConfig_[index] = {TELEMETRY_ACTUATOR_DEFAULT.resolution, config.deadband,
+                                  config.maxRateHz};
+        sensors_ = SIZE_MAX;
+    }
+
+    void setKeyframeInterval(uint32_t intervalMs) { keyframeIntervalMs_ = intervalMs; }
+
+    // Next frame is a keyframe (a receiver lost a frame and asked for one)
+    void requestKeyframe() { keyframeDue_ = true; }
+
+    std::span<const uint8_t> encode(const TelemetryInput& in) {
+        size_t sensors = std::min<size_t>(in.sensorCount, 255);
+        size_t actuators = std::min<size_t>(in.actuatorCount, 255);
+        size_t ecus = std::min<size_t>(in.ecuCount, 255);
+        if (sensors != sensors_ || actuators != actuators_ || ecus != ecus_) {
+            reshape(sensors, actuators, ecus);
+        }
+        bool keyframe = keyframeDue_ || in.timestampMs - lastKeyframeMs_ >= keyframeIntervalMs_;
+
+        uint8_t* p = buffer_.data();
+        putU16(p, TELEMETRY_DELTA_MAGIC);
+        p[2] = TELEMETRY_DELTA_VERSION;
+        p[3] = keyframe ? TELEMETRY_KEYFRAME : TELEMETRY_DELTA;
+        p[4] = in.flags;
+        if (keyframe) {
+            putU32(p + 5, sequence_);
+            putU32(p + 9, in.timestampMs);
+            p[13] = static_cast<uint8_t>(sensors);
+            p[14] = static_cast<uint8_t>(actuators);
+            p[15] = static_cast<uint8_t>(ecus);
+            p += TELEMETRY_KEYFRAME_HEADER_SIZE;
+        } else {
+            p[5] = static_cast<uint8_t>(sequence_);
+            p += 6;
+            p += putVarint(p, static_cast<int64_t>(in.timestampMs - lastFrameMs_));
+        }
+        sequence_++;
+        lastFrameMs_ = in.timestampMs;
+
+        if (keyframe) {
+            p = encodeKeyframe(in, p);
+            lastKeyframeMs_ = in.timestampMs;
+            keyframeDue_ = false;
+            keyframes_++;
+        } else {
+            p = encodeDelta(in, p);
+            deltas_++;
+        }
+
+        size_t crcOffset = static_cast<size_t>(p - buffer_.data());
+        putU16(p, crc16Ccitt(buffer_.data(), crcOffset));
+        frameLength_ = crcOffset + TELEMETRY_CRC_SIZE;
+        bytes_ += frameLength_;
+        fullBytes_ += telemetryFrameSize(sensors, actuators, ecus);
+        return getFrame();
+    }
+
+    std::span<const uint8_t> getFrame() const {
+        return std::span<const uint8_t>(buffer_.data(), frameLength_);
+    }
+
+    uint32_t getSequence() const { return sequence_; }
+    uint64_t getKeyframeCount() const { return keyframes_; }
+    uint64_t getDeltaCount() const { return deltas_; }
+    uint64_t getBytes() const { return bytes_; }
+    uint64_t getFullFrameBytes() const { return fullBytes_; }
+
+    std::string getStatus() const {
+        std::string ratio = std::to_string(bytes_ ? static_cast<double>(fullBytes_) / bytes_ : 0.0);
+        return "Telemetry downlink: " + std::to_string(keyframes_) + " keyframes, " +
+               std::to_string(deltas_) + " deltas, " + std::to_string(bytes_) + " bytes (" +
+               ratio.substr(0, ratio.find('.') + 2) + "x smaller than full frames)";
+    }
+};
+
+// Surface side: rebuilds the full state from keyframes and deltas
+class TelemetryDeltaDecoder {
+private:
+    std::vector<double> resolutions_;
+    std::vector<int64_t> counts_;           // Sensors, then commands, then feedbacks
+    TelemetryFrame state_;
+    size_t sensors_;
+    size_t actuators_;
+    size_t ecus_;
+    uint32_t lastSequence_;
+    bool synced_;                           // Holding a keyframe and every delta since
+    uint64_t lostFrames_;
+
+public:
+    TelemetryDeltaDecoder()
+        : state_{}, sensors_(0), actuators_(0), ecus_(0), lastSequence_(0), synced_(false),
+          lostFrames_(0) {}
+
+    // False on a bad frame, or a delta that does not follow the frame
+    // before it (the state is then stale until the next keyframe)
+    bool decode(const uint8_t* data, size_t length) {
+        if (length < 6 + TELEMETRY_CRC_SIZE || getU16(data) != TELEMETRY_DELTA_MAGIC ||
+            data[2] != TELEMETRY_DELTA_VERSION ||
+            getU16(data + length - TELEMETRY_CRC_SIZE) !=
+                crc16Ccitt(data, length - TELEMETRY_CRC_SIZE)) {
+            return false;
+        }
+        uint8_t type = data[3];
+        const uint8_t* end = data + length - TELEMETRY_CRC_SIZE;
+        const uint8_t* p;
+        uint32_t sequence;
+        uint32_t timestampMs;
+        if (type == TELEMETRY_KEYFRAME) {
+            if (length < TELEMETRY_KEYFRAME_HEADER_SIZE + TELEMETRY_CRC_SIZE) return false;
+            sequence = getU32(data + 5);
+            timestampMs = getU32(data + 9);
+            sensors_ = data[13];
+            actuators_ = data[14];
+            ecus_ = data[15];
+            p = data + TELEMETRY_KEYFRAME_HEADER_SIZE;
+        } else if (type == TELEMETRY_DELTA) {
+            sequence = (lastSequence_ & ~0xFFu) | data[5];
+            if (sequence <= lastSequence_) sequence += 0x100;
+            int64_t elapsedMs = 0;
+            size_t n = getVarint(data + 6, end, elapsedMs);
+            if (n == 0) return false;
+            timestampMs = state_.timestampMs + static_cast<uint32_t>(elapsedMs);
+            p = data + 6 + n;
+        } else {
+            return false;
+        }
+        size_t sensors = sensors_;
+        size_t actuators = actuators_;
+        size_t ecus = ecus_;
+        size_t channels = sensors + 2 * actuators;
+        size_t healthyBytes = (sensors + 7) / 8;
+        size_t ecuBytes = (ecus + 1) / 2;
+
+        if (synced_ && sequence != lastSequence_ + 1) {
+            lostFrames_ += sequence - lastSequence_ - 1;
+            synced_ = false;
+        }
+        lastSequence_ = sequence;
+
+        auto readHealthy = [&](const uint8_t* from) {
+            state_.sensorHealthy.resize(sensors);
+            for (size_t i = 0; i < sensors; i++) state_.sensorHealthy[i] = (from[i / 8] >> (i % 8)) & 1;
+        };
+        auto readEcus = [&](const uint8_t* from) {
+            state_.ecuStatus.resize(ecus);
+            for (size_t i = 0; i < ecus; i++) state_.ecuStatus[i] = (from[i / 2] >> (4 * (i % 2))) & 0x0F;
+        };
+
+        if (type == TELEMETRY_KEYFRAME) {
+            if (end - p < static_cast<ptrdiff_t>(4 * sensors)) return false;
+            resolutions_.assign(channels, 1.0 / TELEMETRY_ACTUATOR_SCALE);
+            for (size_t i = 0; i < sensors; i++) {
+                float resolution;
+                std::memcpy(&resolution, p, 4);
+                resolutions_[i] = resolution;
+                p += 4;
+            }
+            if (end - p < static_cast<ptrdiff_t>(healthyBytes)) return false;
+            readHealthy(p);
+            p += healthyBytes;
+            counts_.assign(channels, 0);
+            for (size_t i = 0; i < channels; i++) {
+                size_t n = getVarint(p, end, counts_[i]);
+                if (n == 0) return false;
+                p += n;
+            }
+            if (end - p != static_cast<ptrdiff_t>(ecuBytes)) return false;
+            readEcus(p);
+            synced_ = true;
+        } else {
+            if (!synced_ || counts_.size() != channels) {
+                synced_ = false;
+                return false;
+            }
+            size_t bitmapBytes = (channels + 7) / 8;
+            if (end - p < static_cast<ptrdiff_t>(1 + bitmapBytes)) return false;
+            uint8_t sections = *p++;
+            const uint8_t* bitmap = p;
+            p += bitmapBytes;
+            if (sections & TELEMETRY_SECTION_HEALTH) {
+                if (end - p < static_cast<ptrdiff_t>(healthyBytes)) return false;
+                readHealthy(p);
+                p += healthyBytes;
+            }
+            if (sections & TELEMETRY_SECTION_ECUS) {
+                if (end - p < static_cast<ptrdiff_t>(ecuBytes)) return false;
+                readEcus(p);
+                p += ecuBytes;
+            }
+            for (size_t i = 0; i < channels; i++) {
+                if (!(bitmap[i / 8] & (1u << (i % 8)))) continue;
+                int64_t difference;
+                size_t n = getVarint(p, end, difference);
+                if (n == 0) {
+                    synced_ = false;
+                    return false;
+                }
+                counts_[i] += difference;
+                p += n;
+            }
+        }
+
+        state_.version = data[2];
+        state_.flags = data[4];
+        state_.sequence = sequence;
+        state_.timestampMs = timestampMs;
+        state_.sensorValues.resize(sensors);
+        for (size_t i = 0; i < sensors; i++) {
+            state_.sensorValues[i] = static_cast<float>(counts_[i] * resolutions_[i]);
+        }
+        state_.actuatorCommands.resize(actuators);
+        state_.actuatorFeedback.resize(actuators);
+        for (size_t i = 0; i < actuators; i++) {
+            state_.actuatorCommands[i] = counts_[sensors + i] * resolutions_[sensors + i];
+            state_.actuatorFeedback[i] =
+                counts_[sensors + actuators + i] * resolutions_[sensors + actuators + i];
+        }
+        return true;
+    }
+
+    // Reconstructed state as of the last decoded frame
+    const TelemetryFrame& getState() const { return state_; }
+    bool isSynced() const { return synced_; }
+    uint64_t getLostFrames() const { return lostFrames_; }
+};
+
+#endif // TELEMETRY_DELTA_HPP
@@ -0,0 +1,322 @@
+// TelemetryRecorder
+#ifndef TELEMETRY_RECORDER_HPP
+#define TELEMETRY_RECORDER_HPP
+
+#include "base.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+
+// One sample on one channel. Fixed width so segments can be indexed directly.
+struct TelemetryRecord {
+    int64_t timestampNs;          // CLOCK_MONOTONIC
+    uint32_t channelId;
+    uint32_t reserved;
+    double value;
+};
+static_assert(sizeof(TelemetryRecord) == 24, "TelemetryRecord layout changed");
+
+// Segment file layout: header page(s), then packed TelemetryRecords
+struct TelemetrySegmentHeader {
+    static constexpr size_t MAX_CHANNELS = 128;
+    static constexpr size_t CHANNEL_NAME_SIZE = 32;
+    static constexpr uint32_t VERSION = 1;
+
+    char magic[8];                // "TBMREC01"
+    uint32_t version;
+    uint32_t headerSize;          // Offset of the first record
+    uint32_t recordSize;
+    uint32_t segmentIndex;
+    uint64_t recordCount;         // Valid records in this segment
+    int64_t startMonotonicNs;     // Monotonic/wall pair to convert timestamps
+    int64_t startWallTimeNs;
+    uint32_t channelCount;
+    uint32_t reserved;
+    char channelNames[MAX_CHANNELS][CHANNEL_NAME_SIZE];
+};
+
+constexpr uint32_t TELEMETRY_HEADER_SIZE = 8192;
+// Returned by registerChannel() once the header's channel table is full
+constexpr uint32_t INVALID_TELEMETRY_CHANNEL = UINT32_MAX;
+static_assert(sizeof(TelemetrySegmentHeader) <= TELEMETRY_HEADER_SIZE,
+              "TelemetrySegmentHeader does not fit in its reserved space");
+
+// Binary channel recorder writing into preallocated mmap'd segment files.
+// record() is a bounds check and a 24-byte store; no formatting and no
+// syscalls except when a segment fills and the recorder rotates.
+class TelemetryRecorder : public ISystemComponent {
+private:
+    std::string basePath_;
+    size_t segmentBytes_;
+    uint32_t segmentIndex_;
+
+    int fd_;
+    uint8_t* mapping_;
+    TelemetrySegmentHeader* header_;
+    TelemetryRecord* records_;
+    uint64_t capacity_;           // Records per segment
+    uint64_t count_;              // Records in the current segment
+
+    char channelNames_[TelemetrySegmentHeader::MAX_CHANNELS]
+                      [TelemetrySegmentHeader::CHANNEL_NAME_SIZE];
+    uint32_t channelCount_;
+
+    uint64_t totalRecords_;
+    uint64_t failedRecords_;
+    uint64_t droppedRecords_;     // Records on unregistered channel IDs
+    bool recording_;
+
+public:
+    TelemetryRecorder(const std::string& basePath,
+                      size_t segmentBytes = 64 * 1024 * 1024)
+        : basePath_(basePath), segmentBytes_(segmentBytes), segmentIndex_(0),
+          fd_(-1), mapping_(nullptr), header_(nullptr), records_(nullptr),
+          capacity_(0), count_(0), channelCount_(0),
+          totalRecords_(0), failedRecords_(0), droppedRecords_(0), recording_(false) {
+        std::memset(channelNames_, 0, sizeof(channelNames_));
+    }
+
+    ~TelemetryRecorder() {
+        closeSegment();
+    }
+
+    bool initialize() override {
+        recording_ = openSegment();
+        return recording_;
+    }
+
+    bool update() override { return recording_; }
+
+    bool shutdown() override {
+        closeSegment();
+        recording_ = false;
+        return true;
+    }
+
+    // Register a channel name; returns its ID, or INVALID_TELEMETRY_CHANNEL
+    // when the table is full. Channels registered after initialize() appear
+    // in the current and all later segment headers.
+    uint32_t registerChannel(const std::string& name) {
+        if (channelCount_ >= TelemetrySegmentHeader::MAX_CHANNELS) {
+            return INVALID_TELEMETRY_CHANNEL;
+        }
+        uint32_t id = channelCount_++;
+        std::strncpy(channelNames_[id], name.c_str(),
+                     TelemetrySegmentHeader::CHANNEL_NAME_SIZE - 1);
+        if (header_) {
+            std::memcpy(header_->channelNames[id], channelNames_[id],
+                        TelemetrySegmentHeader::CHANNEL_NAME_SIZE);
+            header_->channelCount = channelCount_;
+        }
+        return id;
+    }
+
+    void record(uint32_t channelId, double value, int64_t timestampNs) {
+        if (!recording_) return;
+        if (channelId >= channelCount_) {
+            droppedRecords_++;
+            return;
+        }
+        if (count_ >= capacity_ && !rotate()) {
+            failedRecords_++;
+            return;
+        }
+        TelemetryRecord& rec = records_[count_++];
+        rec.timestampNs = timestampNs;
+        rec.channelId = channelId;
+        rec.reserved = 0;
+        rec.value = value;
+        header_->recordCount = count_;
+        totalRecords_++;
+    }
+
+    uint64_t getTotalRecords() const { return totalRecords_; }
+    uint64_t getFailedRecords() const { return failedRecords_; }
+    uint64_t getDroppedRecords() const { return droppedRecords_; }
+    uint32_t getSegmentIndex() const { return segmentIndex_; }
+
+    std::string getStatus() const override {
+        if (!recording_) return "Telemetry recorder: not recording";
+        return "Telemetry recorder: segment " + std::to_string(segmentIndex_) +
+               ", " + std::to_string(channelCount_) + " channels, " +
+               std::to_string(totalRecords_) + " records" +
+               (failedRecords_ ? ", " + std::to_string(failedRecords_) + " failed" : "") +
+               (droppedRecords_ ? ", " + std::to_string(droppedRecords_) + " dropped" : "");
+    }
+
+    std::string getComponentName() const override { return "TelemetryRecorder"; }
+
+private:
+    std::string segmentPath(uint32_t index) const {
+        char suffix[16];
+        snprintf(suffix, sizeof(suffix), "_%04u.tlm", index);
+        return basePath_ + suffix;
+    }
+
+    bool openSegment() {
+        std::string path = segmentPath(segmentIndex_);
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd_ < 0) return false;
+
+        // Reserve the blocks up front so writes never extend the file
+        if (posix_fallocate(fd_, 0, static_cast<off_t>(segmentBytes_)) != 0 &&
+            ftruncate(fd_, static_cast<off_t>(segmentBytes_)) != 0) {
+            ::close(fd_);
+            fd_ = -1;
+            return false;
+        }
+
+        void* mem = mmap(nullptr, segmentBytes_, PROT_READ | PROT_WRITE,
+                         MAP_SHARED, fd_, 0);
+        if (mem == MAP_FAILED) {
+            ::close(fd_);
+            fd_ = -1;
+            return false;
+        }
+
+        mapping_ = static_cast<uint8_t*>(mem);
+        header_ = reinterpret_cast<TelemetrySegmentHeader*>(mapping_);
+        records_ = reinterpret_cast<TelemetryRecord*>(mapping_ + TELEMETRY_HEADER_SIZE);
+        capacity_ = (segmentBytes_ - TELEMETRY_HEADER_SIZE) / sizeof(TelemetryRecord);
+        count_ = 0;
+
+        std::memset(header_, 0, TELEMETRY_HEADER_SIZE);
+        std::memcpy(header_->magic, "TBMREC01", 8);
+        header_->version = TelemetrySegmentHeader::VERSION;
+        header_->headerSize = TELEMETRY_HEADER_SIZE;
+        header_->recordSize = sizeof(TelemetryRecord);
+        header_->segmentIndex = segmentIndex_;
+        header_->recordCount = 0;
+
+        timespec mono, wall;
+        clock_gettime(CLOCK_MONOTONIC, &mono);
+        clock_gettime(CLOCK_REALTIME, &wall);
+        header_->startMonotonicNs = mono.tv_sec * 1000000000LL + mono.tv_nsec;
+        header_->startWallTimeNs = wall.tv_sec * 1000000000LL + wall.tv_nsec;
+
+        header_->channelCount = channelCount_;
+        std::memcpy(header_->channelNames, channelNames_, sizeof(channelNames_));
+        return true;
+    }
+
+    void closeSegment() {
+        if (mapping_) {
+            msync(mapping_, TELEMETRY_HEADER_SIZE + count_ * sizeof(TelemetryRecord),
+                  MS_ASYNC);
+            munmap(mapping_, segmentBytes_);
+            mapping_ = nullptr;
+            header_ = nullptr;
+            records_ = nullptr;
+        }
+        if (fd_ >= 0) {
+            // Trim the unused preallocated tail (readers rely on recordCount,
+            // so a failure here only wastes disk space)
+            int trimmed = ftruncate(fd_, static_cast<off_t>(
+                TELEMETRY_HEADER_SIZE + count_ * sizeof(TelemetryRecord)));
+            (void)trimmed;
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    bool rotate() {
+        closeSegment();
+        segmentIndex_++;
+        recording_ = openSegment();
+        return recording_;
+    }
+};
+
+// Read-only view of one segment file (used by export/replay tools)
+class TelemetrySegmentReader {
+private:
+    int fd_;
+    size_t size_;
+    const uint8_t* mapping_;
+
+public:
+    TelemetrySegmentReader() : fd_(-1), size_(0), mapping_(nullptr) {}
+
+    ~TelemetrySegmentReader() {
+        close();
+    }
+
+    bool open(const std::string& path) {
+        close();
+        fd_ = ::open(path.c_str(), O_RDONLY);
+        if (fd_ < 0) return false;
+
+        struct stat st;
+        if (fstat(fd_, &st) != 0 || st.st_size < static_cast<off_t>(TELEMETRY_HEADER_SIZE)) {
+            close();
+            return false;
+        }
+        size_ = static_cast<size_t>(st.st_size);
+
+        void* mem = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+        if (mem == MAP_FAILED) {
+            mapping_ = nullptr;
+            close();
+            return false;
+        }
+        mapping_ = static_cast<const uint8_t*>(mem);
+
+        // Everything after this indexes by the header's own fields, so a
+        // truncated or corrupt header must not get past here
+        const TelemetrySegmentHeader& h = header();
+        if (std::memcmp(h.magic, "TBMREC01", 8) != 0 ||
+            h.recordSize != sizeof(TelemetryRecord) ||
+            h.headerSize < sizeof(TelemetrySegmentHeader) ||
+            h.headerSize > size_ ||
+            h.channelCount > TelemetrySegmentHeader::MAX_CHANNELS) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        if (mapping_) munmap(const_cast<uint8_t*>(mapping_), size_);
+        if (fd_ >= 0) ::close(fd_);
+        mapping_ = nullptr;
+        fd_ = -1;
+        size_ = 0;
+    }
+
+    const TelemetrySegmentHeader& header() const {
+        return *reinterpret_cast<const TelemetrySegmentHeader*>(mapping_);
+    }
+
+    uint64_t getRecordCount() const {
+        uint64_t available = (size_ - header().headerSize) / sizeof(TelemetryRecord);
+        return std::min<uint64_t>(header().recordCount, available);
+    }
+
+    const TelemetryRecord& getRecord(uint64_t index) const {
+        return reinterpret_cast<const TelemetryRecord*>(
+            mapping_ + header().headerSize)[index];
+    }
+
+    std::string getChannelName(uint32_t channelId) const {
+        if (channelId >= header().channelCount) {
+            return "ch" + std::to_string(channelId);
+        }
+        return std::string(header().channelNames[channelId],
+                           strnlen(header().channelNames[channelId],
+                                   TelemetrySegmentHeader::CHANNEL_NAME_SIZE));
+    }
+
+    // Convert a record timestamp to wall-clock nanoseconds
+    int64_t toWallTimeNs(int64_t timestampNs) const {
+        return header().startWallTimeNs + (timestampNs - header().startMonotonicNs);
+    }
+};
+
+#endif // TELEMETRY_RECORDER_HPP
@@ -0,0 +1,168 @@
+// TimeSync
+#ifndef TIME_SYNC_HPP
+#define TIME_SYNC_HPP
+
+#include "status_format.hpp"
+#include "teensy_protocol.hpp"
+#include <array>
+#include <cmath>
+#include <string>
+
+// Maps a Teensy node's micros() onto the Pi's monotonic clock from
+// TIME_PING / TIME_PONG exchanges. Each exchange has the four NTP
+// timestamps: ping sent and pong received on the Pi, ping received and
+// pong sent on the node. The round trip less the node's turnaround is
+// the transport delay; on a symmetric link the midpoint of the node's
+// two stamps lines up with the midpoint of the Pi's. The last WINDOW
+// exchanges are kept, and only those close to the fastest round trip go
+// into a least-squares line, so the offset and the crystal drift come
+// from exchanges that USB or scheduling delays did not stretch.
+// Control thread only.
+class NodeClockSync {
+private:
+    static constexpr size_t WINDOW = 64;                // 32 s of exchanges at 2 Hz
+    static constexpr size_t MIN_EXCHANGES = 4;          // Before samples are mapped
+    static constexpr int64_t MAX_RTT_NS = 20000000LL;   // Slower replies are discarded
+    static constexpr int64_t RTT_MARGIN_NS = 100000LL;  // Above the fastest, still fitted
+    static constexpr double MIN_DRIFT_SPAN_NS = 2e9;    // Drift only from >= 2 s of exchanges
+    static constexpr double MAX_DRIFT_PPM = 500.0;
+
+    struct Exchange {
+        int64_t deviceNs;   // Node midpoint, unwrapped micros() in ns
+        int64_t piNs;       // Pi midpoint
+        int64_t rttNs;
+    };
+
+    std::array<Exchange, WINDOW> window_;
+    size_t count_;
+    size_t next_;
+    uint8_t sequence_;
+
+    // Fit: piNs = baseNs_ + rate_ * (deviceNs - baseDeviceNs_)
+    int64_t baseDeviceNs_;
+    int64_t baseNs_;
+    double rate_;
+    bool synced_;
+
+    int64_t referenceUs_;   // Unwrapped micros() of the last exchange
+    bool referenced_;
+    int64_t lastRttNs_;
+    int64_t minRttNs_;
+    uint64_t pings_;
+    uint64_t pongs_;
+    uint64_t rejected_;
+
+    // micros() wraps every 71 minutes; readings within 35 minutes of the
+    // last exchange unwrap correctly
+    int64_t unwrapUs(uint32_t deviceUs) const {
+        if (!referenced_) return deviceUs;
+        return referenceUs_ + static_cast<int32_t>(deviceUs - static_cast<uint32_t>(referenceUs_));
+    }
+
+    void fit() {
+        minRttNs_ = INT64_MAX;
+        for (size_t i = 0; i < count_; i++) minRttNs_ = std::min(minRttNs_, window_[i].rttNs);
+        int64_t limit = minRttNs_ + RTT_MARGIN_NS;
+
+        // Relative to the newest exchange so the sums stay small
+        const Exchange& newest = window_[(next_ + WINDOW - 1) % WINDOW];
+        double n = 0, sx = 0, sy = 0, sxx = 0, sxy = 0;
+        double minX = 0, maxX = 0;
+        for (size_t i = 0; i < count_; i++) {
+            if (window_[i].rttNs > limit) continue;
+            double x = static_cast<double>(window_[i].deviceNs - newest.deviceNs);
+            double y = static_cast<double>(window_[i].piNs - newest.piNs);
+            minX = n > 0 ? std::min(minX, x) : x;
+            maxX = n > 0 ? std::max(maxX, x) : x;
+            n++;
+            sx += x;
+            sy += y;
+            sxx += x * x;
+            sxy += x * y;
+        }
+        double meanX = sx / n;
+        double meanY = sy / n;
+        double rate = 1.0;
+        double varX = sxx - sx * meanX;
+        if (n >= 2 && maxX - minX >= MIN_DRIFT_SPAN_NS && varX > 0) {
+            rate = (sxy - sx * meanY) / varX;
+            rate = std::clamp(rate, 1.0 - MAX_DRIFT_PPM * 1e-6, 1.0 + MAX_DRIFT_PPM * 1e-6);
+        }
+        // The line goes through the mean of the fitted exchanges
+        baseDeviceNs_ = newest.deviceNs + std::llround(meanX);
+        baseNs_ = newest.piNs + std::llround(meanY);
+        rate_ = rate;
+        synced_ = pongs_ >= MIN_EXCHANGES;
+    }
+
+public:
+    NodeClockSync()
+        : window_{}, count_(0), next_(0), sequence_(0), baseDeviceNs_(0), baseNs_(0),
+          rate_(1.0), synced_(false), referenceUs_(0), referenced_(false), lastRttNs_(0),
+          minRttNs_(0), pings_(0), pongs_(0), rejected_(0) {}
+
+    // Next TIME_PING into out (TIME_PING_PACKET_SIZE bytes); returns its length
+    size_t makePing(int64_t nowNs, uint8_t* out) {
+        pings_++;
+        return encodeTimePing(sequence_++, nowNs, out);
+    }
+
+    // A TIME_PONG from the node, received at receiveNs. False if the
+    // exchange was discarded.
+    bool handlePong(const TimePong& pong, int64_t receiveNs) {
+        int64_t receiveUs = unwrapUs(pong.receiveUs);
+        int64_t turnaroundNs = static_cast<int64_t>(
+            static_cast<int32_t>(pong.transmitUs - pong.receiveUs)) * 1000;
+        int64_t rttNs = (receiveNs - pong.pingNs) - turnaroundNs;
+        if (pong.pingNs <= 0 || turnaroundNs < 0 || rttNs < 0 || rttNs > MAX_RTT_NS) {
+            rejected_++;
+            return false;
+        }
+
+        window_[next_] = {receiveUs * 1000 + turnaroundNs / 2,
+                          pong.pingNs + (receiveNs - pong.pingNs) / 2, rttNs};
+        next_ = (next_ + 1) % WINDOW;
+        count_ = std::min(count_ + 1, WINDOW);
+        referenceUs_ = receiveUs;
+        referenced_ = true;
+        lastRttNs_ = rttNs;
+        pongs_++;
+        fit();
+        return true;
+    }
+
+    // Pi monotonic time of a node micros() reading (0 until synced)
+    int64_t toPiNs(uint32_t deviceUs) const {
+        if (!synced_) return 0;
+        int64_t deviceNs = unwrapUs(deviceUs) * 1000;
+        return baseNs_ + std::llround(rate_ * static_cast<double>(deviceNs - baseDeviceNs_));
+    }
+
+    bool isSynced() const { return synced_; }
+    // Pi time minus node time at the fit's reference point
+    int64_t getOffsetNs() const { return baseNs_ - baseDeviceNs_; }
+    // Node crystal error against the Pi (positive: the node runs fast)
+    double getDriftPpm() const { return (1.0 / rate_ - 1.0) * 1e6; }
+    int64_t getLastRttNs() const { return lastRttNs_; }
+    int64_t getMinRttNs() const { return count_ > 0 ? minRttNs_ : 0; }
+    uint64_t getPingCount() const { return pings_; }
+    uint64_t getPongCount() const { return pongs_; }
+    uint64_t getRejectedCount() const { return rejected_; }
+
+    std::string getStatus() const {
+        char text[STATUS_TEXT_SIZE];
+        StatusWriter out(text, sizeof(text));
+        if (synced_) {
+            out.text("synced, offset ").fixed(getOffsetNs() / 1e6, 3).text(" ms, drift ")
+               .fixed(getDriftPpm(), 1).text(" ppm, rtt ").number(lastRttNs_ / 1000)
+               .text(" us (min ").number(getMinRttNs() / 1000).text(")");
+        } else {
+            out.text("not synced");
+        }
+        out.text(", ").number(pongs_).text("/").number(pings_).text(" pongs, ")
+           .number(rejected_).text(" rejected");
+        return std::string(out.view());
+    }
+};
+
+#endif // TIME_SYNC_HPP
@@ -0,0 +1,298 @@
+// Topology
+#ifndef TOPOLOGY_HPP
+#define TOPOLOGY_HPP
+
+#include "ecu.hpp"
+#include <span>
+#include <string_view>
+
+// Each tool's ECU layout as constant tables: the ECUs, where they sit,
+// how they are reached, their poll rates, the devices on their channels
+// and which actuator drives which node channel. ECUManager::loadTopology()
+// builds the ECUs in table order, so an ECU's handle is its row and every
+// name in a table resolves to an index at compile time (topologyHandle,
+// deviceChannel). The tool is picked at startup (findTopology); the
+// control logic is the same for every table.
+
+struct DeviceSpec {
+    std::string_view name;
+    std::string_view type;
+    std::string_view interface;     // "N/A" for software on the main controller
+    int channel;                    // Per interface
+};
+
+struct ECULocationSpec {
+    std::string_view compartment;
+    std::string_view mounting;
+    double x, y, z;                 // Meters from the reference point
+};
+
+struct CommunicationSpec {
+    std::string_view protocol;
+    std::string_view address;
+    int baudRate;
+    int modbusAddress;
+    double updateRateHz;            // Health poll rate group
+};
+
+struct ECUSpec {
+    std::string_view id;
+    std::string_view name;
+    ECUType type;
+    ECULocationSpec location;
+    CommunicationSpec comm;
+    int link;                       // Comm interface the node's packets arrive on (-1 = none)
+    std::span<const DeviceSpec> devices;
+};
+
+// An actuator driven from a node channel: the actuator's component name
+// and the ECU device whose channel it is
+struct OutputSpec {
+    std::string_view actuator;
+    std::string_view ecu;
+    std::string_view device;
+};
+
+struct Topology {
+    std::string_view name;          // Tool configuration, e.g. "digem-pi5"
+    std::string_view systemName;
+    std::span<const ECUSpec> ecus;
+    std::span<const OutputSpec> outputs;
+    std::string_view gpioChip;      // Character device for the main controller's GPIO lines
+};
+
+// Row of an ECU, which is its ECUHandle once loaded
+constexpr ECUHandle topologyHandle(const Topology& topology, std::string_view id) {
+    for (size_t i = 0; i < topology.ecus.size(); i++) {
+        if (topology.ecus[i].id == id) return static_cast<ECUHandle>(i);
+    }
+    return INVALID_ECU_HANDLE;
+}
+
+// Channel of a device on an ECU (-1 = not in the table)
+constexpr int deviceChannel(const Topology& topology, std::string_view ecuId,
+                            std::string_view device) {
+    ECUHandle handle = topologyHandle(topology, ecuId);
+    if (handle == INVALID_ECU_HANDLE) return -1;
+    for (const DeviceSpec& spec : topology.ecus[handle].devices) {
+        if (spec.name == device) return spec.channel;
+    }
+    return -1;
+}
+
+// ECU on a comm interface (INVALID_ECU_HANDLE = none)
+constexpr ECUHandle linkHandle(const Topology& topology, int link) {
+    for (size_t i = 0; i < topology.ecus.size(); i++) {
+        if (topology.ecus[i].link == link) return static_cast<ECUHandle>(i);
+    }
+    return INVALID_ECU_HANDLE;
+}
+
+// Node links are comm interfaces 0..count-1
+constexpr int linkCount(const Topology& topology) {
+    int count = 0;
+    while (linkHandle(topology, count) != INVALID_ECU_HANDLE) count++;
+    return count;
+}
+
+// Table row of an ECU (nullptr = not in the table)
+constexpr const ECUSpec* findECU(const Topology& topology, std::string_view id) {
+    ECUHandle handle = topologyHandle(topology, id);
+    return handle != INVALID_ECU_HANDLE ? &topology.ecus[handle] : nullptr;
+}
+
+// Unique ECU IDs and links numbered from 0 without gaps, no two devices
+// of an ECU on the same interface channel, and every output on a device
+// of a linked ECU, one actuator per channel
+constexpr bool validTopology(const Topology& topology) {
+    const auto& ecus = topology.ecus;
+    int links = 0;
+    for (size_t i = 0; i < ecus.size(); i++) {
+        if (ecus[i].id.empty() || ecus[i].link < -1) return false;
+        if (ecus[i].link >= 0) links++;
+        for (size_t j = i + 1; j < ecus.size(); j++) {
+            if (ecus[i].id == ecus[j].id) return false;
+            if (ecus[i].link >= 0 && ecus[i].link == ecus[j].link) return false;
+        }
+        const auto& devices = ecus[i].devices;
+        for (size_t a = 0; a < devices.size(); a++) {
+            if (devices[a].interface == "N/A") continue;
+            for (size_t b = a + 1; b < devices.size(); b++) {
+                if (devices[a].interface == devices[b].interface &&
+                    devices[a].channel == devices[b].channel) {
+                    return false;
+                }
+            }
+        }
+    }
+    if (linkCount(topology) != links) return false;
+
+    const auto& outputs = topology.outputs;
+    for (size_t i = 0; i < outputs.size(); i++) {
+        const ECUSpec* ecu = findECU(topology, outputs[i].ecu);
+        int channel = deviceChannel(topology, outputs[i].ecu, outputs[i].device);
+        if (!ecu || ecu->link < 0 || channel < 0) return false;
+        for (size_t j = i + 1; j < outputs.size(); j++) {
+            if (outputs[i].actuator == outputs[j].actuator) return false;
+            if (outputs[i].ecu == outputs[j].ecu &&
+                deviceChannel(topology, outputs[j].ecu, outputs[j].device) == channel) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// ===== digem-pi5: tunnel boring machine =====
+
+inline constexpr DeviceSpec DIGEM_PI5_MAIN_DEVICES[] = {
+    {"System Coordinator", "Software", "N/A", 0},
+    {"Safety Monitor", "Software", "N/A", 0},
+    {"Data Logger", "Software", "N/A", 0},
+    {"Control Algorithms (PID)", "Software", "N/A", 0},
+    {"Slurry Flow Sensor (FL-608)", "Sensor", "GPIO", 17},
+};
+
+inline constexpr DeviceSpec DIGEM_PI5_SENSOR_NODE_DEVICES[] = {
+    {"Depth Pressure Sensor (MS5837)", "Sensor", "I2C", 0},
+    {"Water Temperature Sensor", "Sensor", "I2C", 1},
+    {"9-DOF IMU (BNO055)", "Sensor", "I2C", 2},
+    {"Internal Temperature Sensor", "Sensor", "Analog", 0},
+};
+
+inline constexpr DeviceSpec DIGEM_PI5_ACTUATOR_NODE_DEVICES[] = {
+    {"Vertical Thruster 1 (T200)", "Thruster", "PWM", 3},
+    {"Vertical Thruster 2 (T200)", "Thruster", "PWM", 4},
+    {"Horizontal Thruster 1 (T200)", "Thruster", "PWM", 5},
+    {"Horizontal Thruster 2 (T200)", "Thruster", "PWM", 6},
+    {"Gripper Valve", "Hydraulic Valve", "PWM", 7},
+    {"Current Sensors (4x)", "Sensor", "Analog", 0},
+};
+
+inline constexpr DeviceSpec DIGEM_PI5_CUTTER_VFD_DEVICES[] = {
+    {"Cutter Head Motor (15kW)", "3-Phase Motor", "VFD", 0},
+};
+
+inline constexpr DeviceSpec DIGEM_PI5_PUMP_VFD_DEVICES[] = {
+    {"Slurry Pump Motor (22kW)", "3-Phase Motor", "VFD", 0},
+};
+
+inline constexpr DeviceSpec DIGEM_PI5_THRUST_DEVICES[] = {
+    {"Thrust Cylinder 1", "Hydraulic Cylinder", "Proportional Valve", 1},
+    {"Thrust Cylinder 2", "Hydraulic Cylinder", "Proportional Valve", 2},
+    {"Hydraulic Pressure Sensor", "Sensor", "Analog 4-20mA", 1},
+};
+
+inline constexpr DeviceSpec DIGEM_PI5_STEERING_DEVICES[] = {
+    {"Steering Cylinder Left", "Hydraulic Cylinder", "Proportional Valve", 3},
+    {"Steering Cylinder Right", "Hydraulic Cylinder", "Proportional Valve", 4},
+    {"Steering Position Sensor", "Sensor", "Analog 0-10V", 2},
+};
+
+inline constexpr ECUSpec DIGEM_PI5_ECUS[] = {
+    {"ECU01", "Raspberry Pi 4B Main Controller", ECUType::MAIN_CONTROLLER,
+     {"Main Electronics Enclosure", "Standoff Mount", 0.0, 0.0, 0.0},
+     {"Local", "localhost", 0, 0, 1.0}, -1, DIGEM_PI5_MAIN_DEVICES},
+    {"ECU02", "Teensy 4.0 Sensor Node", ECUType::SENSOR_NODE,
+     {"Main Electronics Enclosure", "DIN Rail Mount", 0.15, 0.0, 0.0},
+     {"Serial UART", "/dev/ttyACM0", 115200, 0, 10.0}, 0, DIGEM_PI5_SENSOR_NODE_DEVICES},
+    {"ECU03", "Teensy 4.0 Actuator Node", ECUType::ACTUATOR_NODE,
+     {"Main Electronics Enclosure", "DIN Rail Mount", 0.30, 0.0, 0.0},
+     {"Serial UART", "/dev/ttyACM1", 115200, 0, 10.0}, 1, DIGEM_PI5_ACTUATOR_NODE_DEVICES},
+    {"ECU04", "VFD Cutter Head Motor", ECUType::VFD_CONTROLLER,
+     {"Power Distribution Panel", "Panel Mount", 0.0, 0.25, 0.0},
+     {"Modbus RTU", "192.168.1.50", 9600, 1, 5.0}, -1, DIGEM_PI5_CUTTER_VFD_DEVICES},
+    {"ECU05", "VFD Slurry Pump", ECUType::VFD_CONTROLLER,
+     {"Power Distribution Panel", "Panel Mount", 0.0, 0.50, 0.0},
+     {"Modbus RTU", "192.168.1.51", 9600, 2, 5.0}, -1, DIGEM_PI5_PUMP_VFD_DEVICES},
+    {"ECU06", "Hydraulic Controller - Thrust", ECUType::HYDRAULIC_CONTROLLER,
+     {"Hydraulic Manifold Bay", "Manifold Mount", 0.0, 0.0, 0.15},
+     {"Modbus RTU", "192.168.1.52", 9600, 3, 5.0}, -1, DIGEM_PI5_THRUST_DEVICES},
+    {"ECU07", "Hydraulic Controller - Steering", ECUType::HYDRAULIC_CONTROLLER,
+     {"Hydraulic Manifold Bay", "Manifold Mount", 0.0, 0.0, 0.30},
+     {"Modbus RTU", "192.168.1.53", 9600, 4, 5.0}, -1, DIGEM_PI5_STEERING_DEVICES},
+};
+
+inline constexpr OutputSpec DIGEM_PI5_OUTPUTS[] = {
+    {"VerticalThruster1", "ECU03", "Vertical Thruster 1 (T200)"},
+    {"HorizontalThruster1", "ECU03", "Horizontal Thruster 1 (T200)"},
+    {"GripperValve", "ECU03", "Gripper Valve"},
+};
+
+inline constexpr Topology DIGEM_PI5_TOPOLOGY{"digem-pi5", "TBM ROV Control System",
+                                             DIGEM_PI5_ECUS, DIGEM_PI5_OUTPUTS,
+                                             "/dev/gpiochip0"};
+
+// ===== pi-claw: gripper tool, no cutter, pump or hydraulic controllers =====
+
+inline constexpr DeviceSpec PI_CLAW_MAIN_DEVICES[] = {
+    {"System Coordinator", "Software", "N/A", 0},
+    {"Safety Monitor", "Software", "N/A", 0},
+    {"Data Logger", "Software", "N/A", 0},
+    {"Control Algorithms (PID)", "Software", "N/A", 0},
+    {"Water Flow Sensor (FL-608)", "Sensor", "GPIO", 17},
+};
+
+inline constexpr DeviceSpec PI_CLAW_SENSOR_NODE_DEVICES[] = {
+    {"Orientation IMU (BNO08x)", "Sensor", "I2C", 0},
+};
+
+inline constexpr DeviceSpec PI_CLAW_ACTUATOR_NODE_DEVICES[] = {
+    {"Gripper Valve", "Hydraulic Valve", "PWM", 7},
+    {"Current Sensors (4x)", "Sensor", "Analog", 0},
+};
+
+inline constexpr ECUSpec PI_CLAW_ECUS[] = {
+    {"ECU01", "Raspberry Pi Claw Controller", ECUType::MAIN_CONTROLLER,
+     {"Claw Electronics Box", "Standoff Mount", 0.0, 0.0, 0.0},
+     {"Local", "localhost", 0, 0, 1.0}, -1, PI_CLAW_MAIN_DEVICES},
+    {"ECU02", "Teensy 4.1 Sensor Node", ECUType::SENSOR_NODE,
+     {"Claw Electronics Box", "DIN Rail Mount", 0.10, 0.0, 0.0},
+     {"Serial UART", "/dev/ttyACM0", 115200, 0, 10.0}, 0, PI_CLAW_SENSOR_NODE_DEVICES},
+    {"ECU03", "Teensy 4.1 Actuator Node", ECUType::ACTUATOR_NODE,
+     {"Claw Electronics Box", "DIN Rail Mount", 0.20, 0.0, 0.0},
+     {"Serial UART", "/dev/ttyACM1", 115200, 0, 10.0}, 1, PI_CLAW_ACTUATOR_NODE_DEVICES},
+};
+
+inline constexpr OutputSpec PI_CLAW_OUTPUTS[] = {
+    {"GripperValve", "ECU03", "Gripper Valve"},
+};
+
+inline constexpr Topology PI_CLAW_TOPOLOGY{"pi-claw", "Pi Claw Control System", PI_CLAW_ECUS,
+                                           PI_CLAW_OUTPUTS, "/dev/gpiochip0"};
+
+inline constexpr const Topology* TOPOLOGIES[] = {&DIGEM_PI5_TOPOLOGY, &PI_CLAW_TOPOLOGY};
+
+static_assert(validTopology(DIGEM_PI5_TOPOLOGY));
+static_assert(validTopology(PI_CLAW_TOPOLOGY));
+// Rows src/main.cpp looks up
+static_assert(findECU(DIGEM_PI5_TOPOLOGY, "ECU04") && findECU(DIGEM_PI5_TOPOLOGY, "ECU05"));
+static_assert(deviceChannel(DIGEM_PI5_TOPOLOGY, "ECU01", "Slurry Flow Sensor (FL-608)") == 17);
+static_assert(deviceChannel(PI_CLAW_TOPOLOGY, "ECU01", "Water Flow Sensor (FL-608)") == 17);
+
+// Tool configuration by name (nullptr if unknown)
+inline const Topology* findTopology(std::string_view name) {
+    for (const Topology* topology : TOPOLOGIES) {
+        if (topology->name == name) return topology;
+    }
+    return nullptr;
+}
+
+// Runtime ECU for one table row (state, health and reports live on the ECU)
+inline std::shared_ptr<ECU> createECU(const ECUSpec& spec) {
+    auto ecu = std::make_shared<ECU>(std::string(spec.id), std::string(spec.name), spec.type);
+    ecu->setLocation(ECULocation{std::string(spec.location.compartment),
+                                 std::string(spec.location.mounting),
+                                 spec.location.x, spec.location.y, spec.location.z});
+    ecu->setCommunication(CommunicationInfo{std::string(spec.comm.protocol),
+                                            std::string(spec.comm.address), spec.comm.baudRate,
+                                            spec.comm.modbusAddress, spec.comm.updateRateHz});
+    for (const DeviceSpec& device : spec.devices) {
+        ecu->addControlledDevice(ControlledDevice{std::string(device.name),
+                                                  std::string(device.type),
+                                                  std::string(device.interface), device.channel});
+    }
+    return ecu;
+}
+
+#endif // TOPOLOGY_HPP
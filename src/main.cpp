@@ -3,63 +3,176 @@
 #include <iostream>
 #include <signal.h>
 
-ROVControlSystem* g_system = nullptr;
+TM_ControlSystem* g_system = nullptr;
+volatile sig_atomic_t g_shutdownSignal = 0;
 
+// Only flags the stop: the control loop returns at its next cycle and
+// main() shuts down on its own thread
 void signalHandler(int signum) {
-    std::cout << "\nShutdown signal received...\n";
-    if (g_system) {
-        g_system->stop();
+    g_shutdownSignal = signum;
+    if (g_system) g_system->requestStop();
+}
+
+// Serial links to the Teensy nodes, in link order. A node's link is its
+// comm interface index, so these are added before any other interface.
+void addNodeLinks(TM_ControlSystem& system, const Topology& topology) {
+    for (int link = 0; link < linkCount(topology); link++) {
+        const CommunicationSpec& comm = topology.ecus[linkHandle(topology, link)].comm;
+        system.addCommunication(
+            std::make_shared<SerialInterface>(std::string(comm.address), comm.baudRate));
     }
-    exit(signum);
 }
 
-int main() {
-    // Register signal handler for graceful shutdown
-    signal(SIGINT, signalHandler);
-    signal(SIGTERM, signalHandler);
+// Modbus link to a drive ECU, at the table's address and baud rate. The
+// drive's register polls are its health: the ECU's watchdog runs off
+// their last good reply.
+std::shared_ptr<ModbusInterface> addModbusLink(TM_ControlSystem& system, const ECUSpec& ecu) {
+    auto modbus = std::make_shared<ModbusInterface>(std::string(ecu.comm.address),
+                                                    ecu.comm.baudRate);
+    system.addCommunication(modbus, 5.0);
+    auto unit = static_cast<uint8_t>(ecu.comm.modbusAddress);
+    system.setECUReplySource(std::string(ecu.id), [engine = modbus->getEngine(), unit]() {
+        return engine->getLastReplyNs(unit);
+    });
+    return modbus;
+}
+
+// digem-pi5: depth and heading loops on the thrusters, cutter head and
+// slurry pump VFDs, slurry flow meter
+void configureDigemPi5(TM_ControlSystem& system, const Topology& topology) {
+    // Add sensors
+    auto pressureSensor1 = std::make_shared<PressureSensor>("DepthSensor");
+    auto tempSensor1 = std::make_shared<TemperatureSensor>("WaterTemp");
+    auto imu = std::make_shared<IMUSensor>("IMU");
+    // FL-608 on a main controller GPIO line; without the chip or line
+    // it stays unhealthy and MaxSlurryFlow latches the interlock
+    auto slurryFlow = std::make_shared<FlowSensor>(
+        "SlurryFlow", std::string(topology.gpioChip),
+        deviceChannel(topology, "ECU01", "Slurry Flow Sensor (FL-608)"));
+
+    system.addSensor(pressureSensor1, 100.0);
+    system.addSensor(tempSensor1, 1.0);
+    system.addSensor(imu, 100.0);
+    system.addSensor(slurryFlow, 100.0);
+
+    // Add actuators
+    auto thruster1 = std::make_shared<ThrusterMotor>("VerticalThruster1");
+    auto thruster2 = std::make_shared<ThrusterMotor>("HorizontalThruster1");
+    auto valve1 = std::make_shared<HydraulicValve>("GripperValve");
+
+    system.addActuator(thruster1);
+    system.addActuator(thruster2);
+    system.addActuator(valve1);
+
+    // Add communication interfaces
+    addNodeLinks(system, topology);
+    system.addCommunication(std::make_shared<TelemetryUplink>("192.168.1.100", 5000), 20.0, true);
+    const ECUSpec& cutterECU = *findECU(topology, "ECU04");
+    const ECUSpec& pumpECU = *findECU(topology, "ECU05");
+    auto modbus = addModbusLink(system, cutterECU);
+    auto modbusPump = addModbusLink(system, pumpECU);
+
+    // VFDs on the Modbus links (Delta register map: 0x2001 frequency
+    // command, 0x2103 output frequency, both 0.01 Hz)
+    auto cutterHead = std::make_shared<VFDDrive>("CutterHeadVFD", modbus->getEngine(),
+        VFDRegisterMap{static_cast<uint8_t>(cutterECU.comm.modbusAddress), 0x2001, 0x2103,
+                       ModbusFunction::READ_HOLDING_REGISTERS, 100.0, 100.0});
+    auto slurryPump = std::make_shared<VFDDrive>("SlurryPumpVFD", modbusPump->getEngine(),
+        VFDRegisterMap{static_cast<uint8_t>(pumpECU.comm.modbusAddress), 0x2001, 0x2103,
+                       ModbusFunction::READ_HOLDING_REGISTERS, 100.0, 100.0});
+    system.addActuator(cutterHead, 5.0);
+    system.addActuator(slurryPump, 5.0);
+
+    // Thruster and gripper PWM channels on the actuator Teensy (ECU03)
+    system.addActuatorOutputs(topology.outputs);
+
+    // Closed loops. Starting points that pass tbm_sim's scenario; tune
+    // on the vehicle
+    system.addControlLoop({CONTROL_LOOP_DEPTH, "DepthSensor", -1, "VerticalThruster1",
+                           {30.0, 1.0, 2.0, -100.0, 100.0, 200.0, 10.0}, 100.0, false});
+    system.addControlLoop({CONTROL_LOOP_HEADING, "IMU", IMUSensor::YAW, "HorizontalThruster1",
+                           {3.0, 0.1, 1.5, -100.0, 100.0, 400.0, 10.0}, 100.0, true});
+
+    // Configure safety limits
+    system.addSafetyLimit("MaxDepth", pressureSensor1, 0.0, 100.0); // 0-100 PSI
+    system.addSafetyLimit("MaxTemp", tempSensor1, -5.0, 50.0);      // -5 to 50°C
+    system.addSafetyLimit("MaxSlurryFlow", slurryFlow, 0.0, 30.0);  // FL-608 rated range
+
+    // Downlink resolution, deadband and rate cap per channel (the rest
+    // go out at 0.001 on every change); keyframes resync once a second
+    system.setTelemetryChannel("DepthSensor", {0.001, 0.005, 0.0});
+    system.setTelemetryChannel("WaterTemp", {0.01, 0.05, 1.0});
+    system.setTelemetryChannel("IMU", {0.01, 0.0, 0.0});
+    system.setTelemetryChannel("SlurryFlow", {0.01, 0.1, 10.0});
+}
+
+// pi-claw: gripper valve and water flow meter, orientation from the IMU
+// (no thrusters, so no closed loops)
+void configurePiClaw(TM_ControlSystem& system, const Topology& topology) {
+    auto imu = std::make_shared<IMUSensor>("IMU");
+    auto waterFlow = std::make_shared<FlowSensor>(
+        "WaterFlow", std::string(topology.gpioChip),
+        deviceChannel(topology, "ECU01", "Water Flow Sensor (FL-608)"));
+    system.addSensor(imu, 100.0);
+    system.addSensor(waterFlow, 100.0);
+
+    system.addActuator(std::make_shared<HydraulicValve>("GripperValve"));
+
+    addNodeLinks(system, topology);
+    system.addCommunication(std::make_shared<TelemetryUplink>("192.168.1.100", 5000), 20.0, true);
+
+    // Gripper PWM channel on the actuator Teensy (ECU03)
+    system.addActuatorOutputs(topology.outputs);
+
+    system.addSafetyLimit("MaxWaterFlow", waterFlow, 0.0, 30.0);    // FL-608 rated range
 
+    system.setTelemetryChannel("IMU", {0.01, 0.0, 0.0});
+    system.setTelemetryChannel("WaterFlow", {0.01, 0.1, 10.0});
+}
+
+// Components per tool; addresses, ports and channels come from its table
+struct ToolConfiguration {
+    const Topology* topology;
+    void (*configure)(TM_ControlSystem&, const Topology&);
+};
+
+const ToolConfiguration TOOL_CONFIGURATIONS[] = {
+    {&DIGEM_PI5_TOPOLOGY, configureDigemPi5},
+    {&PI_CLAW_TOPOLOGY, configurePiClaw},
+};
+
+// Configure, initialize and run until stopped
+int run(TM_ControlSystem& system, int argc, char* argv[]) {
     try {
-        // Create control system
-        ROVControlSystem system;
-        g_system = &system;
-
-        // Add sensors
-        auto pressureSensor1 = std::make_shared<PressureSensor>("DepthSensor");
-        auto tempSensor1 = std::make_shared<TemperatureSensor>("WaterTemp");
-        auto imu = std::make_shared<IMUSensor>("IMU");
-        
-        system.addSensor(pressureSensor1);
-        system.addSensor(tempSensor1);
-        system.addSensor(imu);
-
-        // Add actuators
-        auto thruster1 = std::make_shared<ThrusterMotor>("VerticalThruster1");
-        auto thruster2 = std::make_shared<ThrusterMotor>("HorizontalThruster1");
-        auto valve1 = std::make_shared<HydraulicValve>("GripperValve");
-        
-        system.addActuator(thruster1);
-        system.addActuator(thruster2);
-        system.addActuator(valve1);
-
-        // Add communication interfaces
-        auto teensySerial1 = std::make_shared<SerialInterface>("/dev/ttyACM0", 115200);
-        auto teensySerial2 = std::make_shared<SerialInterface>("/dev/ttyACM1", 115200);
-        auto telemetry = std::make_shared<TelemetryUplink>("192.168.1.100", 5000);
-        auto modbus = std::make_shared<ModbusInterface>("192.168.1.50");
-        
-        system.addCommunication(teensySerial1);
-        system.addCommunication(teensySerial2);
-        system.addCommunication(telemetry);
-        system.addCommunication(modbus);
-
-        // Configure safety limits
-        system.addSafetyLimit("MaxDepth", 
-                             [&]() { return pressureSensor1->readValue(); },
-                             0.0, 100.0); // 0-100 PSI
-
-        system.addSafetyLimit("MaxTemp",
-                             [&]() { return tempSensor1->readValue(); },
-                             -5.0, 50.0); // -5 to 50°C
+        // Tool configuration: the ECU table the control logic runs against
+        std::string_view name = argc > 1 ? argv[1] : "digem-pi5";
+        const ToolConfiguration* tool = nullptr;
+        for (const ToolConfiguration& known : TOOL_CONFIGURATIONS) {
+            if (known.topology->name == name) tool = &known;
+        }
+        if (!tool) {
+            std::cerr << "Unknown topology " << name << " (known:";
+            for (const ToolConfiguration& known : TOOL_CONFIGURATIONS) {
+                std::cerr << " " << known.topology->name;
+            }
+            std::cerr << ")\n";
+            return 1;
+        }
+        system.setTopology(*tool->topology);
+
+        // 1 kHz base rate for the thrust/steering hydraulics; slower
+        // components run in rate groups derived from this tick
+        system.setLoopRate(1000.0);
+
+        // Pi 5 cores: control + safety alone on core 3 at the top FIFO
+        // priority, the links on core 2, recorder and downlink on core 1.
+        // Core 0 keeps the kernel, the serial/Modbus/ECU-poll workers and
+        // the log writer. An I/O stall past 50 ms latches the interlock.
+        system.setRealtimeConfig({80, 3, true});
+        system.setPipeline({1000.0, {70, 2, false}, 50000000LL},
+                           {200.0, {0, 1, false}, 1000000000LL});
+
+        tool->configure(system, *tool->topology);
 
         // Initialize and start
         if (!system.initialize()) {
@@ -68,16 +181,38 @@ int main() {
         }
 
         system.printSystemStatus();
-        
+
         std::cout << "Starting ROV control system...\n";
         std::cout << "Press Ctrl+C to stop.\n";
-        
+
         system.start();
 
+        if (g_shutdownSignal) std::cout << "\nShutdown signal received...\n";
+        system.stop();
+        system.writeTimingReport("cycle_timing.json");
+
     } catch (const std::exception& e) {
         std::cerr << "Exception: " << e.what() << std::endl;
         return 1;
     }
 
     return 0;
-}
\ No newline at end of file
+}
+
+// Optional argument: the tool topology (digem-pi5, the default, or pi-claw)
+int main(int argc, char* argv[]) {
+    // Create control system
+    TM_ControlSystem system;
+    g_system = &system;
+
+    // Register signal handler for graceful shutdown
+    signal(SIGINT, signalHandler);
+    signal(SIGTERM, signalHandler);
+
+    int result = run(system, argc, argv);
+
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+    g_system = nullptr;
+    return result;
+}
@@ -8,13 +8,38 @@
 #include <string.h>
 
 #define BNO08X_RESET -1   // no reset pin for I2C
-#define REPORT_INTERVAL_US 20000  // change to 10000 if you want 100 Hz data (lower value means faster data)
 #define QUAT_RAD_TO_DEG (57.2957795f)
 
+// 1 = framed binary quaternion packets for the Pi (include/teensy_protocol.hpp)
+// 0 = human-readable roll/pitch/yaw for the serial monitor
+#define OUTPUT_BINARY 1
+
+#if OUTPUT_BINARY
+#define REPORT_INTERVAL_US 10000  // 100 Hz; binary packets are small enough for full rate
+#else
+#define REPORT_INTERVAL_US 20000  // change to 10000 if you want 100 Hz data (lower value means faster data)
+#endif
+
+// Binary protocol (must match include/teensy_protocol.hpp and include/framing.hpp)
+#define PACKET_IMU_QUATERNION 0x01
+#define PACKET_TIME_PING 0x03
+#define PACKET_TIME_PONG 0x04
+#define IMU_QUATERNION_PACKET_SIZE 14
+#define TIME_PING_PACKET_SIZE 10
+#define TIME_PONG_PACKET_SIZE 18
+
 Adafruit_BNO08x bno08x(BNO08X_RESET);
 sh2_SensorValue_t sensorValue;
+static uint8_t packetSequence = 0;
+
+// Incoming COBS frame from the Pi (TIME_PINGs)
+static uint8_t rxEncoded[64];
+static size_t rxLength = 0;
+static bool rxOverflow = false;
 
 static void printPadded(float val, int width);
+static void sendQuaternionPacket(float real, float i, float j, float k, uint32_t sampleUs);
+static void serviceSerial();
 
 void setup(void) {
   Serial.begin(115200);
@@ -31,7 +56,6 @@ void setup(void) {
       delay(10);
     }
   }
-  Serial.println("BNO08x Found!");
 
   if (!bno08x.enableReport(SH2_GAME_ROTATION_VECTOR, REPORT_INTERVAL_US)) {
     Serial.println("Could not enable rotation vector"); //runs when the sensor is not found
@@ -40,9 +64,12 @@ void setup(void) {
     }
   }
 
+#if !OUTPUT_BINARY
+  Serial.println("BNO08x Found!");
   Serial.println("Reading orientation (Ctrl+C to stop)...");
   Serial.println("      Roll      Pitch        Yaw");
   Serial.println("----------------------------------");
+#endif
 }
 
 void loop(void) {
@@ -50,8 +77,18 @@ void loop(void) {
     bno08x.enableReport(SH2_GAME_ROTATION_VECTOR, REPORT_INTERVAL_US); 
   }
 
+#if OUTPUT_BINARY
+  serviceSerial();
+#endif
+
   if (!bno08x.getSensorEvent(&sensorValue)) {
+#if OUTPUT_BINARY
+    // Keep answering pings while idle so their arrival stamps stay tight
+    uint32_t idleStart = micros();
+    while (micros() - idleStart < 1000) serviceSerial();
+#else
     delay(1);  // avoid busy-loop when sensor has no new data
+#endif
     return;
   }
 
@@ -63,6 +100,13 @@ void loop(void) {
   float j    = sensorValue.un.gameRotationVector.j;
   float k    = sensorValue.un.gameRotationVector.k;
   float real = sensorValue.un.gameRotationVector.real;
+
+#if OUTPUT_BINARY
+  // Euler conversion happens on the Pi; just ship the quaternion. The SH2
+  // timestamp is micros() at the host interrupt less the hub's reported
+  // delay, i.e. when the sensor took the sample.
+  sendQuaternionPacket(real, i, j, k, (uint32_t)sensorValue.timestamp);
+#else
   float roll  = QUAT_RAD_TO_DEG * atan2(2.0f * (real * i + j * k), 1.0f - 2.0f * (i * i + j * j));
   float pitch = QUAT_RAD_TO_DEG * asin(fmaxf(-1.0f, fminf(1.0f, 2.0f * (real * j - k * i))));
   float yaw   = QUAT_RAD_TO_DEG * atan2(2.0f * (real * k + i * j), 1.0f - 2.0f * (j * j + k * k));
@@ -73,6 +117,7 @@ void loop(void) {
   Serial.print(" ");
   printPadded(yaw, 10);
   Serial.print("\r");
+#endif
 }
 
 static void printPadded(float val, int width) {
@@ -82,3 +127,124 @@ static void printPadded(float val, int width) {
   for (int i = len; i < width; i++) Serial.print(" ");
   Serial.print(buf);
 }
+
+// CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF)
+static uint16_t crc16Ccitt(const uint8_t* data, size_t length) {
+  uint16_t crc = 0xFFFF;
+  for (size_t n = 0; n < length; n++) {
+    crc ^= (uint16_t)data[n] << 8;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+// COBS-encode payload+CRC and write it with a 0x00 delimiter in one call
+static void sendFrame(const uint8_t* payload, size_t length) {
+  uint8_t raw[32];
+  uint8_t encoded[40];
+  memcpy(raw, payload, length);
+  uint16_t crc = crc16Ccitt(payload, length);
+  raw[length] = (uint8_t)(crc & 0xFF);
+  raw[length + 1] = (uint8_t)(crc >> 8);
+  length += 2;
+
+  size_t codeIndex = 0;
+  size_t out = 1;
+  uint8_t code = 1;
+  for (size_t n = 0; n < length; n++) {
+    if (raw[n] == 0) {
+      encoded[codeIndex] = code;
+      codeIndex = out++;
+      code = 1;
+    } else {
+      encoded[out++] = raw[n];
+      code++;
+    }
+  }
+  encoded[codeIndex] = code;
+  encoded[out++] = 0x00;
+  Serial.write(encoded, out);
+}
+
+static int16_t toQ14(float value) {
+  float scaled = value * 16384.0f;
+  if (scaled > 32767.0f) scaled = 32767.0f;
+  if (scaled < -32768.0f) scaled = -32768.0f;
+  return (int16_t)lroundf(scaled);
+}
+
+static void putQ14(uint8_t* p, float value) {
+  int16_t q = toQ14(value);
+  p[0] = (uint8_t)(q & 0xFF);
+  p[1] = (uint8_t)((uint16_t)q >> 8);
+}
+
+static void putU32(uint8_t* p, uint32_t value) {
+  for (int n = 0; n < 4; n++) p[n] = (uint8_t)(value >> (8 * n));
+}
+
+static void sendQuaternionPacket(float real, float i, float j, float k, uint32_t sampleUs) {
+  uint8_t packet[IMU_QUATERNION_PACKET_SIZE];
+  packet[0] = PACKET_IMU_QUATERNION;
+  packet[1] = packetSequence++;
+  putQ14(&packet[2], real);
+  putQ14(&packet[4], i);
+  putQ14(&packet[6], j);
+  putQ14(&packet[8], k);
+  putU32(&packet[10], sampleUs);
+  sendFrame(packet, sizeof(packet));
+}
+
+// Answer a TIME_PING at once: the Pi's send time echoed, then micros()
+// when the ping's delimiter arrived and as the pong goes out
+static void handleFrame(const uint8_t* payload, size_t length, uint32_t receivedUs) {
+  if (length != TIME_PING_PACKET_SIZE || payload[0] != PACKET_TIME_PING) return;
+  uint8_t pong[TIME_PONG_PACKET_SIZE];
+  pong[0] = PACKET_TIME_PONG;
+  pong[1] = payload[1];
+  memcpy(&pong[2], &payload[2], 8);
+  putU32(&pong[10], receivedUs);
+  putU32(&pong[14], micros());
+  sendFrame(pong, sizeof(pong));
+}
+
+// COBS-decode and CRC-check one frame; false if it is corrupt
+static bool decodeFrame(const uint8_t* encoded, size_t length, uint8_t* out, size_t* outLength) {
+  size_t in = 0;
+  size_t n = 0;
+  while (in < length) {
+    uint8_t code = encoded[in++];
+    if (code == 0 || in + code - 1 > length) return false;
+    for (uint8_t c = 1; c < code; c++) out[n++] = encoded[in++];
+    if (code < 0xFF && in < length) out[n++] = 0;
+  }
+  if (n < 3) return false;
+  uint16_t crc = (uint16_t)(out[n - 2] | (out[n - 1] << 8));
+  if (crc != crc16Ccitt(out, n - 2)) return false;
+  *outLength = n - 2;
+  return true;
+}
+
+static void serviceSerial() {
+  while (Serial.available() > 0) {
+    uint8_t byte = (uint8_t)Serial.read();
+    if (byte != 0x00) {
+      if (rxLength < sizeof(rxEncoded)) {
+        rxEncoded[rxLength++] = byte;
+      } else {
+        rxOverflow = true;
+      }
+      continue;
+    }
+    uint32_t receivedUs = micros();
+    uint8_t payload[sizeof(rxEncoded)];
+    size_t length = 0;
+    if (!rxOverflow && rxLength > 0 && decodeFrame(rxEncoded, rxLength, payload, &length)) {
+      handleFrame(payload, length, receivedUs);
+    }
+    rxLength = 0;
+    rxOverflow = false;
+  }
+}
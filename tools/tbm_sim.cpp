@@ -0,0 +1,415 @@
+// tbm_sim - Run the control system against plant models or a recording
+//
+// Build: g++ -std=c++20 -O2 -Iinclude tools/tbm_sim.cpp -o tbm_sim -lpthread
+// Usage: tbm_sim scenario [seconds=120] [csv=out.csv] [dir=sim_run]
+//        tbm_sim replay <segment.tlm> [depth=PSI] [heading=DEG] [seconds=all]
+//                                       [csv=out.csv] [dir=sim_replay]
+//
+// scenario: src/main.cpp's digem-pi5 components with simulated devices. Dives
+//   to 10 PSI on heading 90, starts the cutter and slurry pump at 10 s,
+//   opens the gripper at 20 s, then steps to 20 PSI / heading -90 halfway.
+//   Exits non-zero if either step overshoots or has not settled within
+//   tolerance by the end of its half, or a safety limit tripped.
+// replay: feeds a recorded segment's sensor channels back in on its own
+//   timeline and reports how far the recomputed thruster commands are
+//   from the recorded ones (give the setpoints the recording ran with;
+//   seconds= stops before a setpoint change). Other actuators follow
+//   their recorded commands.
+//
+// Both run on a virtual clock as fast as the CPU allows. The system's
+// log, telemetry segments and ECU reports go to dir (a replay must not
+// write into the directory it reads from).
+#include "simulation.hpp"
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+static constexpr double LOOP_RATE_HZ = 1000.0;
+
+// Loop gains as in src/main.cpp
+static const PIDGains DEPTH_GAINS{30.0, 1.0, 2.0, -100.0, 100.0, 200.0, 10.0};
+static const PIDGains HEADING_GAINS{3.0, 0.1, 1.5, -100.0, 100.0, 400.0, 10.0};
+
+static std::map<std::string, std::string> parseOptions(int argc, char** argv, int first) {
+    std::map<std::string, std::string> options;
+    for (int i = first; i < argc; i++) {
+        std::string arg = argv[i];
+        size_t equals = arg.find('=');
+        if (equals != std::string::npos) options[arg.substr(0, equals)] = arg.substr(equals + 1);
+    }
+    return options;
+}
+
+static std::string option(const std::map<std::string, std::string>& options,
+                          const std::string& key, const std::string& fallback) {
+    auto it = options.find(key);
+    return it != options.end() ? it->second : fallback;
+}
+
+// Initialize with the console quiet (the ECU table goes to stdout)
+static bool initializeQuietly(TM_ControlSystem& system) {
+    std::ostringstream quiet;
+    std::streambuf* console = std::cout.rdbuf(quiet.rdbuf());
+    bool ready = system.initialize();
+    std::cout.rdbuf(console);
+    return ready;
+}
+
+static void stopQuietly(TM_ControlSystem& system) {
+    std::ostringstream quiet;
+    std::streambuf* console = std::cout.rdbuf(quiet.rdbuf());
+    system.stop();
+    std::cout.rdbuf(console);
+}
+
+// One loop's response to a setpoint step. Overshoot is the largest error
+// once the value has crossed the setpoint; the settle error is the
+// largest over the last SETTLE_WINDOW_S before the next step.
+struct StepCheck {
+    static constexpr double SETTLE_WINDOW_S = 5.0;
+
+    const char* name;
+    double overshootLimit;
+    double settleTolerance;
+    bool angle;                     // Errors wrap at +-180
+    double setpoint = 0.0;
+    double startSign = 0.0;
+    bool crossed = false;
+    double overshoot = 0.0;
+    double settleError = 0.0;
+
+    double error(double value) const {
+        double e = value - setpoint;
+        return angle ? std::remainder(e, 360.0) : e;
+    }
+
+    void begin(double value, double target) {
+        setpoint = target;
+        startSign = std::copysign(1.0, error(value));
+        crossed = false;
+        overshoot = 0.0;
+        settleError = 0.0;
+    }
+
+    void sample(double value, bool settling) {
+        double e = error(value);
+        if (!crossed && e * startSign <= 0.0) crossed = true;
+        if (crossed) overshoot = std::max(overshoot, std::fabs(e));
+        if (settling) settleError = std::max(settleError, std::fabs(e));
+    }
+
+    bool passed() const { return overshoot <= overshootLimit && settleError <= settleTolerance; }
+
+    // "depth: overshoot 0.31 PSI (limit 1.00), settle error 0.05 (limit 0.25)"
+    std::string describe(const char* units) const {
+        char text[160];
+        std::snprintf(text, sizeof(text),
+                      "%s: overshoot %.2f %s (limit %.2f), settle error %.2f (limit %.2f)%s",
+                      name, overshoot, units, overshootLimit, settleError, settleTolerance,
+                      passed() ? "" : " FAILED");
+        return text;
+    }
+};
+
+// Scenario pass criteria, checked on both steps of each loop
+static constexpr double DEPTH_OVERSHOOT_PSI = 1.0;      // 10% of the 10 PSI steps
+static constexpr double DEPTH_SETTLE_PSI = 0.25;
+static constexpr double HEADING_OVERSHOOT_DEG = 5.0;
+static constexpr double HEADING_SETTLE_DEG = 1.0;
+
+static int runScenario(double seconds, FILE* csv) {
+    TM_ControlSystem system;
+    system.setLoopRate(LOOP_RATE_HZ);
+    system.setStateBusRate(0.0);
+
+    Simulator sim(system, LOOP_RATE_HZ, monotonicNowNs());
+    VirtualClock& clock = sim.getClock();
+    DepthPlant depth;
+    depth.depthM = 1.0;             // Launched below the surface: the MaxDepth
+                                    // limit trips on sensor noise around 0 PSI
+    HeadingPlant heading;
+    CylinderPlant gripper;
+    VFDPlant cutter;
+    VFDPlant pump;
+
+    auto depthSensor = std::make_shared<SimulatedSensor>(
+        "DepthSensor", "PSI", [&depth]() { return depth.pressurePsi(); }, 0.02, 1);
+    auto waterTemp = std::make_shared<SimulatedSensor>(
+        "WaterTemp", "°C", []() { return 12.0; }, 0.05, 2);
+    auto imu = std::make_shared<IMUSensor>("IMU");
+    auto slurryFlow = std::make_shared<SimulatedSensor>(
+        "SlurryFlow", "L/min", [&pump]() { return pump.shaftHz() / 60.0 * 30.0; });
+    auto gripperPosition = std::make_shared<SimulatedSensor>(
+        "GripperPosition", "mm", [&gripper]() { return gripper.positionMm; }, 0.0, 4);
+    system.addSensor(depthSensor, 100.0);
+    system.addSensor(waterTemp, 1.0);
+    system.addSensor(imu, 100.0);
+    system.addSensor(slurryFlow, 100.0);
+    system.addSensor(gripperPosition, 100.0);
+
+    auto vertical = std::make_shared<ThrusterMotor>("VerticalThruster1");
+    auto horizontal = std::make_shared<ThrusterMotor>("HorizontalThruster1");
+    auto valve = std::make_shared<HydraulicValve>("GripperValve");
+    auto cutterVfd = std::make_shared<SimulatedVFD>("CutterHeadVFD", cutter);
+    auto pumpVfd = std::make_shared<SimulatedVFD>("SlurryPumpVFD", pump);
+    system.addActuator(vertical);
+    system.addActuator(horizontal);
+    system.addActuator(valve);
+    system.addActuator(cutterVfd, 5.0);
+    system.addActuator(pumpVfd, 5.0);
+
+    auto sensorNode = std::make_shared<SimulatedSensorNode>("TeensySensors", clock, heading);
+    auto actuatorNode = std::make_shared<SimulatedActuatorNode>("TeensyActuators", clock);
+    system.addCommunication(sensorNode);
+    system.addCommunication(actuatorNode);
+
+    system.addActuatorOutputs(DIGEM_PI5_TOPOLOGY.outputs);
+
+    system.addControlLoop({CONTROL_LOOP_DEPTH, "DepthSensor", -1, "VerticalThruster1",
+                           DEPTH_GAINS, 100.0, false});
+    system.addControlLoop({CONTROL_LOOP_HEADING, "IMU", IMUSensor::YAW, "HorizontalThruster1",
+                           HEADING_GAINS, 100.0, true});
+    system.addSafetyLimit("MaxDepth", depthSensor, 0.0, 100.0);
+    system.addSafetyLimit("MaxTemp", waterTemp, -5.0, 50.0);
+    system.addSafetyLimit("MaxSlurryFlow", slurryFlow, 0.0, 30.0);
+
+    // The plants see what the node drives (frame channels), not the actuator objects
+    sim.addPlant([&](double dt) { depth.step(actuatorNode->channelPercent(3), dt); });
+    sim.addPlant([&](double dt) { heading.step(actuatorNode->channelPercent(5), dt); });
+    sim.addPlant([&](double dt) { gripper.step(actuatorNode->channelPercent(7), dt); });
+    sim.addPlant([&](double dt) { cutter.step(cutterVfd->getCommand(), dt); });
+    sim.addPlant([&](double dt) { pump.step(pumpVfd->getCommand(), dt); });
+
+    if (!initializeQuietly(system)) {
+        std::cerr << "Control system failed to initialize\n";
+        return 1;
+    }
+
+    if (csv) {
+        std::fprintf(csv, "time_s,depth_psi,heading_deg,vertical_cmd,horizontal_cmd,"
+                          "cutter_hz,pump_hz,flow_lpm,gripper_mm\n");
+    }
+    uint64_t safetyFaultCycles = 0;
+    StepCheck depthCheck{"Depth", DEPTH_OVERSHOOT_PSI, DEPTH_SETTLE_PSI, false};
+    StepCheck headingCheck{"Heading", HEADING_OVERSHOOT_DEG, HEADING_SETTLE_DEG, true};
+    double phaseEnd = 0.0;
+    auto sample = [&]() {
+        const SystemSnapshot& snapshot = system.getSnapshot();
+        if (!system.getSafetyMonitor().isSystemSafe()) safetyFaultCycles++;
+        bool settling = sim.getElapsedSeconds() > phaseEnd - StepCheck::SETTLE_WINDOW_S;
+        depthCheck.sample(depth.pressurePsi(), settling);
+        headingCheck.sample(heading.headingDeg, settling);
+        if (csv && sim.getCycleCount() % 10 == 0) {
+            std::fprintf(csv, "%.3f,%.4f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n",
+                         sim.getElapsedSeconds(), depth.pressurePsi(), heading.headingDeg,
+                         snapshot.actuatorCommands[0], snapshot.actuatorCommands[1],
+                         cutter.shaftHz(), pump.shaftHz(), snapshot.sensorValues[3],
+                         gripper.positionMm);
+        }
+    };
+
+    int64_t wallStart = monotonicNowNs();
+    double half = seconds / 2.0;
+    phaseEnd = half;
+    // Engaged where the vehicle is (bumpless), then stepped to the targets
+    system.setAutoDepth(true, depthSensor->readValue());
+    system.setAutoHeading(true, imu->getData().yaw);
+    system.setAutoDepth(true, 10.0);
+    system.setAutoHeading(true, 90.0);
+    depthCheck.begin(depth.pressurePsi(), 10.0);
+    headingCheck.begin(heading.headingDeg, 90.0);
+    sim.runFor(std::min(10.0, half), sample);
+    cutterVfd->setCommand(45.0);
+    pumpVfd->setCommand(40.0);
+    sim.runFor(std::clamp(half - 10.0, 0.0, 10.0), sample);
+    valve->setCommand(60.0);
+    sim.runFor(std::max(half - sim.getElapsedSeconds(), 0.0), sample);
+    double settledDepth = depth.pressurePsi();
+    double settledHeading = heading.headingDeg;
+    StepCheck firstDepth = depthCheck;
+    StepCheck firstHeading = headingCheck;
+
+    phaseEnd = seconds;
+    system.setAutoDepth(true, 20.0);
+    system.setAutoHeading(true, -90.0);
+    depthCheck.begin(depth.pressurePsi(), 20.0);
+    headingCheck.begin(heading.headingDeg, -90.0);
+    while (sim.getElapsedSeconds() < seconds) {
+        sim.step();
+        sample();
+    }
+    double wallSeconds = (monotonicNowNs() - wallStart) / 1e9;
+
+    std::printf("Simulated %.1f s (%llu cycles) in %.2f s wall, %.0fx real time\n",
+                sim.getElapsedSeconds(), static_cast<unsigned long long>(sim.getCycleCount()),
+                wallSeconds, sim.getElapsedSeconds() / wallSeconds);
+    std::printf("Halfway: depth %.2f PSI (setpoint 10), heading %.1f deg (setpoint 90)\n",
+                settledDepth, settledHeading);
+    std::printf("  %s\n  %s\n", firstDepth.describe("PSI").c_str(),
+                firstHeading.describe("deg").c_str());
+    std::printf("End: depth %.2f PSI (setpoint 20), heading %.1f deg (setpoint -90)\n",
+                depth.pressurePsi(), heading.headingDeg);
+    std::printf("  %s\n  %s\n", depthCheck.describe("PSI").c_str(),
+                headingCheck.describe("deg").c_str());
+    std::printf("Cutter %.1f Hz, pump %.1f Hz, gripper %.1f mm, %llu actuator frames, "
+                "%llu cycles with a safety fault\n",
+                cutter.shaftHz(), pump.shaftHz(), gripper.positionMm,
+                static_cast<unsigned long long>(actuatorNode->getFrameCount()),
+                static_cast<unsigned long long>(safetyFaultCycles));
+    if (const NodeClockSync* sync = system.getClockSync(0)) {
+        std::printf("Sensor node clock: %s\n", sync->getStatus().c_str());
+    }
+
+    stopQuietly(system);
+
+    bool passed = firstDepth.passed() && firstHeading.passed() && depthCheck.passed() &&
+                  headingCheck.passed() && safetyFaultCycles == 0;
+    std::printf("Scenario %s\n", passed ? "passed" : "FAILED");
+    return passed ? 0 : 1;
+}
+
+static int runReplay(const std::string& path, double depthSetpoint, double headingSetpoint,
+                     double seconds, FILE* csv) {
+    TelemetryReplay replay;
+    if (!replay.open(path)) {
+        std::cerr << "Failed to open telemetry segment: " << path << "\n";
+        return 1;
+    }
+
+    TM_ControlSystem system;
+    system.setLoopRate(LOOP_RATE_HZ);
+    system.setStateBusRate(0.0);
+
+    // Sensor channels become replay sensors and ".cmd" channels actuators.
+    // The loop outputs are recomputed and compared with the recording;
+    // the other actuators are driven with their recorded commands.
+    struct Compared {
+        std::shared_ptr<IActuator> actuator;
+        int channel;
+        double sumSquares;
+        double maxError;
+        uint64_t samples;
+    };
+    struct Driven {
+        std::shared_ptr<IActuator> actuator;
+        int channel;
+    };
+    std::vector<Compared> compared;
+    std::vector<Driven> driven;
+    const std::string suffix = ".cmd";
+    for (uint32_t channel = 0; channel < replay.getChannelCount(); channel++) {
+        std::string name = replay.getChannelName(channel);
+        if (name.size() > suffix.size() &&
+            name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0) {
+            std::string actuatorName = name.substr(0, name.size() - suffix.size());
+            auto actuator = std::make_shared<ThrusterMotor>(actuatorName);
+            system.addActuator(actuator);
+            if (actuatorName == "VerticalThruster1" || actuatorName == "HorizontalThruster1") {
+                compared.push_back({actuator, static_cast<int>(channel), 0.0, 0.0, 0});
+            } else {
+                driven.push_back({actuator, static_cast<int>(channel)});
+            }
+        } else {
+            auto sensor = std::make_shared<ReplaySensor>(name);
+            system.addSensor(sensor);
+            replay.bind(name, sensor);
+        }
+    }
+
+    // The recorded IMU channel is its scalar value (yaw)
+    system.addControlLoop({CONTROL_LOOP_DEPTH, "DepthSensor", -1, "VerticalThruster1",
+                           DEPTH_GAINS, 100.0, false});
+    system.addControlLoop({CONTROL_LOOP_HEADING, "IMU", -1, "HorizontalThruster1",
+                           HEADING_GAINS, 100.0, true});
+
+    Simulator sim(system, LOOP_RATE_HZ, replay.getStartNs());
+    if (!initializeQuietly(system)) {
+        std::cerr << "Control system failed to initialize\n";
+        return 1;
+    }
+    if (!std::isnan(depthSetpoint)) system.setAutoDepth(true, depthSetpoint);
+    if (!std::isnan(headingSetpoint)) system.setAutoHeading(true, headingSetpoint);
+
+    if (csv) {
+        std::fprintf(csv, "time_s,actuator,recorded,replayed\n");
+    }
+    int64_t wallStart = monotonicNowNs();
+    while (!replay.isFinished() && sim.getElapsedSeconds() < seconds) {
+        // Records up to the start of the next cycle are visible to it
+        replay.advanceTo(sim.getClock().now());
+        for (auto& entry : driven) {
+            double recorded = 0.0;
+            if (replay.getLatest(entry.channel, recorded)) entry.actuator->setCommand(recorded);
+        }
+        sim.step();
+        for (auto& entry : compared) {
+            double recorded = 0.0;
+            if (!replay.getLatest(entry.channel, recorded)) continue;
+            double error = entry.actuator->getCommand() - recorded;
+            entry.sumSquares += error * error;
+            entry.maxError = std::max(entry.maxError, std::fabs(error));
+            entry.samples++;
+            if (csv && sim.getCycleCount() % 10 == 0) {
+                std::fprintf(csv, "%.3f,%s,%.4f,%.4f\n", sim.getElapsedSeconds(),
+                             entry.actuator->getComponentName().c_str(), recorded,
+                             entry.actuator->getCommand());
+            }
+        }
+    }
+    double wallSeconds = (monotonicNowNs() - wallStart) / 1e9;
+
+    std::printf("Replayed %llu records, %.1f s of recording in %.2f s wall (%.0fx)\n",
+                static_cast<unsigned long long>(replay.getRecordCount()),
+                sim.getElapsedSeconds(), wallSeconds, sim.getElapsedSeconds() / wallSeconds);
+    for (const auto& entry : compared) {
+        double rms = entry.samples ? std::sqrt(entry.sumSquares / entry.samples) : 0.0;
+        std::printf("  %-24s rms error %.4f, max %.4f (%llu cycles)\n",
+                    entry.actuator->getComponentName().c_str(), rms, entry.maxError,
+                    static_cast<unsigned long long>(entry.samples));
+    }
+
+    stopQuietly(system);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    std::string mode = argc >= 2 ? argv[1] : "";
+    if (mode != "scenario" && !(mode == "replay" && argc >= 3)) {
+        std::cerr << "Usage: " << argv[0] << " scenario [seconds=120] [csv=out.csv] [dir=sim_run]\n"
+                  << "       " << argv[0] << " replay <segment.tlm> [depth=PSI] [heading=DEG]"
+                  << " [seconds=all] [csv=out.csv] [dir=sim_replay]\n";
+        return 1;
+    }
+
+    namespace fs = std::filesystem;
+    auto options = parseOptions(argc, argv, 2);
+    std::string segment = mode == "replay" ? fs::absolute(argv[2]).string() : "";
+    std::string csvPath = option(options, "csv", "");
+    if (!csvPath.empty()) csvPath = fs::absolute(csvPath).string();
+
+    fs::path runDir = option(options, "dir", mode == "replay" ? "sim_replay" : "sim_run");
+    fs::create_directories(runDir / "ecu_reports");
+    fs::current_path(runDir);
+
+    FILE* csv = nullptr;
+    if (!csvPath.empty()) {
+        csv = std::fopen(csvPath.c_str(), "w");
+        if (!csv) {
+            std::cerr << "Failed to open output file: " << csvPath << "\n";
+            return 1;
+        }
+    }
+
+    int result;
+    if (mode == "scenario") {
+        result = runScenario(std::atof(option(options, "seconds", "120").c_str()), csv);
+    } else {
+        double depth = std::atof(option(options, "depth", "nan").c_str());
+        double heading = std::atof(option(options, "heading", "nan").c_str());
+        double seconds = std::atof(option(options, "seconds", "inf").c_str());
+        result = runReplay(segment, depth, heading, seconds, csv);
+    }
+    if (csv) std::fclose(csv);
+    return result;
+}
@@ -0,0 +1,54 @@
+// telemetry_export - Convert a binary telemetry segment (.tlm) to CSV
+//
+// Build: g++ -std=c++20 -O2 -Iinclude tools/telemetry_export.cpp -o telemetry_export
+// Usage: telemetry_export <segment.tlm> [output.csv]
+//        (writes to stdout when no output file is given)
+#include "telemetry_recorder.hpp"
+#include <iostream>
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <segment.tlm> [output.csv]\n";
+        return 1;
+    }
+
+    TelemetrySegmentReader reader;
+    if (!reader.open(argv[1])) {
+        std::cerr << "Failed to open telemetry segment: " << argv[1] << "\n";
+        return 1;
+    }
+
+    FILE* out = stdout;
+    if (argc >= 3) {
+        out = std::fopen(argv[2], "w");
+        if (!out) {
+            std::cerr << "Failed to open output file: " << argv[2] << "\n";
+            return 1;
+        }
+    }
+
+    // Resolve channel names once
+    const auto& header = reader.header();
+    std::vector<std::string> names;
+    for (uint32_t i = 0; i < header.channelCount; i++) {
+        names.push_back(reader.getChannelName(i));
+    }
+
+    std::fprintf(out, "wall_time_s,monotonic_s,channel,value\n");
+
+    uint64_t count = reader.getRecordCount();
+    for (uint64_t i = 0; i < count; i++) {
+        const TelemetryRecord& rec = reader.getRecord(i);
+        const std::string name = rec.channelId < names.size()
+                                     ? names[rec.channelId]
+                                     : reader.getChannelName(rec.channelId);
+        std::fprintf(out, "%.6f,%.6f,%s,%.17g\n",
+                     reader.toWallTimeNs(rec.timestampNs) / 1e9,
+                     rec.timestampNs / 1e9, name.c_str(), rec.value);
+    }
+
+    if (out != stdout) std::fclose(out);
+    std::cerr << "Exported " << count << " records from segment "
+              << header.segmentIndex << "\n";
+    return 0;
+}